@@ -28,6 +28,7 @@ extern int linux_optind;
 extern int linux_opterr;
 static int doBatchCmd(int argc, char *argv[]);
 static int badminDebug(int nargc, char *nargv[], int opCode);
+static int badminPerfmon(int, char **);
 
 
 int
@@ -142,6 +143,9 @@ doBatchCmd(int argc, char *argv[])
             break;
         case BADMIN_QUIT:
             exit(0);
+        case BADMIN_PERFMON:
+            cmdRet = badminPerfmon(argc, argv);
+            break;
         default :
             fprintf(stderr, I18N_FUNC_S_ERROR, "adminCmdIndex()");
             exit(-1);
@@ -473,3 +477,24 @@ Host name does not need to be specified, set debug to the host which runs MBD\n"
 
 }
 
+/* badminPerfmon()
+ */
+static int
+badminPerfmon(int argc, char **argv)
+{
+    char *snapshot;
+
+    if (argc > optind)
+        return -2;
+
+    snapshot = lsb_perfinfo();
+    if (snapshot == NULL) {
+        lsb_perror("lsb_perfinfo");
+        return -1;
+    }
+
+    fputs(snapshot, stdout);
+    free(snapshot);
+
+    return 0;
+}
@@ -44,7 +44,7 @@ static int opCodeList[] = {  0, 0, QUEUE_OPEN, QUEUE_CLOSED, QUEUE_ACTIVATE,
                              HOST_CLOSE, HOST_REBOOT, HOST_SHUTDOWN, 0,
                              HOST_HIST, MBD_HIST, SYS_HIST, MBD_DEBUG,
                              MBD_TIMING, 0, SBD_DEBUG, SBD_TIMING,
-                             0, 0, 0 };
+                             0, 0, 0, 0 };
 
 static char *cmdList[] = {
 #define BADMIN_RECONFIG  0
@@ -93,6 +93,8 @@ static char *cmdList[] = {
     "?",
 #define BADMIN_QUIT     22
     "quit",
+#define BADMIN_PERFMON  23
+    "perfmon",
     NULL
 };
 
@@ -121,7 +123,7 @@ static char *cmdSyntax[] =
     "[ command ...]",
     "[ command ...]",
     "",
-    "[-t time0,time1] [-f logfile_name]",
+    "",
     NULL
 };
 
@@ -151,6 +153,7 @@ static char *cmdInfo[] = {
     "Get help on commands",             /* catgets 3120 */
     "Get help on commands",             /* catgets 3120 */
     "Quit",                             /* catgets 3121 */
+    "Display the mbatchd performance metrics", /* catgets 3123 */
     NULL
 };
 
@@ -158,6 +161,6 @@ static char *cmdInfo[] = {
 static int cmdInfo_ID[] = {
     3101, 3102, 3103, 3104, 3105, 3106, 3107, 3108, 3109, 3110,
     3111, 3112, 3113, 3114, 3115, 3116, 3117, 3122,
-    3118, 3119, 3120, 3120, 3121
+    3118, 3119, 3120, 3120, 3121, 3123
 };
 #endif
@@ -36,6 +36,7 @@ static int  skip_job(struct jobInfoEnt *);
 static void displayJobs(struct jobInfoEnt *, struct jobInfoHead *,
                         int, int);
 static void displayCustom(struct jobInfoEnt *, struct jobInfoHead *, int);
+static int customNeedsPaths(void);
 
 static LS_LONG_INT *usrJids;
 static int *numJobs;
@@ -148,6 +149,16 @@ main(int argc, char **argv)
         exit(-1);
     }
 
+    /* Ask mbatchd to pack many jobs per message and
+     * to skip what this output format does not show.
+     */
+    options |= JOBINFO_PACK;
+    if (format != LONG_FORMAT && format != LSFUF_FORMAT) {
+        options |= JOBINFO_NO_LOAD;
+        if (format != CUSTOM_FORMAT || !customNeedsPaths())
+            options |= JOBINFO_NO_PATHS;
+    }
+
     TIMEIT(0, (jInfoH = lsb_openjobinfo_a(jobId,
                                           jobName,
                                           user,
@@ -516,6 +527,45 @@ static char
     return p;
 }
 
+/* customNeedsPaths()
+ * Return true if the custom format displays the file
+ * or directory names of the jobs.
+ */
+static int
+customNeedsPaths(void)
+{
+    static char *pathFields[] = {"input_file", "output_file",
+                                 "error_file", "sub_cwd",
+                                 "exec_home", "exec_cwd", NULL};
+    char *buf;
+    char *p;
+    char *s;
+    char *save;
+    int i;
+
+    buf = strdup(cusFormat);
+    if (buf == NULL)
+        return true;
+
+    for (p = strtok_r(buf, " ", &save);
+         p != NULL;
+         p = strtok_r(NULL, " ", &save)) {
+
+        if ((s = strchr(p, ':')) != NULL)
+            *s = '\0';
+
+        for (i = 0; pathFields[i] != NULL; i++) {
+            if (strcasecmp(p, pathFields[i]) == 0) {
+                free(buf);
+                return true;
+            }
+        }
+    }
+
+    free(buf);
+    return false;
+}
+
 static void
 displayCustom(struct jobInfoEnt *job, struct jobInfoHead *jInfoH,
             int options)
@@ -42,6 +42,10 @@ static int emptyCmd = TRUE;
 static int parseScript(FILE *from,  int *embedArgc,
                         char ***embedArgv, int option);
 static int CopyCommand(char **, int);
+static int subPackFile(const char *);
+static int packLine(char *, int *, char ***);
+static int packOwn(struct submit *);
+static void packFree(struct submit *);
 
 static int
 addLabel2RsrcReq(struct submit *subreq);
@@ -77,6 +81,11 @@ do_sub(int argc, char **argv, int option)
     if (logclass & (LC_TRACE | LC_SCHED | LC_EXEC))
         ls_syslog(LOG_DEBUG, "%s: Entering this routine...", __func__);
 
+    if (option == CMD_BSUB
+        && argc == 3
+        && strcmp(argv[1], "-pack") == 0)
+        return subPackFile(argv[2]);
+
     if (fillReq(argc, argv, option, &req) < 0 ){
         fprintf(stderr,  ". %s.\n", "Job not submitted");
         return -1;
@@ -99,6 +108,260 @@ do_sub(int argc, char **argv, int option)
 
 }
 
+/* subPackFile()
+ *
+ * Submit the jobs listed one per line in file using
+ * lsb_submit_batch(), each line is parsed as a bsub
+ * command line without the bsub.
+ */
+static int
+subPackFile(const char *file)
+{
+    FILE *fp;
+    char line[MAXLINELEN];
+    struct submit *req;
+    struct submitReply *reply;
+    LS_LONG_INT *jobId;
+    int *err;
+    int *lineNum;
+    char **jargv;
+    int jargc;
+    int num;
+    int size;
+    int lineno;
+    int i, cc;
+    int failed;
+
+    if ((fp = fopen(file, "r")) == NULL) {
+        perror(file);
+        return -1;
+    }
+
+    /* A line without a command must not
+     * read the job script from stdin.
+     */
+    if (freopen("/dev/null", "r", stdin) == NULL) {
+        perror("/dev/null");
+        fclose(fp);
+        return -1;
+    }
+
+    size = 0;
+    num = 0;
+    req = NULL;
+    lineNum = NULL;
+    lineno = 0;
+    failed = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        char *p;
+
+        ++lineno;
+        if ((p = strchr(line, '\n')) == NULL && !feof(fp)) {
+            fprintf(stderr, "%s: line %d is too long. %s.\n",
+                    file, lineno, "Job not submitted");
+            /* skip the rest of it */
+            while ((cc = fgetc(fp)) != EOF && cc != '\n')
+                ;
+            ++failed;
+            continue;
+        }
+        if (p)
+            *p = 0;
+
+        p = line;
+        SKIPSPACE(p);
+        if (*p == 0 || *p == '#')
+            continue;
+
+        if (num == size) {
+            size = size ? 2 * size : 64;
+            req = realloc(req, size * sizeof(struct submit));
+            lineNum = realloc(lineNum, size * sizeof(int));
+            if (req == NULL || lineNum == NULL) {
+                perror("realloc");
+                fclose(fp);
+                return -1;
+            }
+        }
+
+        if (packLine(p, &jargc, &jargv) < 0) {
+            fclose(fp);
+            return -1;
+        }
+
+        emptyCmd = TRUE;
+        optind = 1;
+        if (fillReq(jargc, jargv, CMD_BSUB, &req[num]) < 0) {
+            fprintf(stderr, ". %s: line %d: %s.\n",
+                    file, lineno, "Job not submitted");
+            ++failed;
+            continue;
+        }
+        if (packOwn(&req[num]) < 0) {
+            fclose(fp);
+            return -1;
+        }
+        lineNum[num] = lineno;
+        ++num;
+    }
+    fclose(fp);
+
+    if (num == 0)
+        return failed ? -1 : 0;
+
+    reply = calloc(num, sizeof(struct submitReply));
+    jobId = calloc(num, sizeof(LS_LONG_INT));
+    err = calloc(num, sizeof(int));
+    if (reply == NULL || jobId == NULL || err == NULL) {
+        perror("calloc");
+        return -1;
+    }
+
+    TIMEIT(0, (cc = lsb_submit_batch(num, req, reply, jobId, err)),
+           "lsb_submit_batch");
+    /* On error every job has its own
+     * error code, report them all.
+     */
+    for (i = 0; i < num; i++) {
+
+        if (jobId[i] < 0) {
+            lsberrno = err[i];
+            fprintf(stderr, "%s: line %d: ", file, lineNum[i]);
+            prtErrMsg(&req[i], &reply[i]);
+            fprintf(stderr, ". %s.\n", "Job not submitted");
+            ++failed;
+        }
+        FREEUP(reply[i].queue);
+        FREEUP(reply[i].badJobName);
+        packFree(&req[i]);
+    }
+
+    free(reply);
+    free(jobId);
+    free(err);
+    free(lineNum);
+    free(req);
+
+    return failed ? -1 : 0;
+}
+
+/* packOwn()
+ *
+ * The library parses -m and -f in static storage
+ * reused by the next line, give the request its
+ * own copy of them.
+ */
+static int
+packOwn(struct submit *req)
+{
+    struct xFile *xf;
+    char **hosts;
+    int i;
+
+    if (req->numAskedHosts > 0) {
+
+        hosts = calloc(req->numAskedHosts, sizeof(char *));
+        if (hosts == NULL) {
+            perror("calloc");
+            return -1;
+        }
+        for (i = 0; i < req->numAskedHosts; i++) {
+            if ((hosts[i] = strdup(req->askedHosts[i])) == NULL) {
+                perror("strdup");
+                while (--i >= 0)
+                    free(hosts[i]);
+                free(hosts);
+                return -1;
+            }
+        }
+        req->askedHosts = hosts;
+    }
+
+    if (req->nxf > 0) {
+
+        xf = calloc(req->nxf, sizeof(struct xFile));
+        if (xf == NULL) {
+            perror("calloc");
+            return -1;
+        }
+        memcpy(xf, req->xf, req->nxf * sizeof(struct xFile));
+        req->xf = xf;
+    }
+
+    return 0;
+}
+
+/* packFree()
+ */
+static void
+packFree(struct submit *req)
+{
+    int i;
+
+    if (req->numAskedHosts > 0) {
+        for (i = 0; i < req->numAskedHosts; i++)
+            free(req->askedHosts[i]);
+        FREEUP(req->askedHosts);
+    }
+
+    if (req->nxf > 0)
+        FREEUP(req->xf);
+}
+
+/* packLine()
+ *
+ * Split a line of a pack file into an argv
+ * that fillReq() can parse, the strings are
+ * kept as the submit request points to them.
+ */
+static int
+packLine(char *line, int *argc, char ***argv)
+{
+    char **v;
+    char *sp;
+    char quoteMark;
+    char *sQuote;
+    char *dQuote;
+    int n;
+    int size;
+
+    size = 16;
+    if ((v = calloc(size, sizeof(char *))) == NULL) {
+        perror("calloc");
+        return -1;
+    }
+    v[0] = "bsub";
+    n = 1;
+
+    while (TRUE) {
+
+        quoteMark = '"';
+        if ((sQuote = strchr(line, '\'')) != NULL)
+            if ((dQuote = strchr(line, '"')) == NULL || sQuote < dQuote)
+                quoteMark = '\'';
+
+        if ((sp = getNextValueQ_(&line, quoteMark, quoteMark)) == NULL)
+            break;
+
+        if (n + 2 > size) {
+            size = 2 * size;
+            if ((v = realloc(v, size * sizeof(char *))) == NULL) {
+                perror("realloc");
+                return -1;
+            }
+        }
+        v[n] = putstr_(sp);
+        ++n;
+    }
+    v[n] = NULL;
+
+    *argc = n;
+    *argv = v;
+
+    return 0;
+}
+
 void
 prtBETime(struct submit req)
 {
@@ -74,6 +74,10 @@ typedef enum {
     BATCH_JGRP_DEL,
     BATCH_JGRP_INFO,
     BATCH_JGRP_MOD,
+    BATCH_JOB_SUB_PACK,
+    BATCH_JOB_WATCH,
+    BATCH_EVENT_STREAM,
+    BATCH_PERF_INFO,
     READY_FOR_OP         = 1023,
     PREPARE_FOR_OP       = 1024
 } mbdReqType;
@@ -147,6 +151,16 @@ struct submitMbdReply {
     char    *badJobName;
 };
 
+/* Max number of jobs in a pack of submissions.
+ */
+#define SUB_PACK_MAX  1024
+
+struct submitPackReply {
+    int     numJobs;
+    int     *errs;
+    struct submitMbdReply *replies;
+};
+
 struct jgrpReq{
     char *groupSpec;
     char *destSpec; /* used only for bgmodify */
@@ -251,6 +265,43 @@ struct jobPeekReply {
     char *pSpoolDir;
 };
 
+/* Jobs whose state changes a client wants
+ * mbatchd to push on its connection.
+ */
+#define MAX_WATCH_JOBS 1024
+
+struct jobWatchReq {
+    int numJobs;
+    LS_LONG_INT *jobIds;
+};
+
+/* Subscription to the event stream, mask
+ * has a bit for every event type wanted
+ * and none set means all of them.
+ */
+struct eventStreamReq {
+    time_t epoch;
+    LS_LONG_INT seq;
+    int mask[2];
+};
+
+struct eventStreamReply {
+    time_t epoch;
+    LS_LONG_INT first;
+    LS_LONG_INT seq;
+};
+
+struct eventStreamRec {
+    LS_LONG_INT seq;
+    char *line;
+};
+
+/* The mbatchd metrics snapshot, see mbd.perf.c
+ */
+struct perfInfoReply {
+    char *snapshot;
+};
+
 struct signalReq {
     int    sigValue;
     LS_LONG_INT jobId;
@@ -344,6 +395,7 @@ extern int handShake_(int ,char, int);
 #define CALL_SERVER_USE_SOCKET    0x2
 #define CALL_SERVER_NO_HANDSHAKE  0x4
 #define CALL_SERVER_ENQUEUE_ONLY  0x8
+#define CALL_SERVER_ASYNC_CONNECT 0x10
 extern int call_server(char *,
                        ushort,
                        char *,
@@ -91,6 +91,9 @@ struct config_param daemonParams[] = {
     {"LIM_ACCEPT_FLOAT_CLIENT", NULL},
     {"MBD_SWITCH_NOFORK", NULL},
     {"MBD_DEDICATED_RESOURCES", NULL},
+    {"MBD_JOBINFO_STORE", NULL},
+    {"SBD_JOBFILE_CACHE", NULL},
+    {"MBD_EVENT_RING", NULL},
     {NULL, NULL}
 };
 
@@ -140,6 +143,31 @@ rcvJobFile(int chfd, struct lenData *jf)
     return 0;
 }
 
+/* jobFileKey()
+ *
+ * The key of a job file in the sbatchd cache: its length
+ * and two 64 bit FNV-1a of the content, one running forward
+ * and one backward with a different basis.
+ */
+void
+jobFileKey(struct lenData *jf, char *key)
+{
+    unsigned long long h1;
+    unsigned long long h2;
+    int i;
+
+    h1 = 14695981039346656037ULL;
+    h2 = 0x6c62272e07bb0142ULL;
+    for (i = 0; i < jf->len; i++) {
+        h1 ^= (unsigned char)jf->data[i];
+        h1 *= 1099511628211ULL;
+        h2 ^= (unsigned char)jf->data[jf->len - 1 - i];
+        h2 *= 1099511628211ULL;
+    }
+
+    sprintf(key, "%d.%016llx%016llx", jf->len, h1, h2);
+}
+
 int
 do_readyOp(XDR *xdrs, int chanfd, struct sockaddr_in *from,
            struct LSFHeader *reqHdr )
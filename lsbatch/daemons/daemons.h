@@ -159,9 +159,23 @@
 #define LIM_ACCEPT_FLOAT_CLIENT 59
 #define MBD_SWITCH_NOFORK       60  /* for dev only */
 #define MBD_DEDICATED_RESOURCES 61
+#define MBD_JOBINFO_STORE       62
+#define SBD_JOBFILE_CACHE       63
+#define MBD_EVENT_RING          64
 
 #define NOT_LOG  INFINIT_INT
 
+/* Job files cached by sbatchd. The sbatchd sets SBD_HDR_JFCACHE
+ * in the header of its registration and of its probe replies,
+ * mbatchd trusts its record of a cached job file for
+ * JFCACHE_TRUST seconds after the last use while sbatchd
+ * keeps the file for JFCACHE_KEEP seconds after the last use.
+ */
+#define SBD_HDR_JFCACHE    0x1
+#define JOBFILE_KEYLEN     48
+#define JFCACHE_TRUST      (12 * 3600)
+#define JFCACHE_KEEP       (2 * JFCACHE_TRUST)
+
 #define JOB_SAVE_OUTPUT   0x10000000
 #define JOB_FORCE_KILL    0x20000000
 
@@ -558,6 +572,7 @@ extern void errorBack(int, int, struct sockaddr_in *);
 extern int init_ServSock(u_short port);
 extern int server_reply(int, char *, int);
 extern int rcvJobFile(int, struct lenData *);
+extern void jobFileKey(struct lenData *, char *);
 extern int do_readyOp (XDR *xdrs, int , struct sockaddr_in *, struct LSFHeader *);
 
 #define FORK_REMOVE_SPOOL_FILE  (0x1)
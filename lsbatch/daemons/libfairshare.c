@@ -177,6 +177,7 @@ fs_elect_job(struct qData *qPtr,
     struct jData *jPtr;
     uint32_t sent;
     struct uData *uPtr;
+    struct dlink *jobs;
     struct dlink *dl;
     hEnt *ent;
     int count;
@@ -231,7 +232,7 @@ dalsi:
     /* Get the uData that is going to dispatch the
      * job. There is only one uData for a user regardless
      * of the number of share accounts so all user jobs
-     * are in uPtr->jobs
+     * are in uPtr->qJobs, a list for each queue.
      */
     ent = h_getEnt_(&uDataList, s->name);
     if (ent == NULL) {
@@ -241,12 +242,20 @@ dalsi:
     }
     uPtr = ent->hData;
 
+    /* The uData can have jobs in multiple
+     * queues so pick the ones we are scheduling in
+     */
+    jobs = NULL;
+    if (uPtr->qJobs
+        && (ent = h_getEnt_(uPtr->qJobs, qPtr->queue)))
+        jobs = ent->hData;
+
     found = false;
     count = 0;
     jref = NULL;
     jPtr = NULL;
-    for (dl = uPtr->jobs->back;
-         dl != uPtr->jobs;
+    for (dl = jobs ? jobs->back : NULL;
+         dl && dl != jobs;
          dl = dl->back) {
         ++count;
 
@@ -254,30 +263,26 @@ dalsi:
         jPtr = jref->job;
 
         assert(jPtr->userId == s->uid);
-        /* The uData can have jobs in multiple
-         * queues so pick the one we are scheduling in
-         */
-        if (jPtr->qPtr == qPtr) {
+        assert(jPtr->qPtr == qPtr);
 
-            if (s->options & SACCT_WANTS_GROUP) {
-                /* The group wants a specific parent group
-                 * so make sure this job is under it.
-                 */
-                if (strcmp(jPtr->shared->jobBill.userGroup,
-                           n->parent->name) != 0)
-                    continue;
+        if (s->options & SACCT_WANTS_GROUP) {
+            /* The group wants a specific parent group
+             * so make sure this job is under it.
+             */
+            if (strcmp(jPtr->shared->jobBill.userGroup,
+                       n->parent->name) != 0)
+                continue;
 
-                if (logclass & LC_FAIR) {
-                    ls_syslog(LOG_INFO, "\
+            if (logclass & LC_FAIR) {
+                ls_syslog(LOG_INFO, "\
 %s: found job %s which wants group %s", __func__, lsb_jobid2str(jPtr->jobId),
-                              n->parent->name);
-                }
+                          n->parent->name);
             }
-
-            dlink_rm_ent(uPtr->jobs, dl);
-            found = true;
-            break;
         }
+
+        dlink_rm_ent(jobs, dl);
+        found = true;
+        break;
     }
 
     if (s->options & SACCT_WANTS_GROUP
@@ -286,16 +291,15 @@ dalsi:
         jref = NULL;
         jPtr = NULL;
 
-        for (dl = uPtr->jobs->back;
-             dl != uPtr->jobs;
+        for (dl = jobs ? jobs->back : NULL;
+             dl && dl != jobs;
              dl = dl->back) {
             ++count;
 
             jref = dl->e;
             jPtr = jref->job;
 
-            if (jPtr->qPtr == qPtr
-                && jPtr->shared->jobBill.userGroup[0] == 0) {
+            if (jPtr->shared->jobBill.userGroup[0] == 0) {
 
                 if (logclass & LC_FAIR) {
                     ls_syslog(LOG_INFO, "\
@@ -303,7 +307,7 @@ dalsi:
                               n->parent->name);
                 }
 
-                dlink_rm_ent(uPtr->jobs, dl);
+                dlink_rm_ent(jobs, dl);
                 found = true;
                 break;
             }
@@ -321,7 +325,7 @@ dalsi:
 %s: user %s is chosen %d in queue %s but has no jobs count %d numpend %d numj %d",
                       __func__, s->name,
                       s->sent + 1, qPtr->queue,
-                      count, uPtr->numPEND, dl->num);
+                      count, uPtr->numPEND, jobs ? jobs->num : 0);
         }
         goto dalsi;
     }
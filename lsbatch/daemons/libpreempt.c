@@ -18,6 +18,30 @@
  */
 #include "preempt.h"
 
+/* A preemptable queue and its running jobs
+ * in the order of jDataList[SJL].
+ */
+struct victim_queue {
+    struct qData *qPtr;
+    link_t *jobs;
+};
+
+/* The victims of a preemptive queue, the
+ * candidates may come from several queues
+ * of the same priority.
+ */
+struct victim_index {
+    struct qData *qPtr;
+    struct victim_queue *vq;
+    int num_vq;
+};
+
+static struct victim_index *
+victims_of(struct victim_index *, int *, struct qData *);
+static struct victim_queue *
+index_victims(struct qData *, int *);
+static void
+free_victims(struct victim_index *, int);
 static struct jData *
 find_first_pend_job(struct qData *);
 static bool_t
@@ -54,6 +78,10 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
     uint32_t numSLOTS;
     uint32_t num_harvest;
     linkiter_t iter;
+    struct victim_index *vi;
+    struct victim_index *v;
+    int num_vi;
+    int i;
 
     if (logclass & LC_PREEMPT) {
         ls_syslog(LOG_INFO, "\
@@ -150,18 +178,19 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
         return 0;
     }
 
+    /* Index the running jobs of the preemptable
+     * queues of each candidate queue once for all
+     * its candidates.
+     */
+    vi = calloc(numPEND, sizeof(struct victim_index));
+    num_vi = 0;
+
     /* Traverse candidate list of jobs in the
      * preemptive queue and search for preemptable jobs.
      */
     while ((jPtr = pop_link(jl))) {
         struct qData *qPtr2;
 
-        /* Initialiaze the iterator on the list
-         * of preemptable queue, the list is
-         * traversed in the order in which it
-         * was configured.
-         */
-        traverse_init(jPtr->qPtr->preemptable, &iter);
         /* Number of slots this job wants
          */
         numSLOTS = jPtr->shared->jobBill.numProcessors;
@@ -169,8 +198,14 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
          */
         num_harvest = 0;
 
-        while ((qPtr2 = traverse_link(&iter))) {
+        v = victims_of(vi, &num_vi, jPtr->qPtr);
 
+        /* The preemptable queues are traversed
+         * in the order in which they were configured.
+         */
+        for (i = 0; i < v->num_vq; i++) {
+
+            qPtr2 = v->vq[i].qPtr;
             if (qPtr2->numRUN == 0)
                 continue;
 
@@ -180,19 +215,13 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
                           __func__, lsb_jobid2str(jPtr->jobId),
                           qPtr2->queue, numSLOTS, qPtr->queue, qPtr2->queue);
 
-            /* Search on SJL jobs belonging to the
+            /* Search the SJL jobs belonging to the
              * preemptable queue and harvest slots.
-             * later we want to eventually break out
-             * of this loop somehow.
              */
-            for (jPtr2 = jDataList[SJL]->forw;
-                 jPtr2 != jDataList[SJL];
-                 jPtr2 = jPtr2->forw) {
+            traverse_init(v->vq[i].jobs, &iter);
+            while ((jPtr2 = traverse_link(&iter))) {
                 int cc;
 
-                if (jPtr2->qPtr != qPtr2)
-                    continue;
-
                 if (IS_SUSP(jPtr2->jStatus))
                     continue;
 
@@ -234,6 +263,7 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
                 if (num_harvest >= numSLOTS) {
 
                     fin_link(jl);
+                    free_victims(vi, num_vi);
                     if (logclass & LC_PREEMPT) {
                         ls_syslog(LOG_INFO, "\
 %s: job %s did harvest enough slots wanted %d got %d", __func__,
@@ -248,7 +278,7 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
 
             } /* for running jobs in preemptable queue */
 
-        } /* while (preemptable queues) */
+        } /* for (preemptable queues) */
 
         /* We did not find the number of necessary slots
          * so undo the operation.
@@ -273,11 +303,103 @@ prm_elect_preempt(struct qData *qPtr, link_t *rl, int numjobs)
 
     } /* while jobs on preemptive list */
 
+    fin_link(jl);
+    free_victims(vi, num_vi);
+
     assert(LINK_NUM_ENTRIES(rl) == 0);
 
     return LINK_NUM_ENTRIES(rl);
 }
 
+/* victims_of()
+ *
+ * The victims of the candidates of qPtr,
+ * indexed the first time they are needed.
+ */
+static struct victim_index *
+victims_of(struct victim_index *vi, int *num, struct qData *qPtr)
+{
+    int i;
+
+    for (i = 0; i < *num; i++) {
+        if (vi[i].qPtr == qPtr)
+            return &vi[i];
+    }
+
+    vi[i].qPtr = qPtr;
+    vi[i].vq = index_victims(qPtr, &vi[i].num_vq);
+    ++(*num);
+
+    return &vi[i];
+}
+
+/* index_victims()
+ *
+ * Bucket the running jobs of the queues preemptable
+ * by qPtr in one pass on jDataList[SJL] instead of
+ * scanning the whole list for each queue and each
+ * preempting job.
+ */
+static struct victim_queue *
+index_victims(struct qData *qPtr, int *num)
+{
+    struct victim_queue *vq;
+    struct jData *jPtr;
+    struct qData *qPtr2;
+    linkiter_t iter;
+    int n;
+    int i;
+
+    n = 0;
+    if (qPtr->preemptable)
+        n = LINK_NUM_ENTRIES(qPtr->preemptable);
+    vq = calloc(n + 1, sizeof(struct victim_queue));
+
+    i = 0;
+    traverse_init(qPtr->preemptable, &iter);
+    while ((qPtr2 = traverse_link(&iter))
+           && i < n) {
+        vq[i].qPtr = qPtr2;
+        vq[i].jobs = make_link();
+        ++i;
+    }
+    n = i;
+
+    /* Walk backward and push so that each
+     * bucket is in the order of the list.
+     */
+    for (jPtr = jDataList[SJL]->back;
+         jPtr != jDataList[SJL];
+         jPtr = jPtr->back) {
+
+        for (i = 0; i < n; i++) {
+            if (vq[i].qPtr == jPtr->qPtr) {
+                push_link(vq[i].jobs, jPtr);
+                break;
+            }
+        }
+    }
+
+    *num = n;
+    return vq;
+}
+
+/* free_victims()
+ */
+static void
+free_victims(struct victim_index *vi, int num)
+{
+    int i;
+    int j;
+
+    for (i = 0; i < num; i++) {
+        for (j = 0; j < vi[i].num_vq; j++)
+            fin_link(vi[i].vq[j].jobs);
+        free(vi[i].vq);
+    }
+    free(vi);
+}
+
 /* find_first_pend_job()
  */
 static struct jData *
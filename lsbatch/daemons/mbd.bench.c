@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "mbd.h"
+
+/* Scheduler benchmark.
+ *
+ * mbatchd -b <sessions> [-L <loadfile>] reads the configuration
+ * and replays the lsb.events like a starting mbatchd, then runs
+ * the given number of scheduling sessions without serving any
+ * client and exits. The jobs are not sent to sbatchd, a job the
+ * scheduler dispatches is started on the spot. Every decision
+ * and session is printed on stdout followed by the metrics of
+ * mbd.perf.c, so two runs on the same input can be compared.
+ *
+ * The started jobs are logged in the lsb.events so the benchmark
+ * must run on a copy of the LSB_SHAREDIR, given by the lsf.conf
+ * of -d env_dir, and on a host running LIM as master.
+ *
+ * With a load file the host loads come from it instead of LIM,
+ * each line is a host name followed by the values of the load
+ * indices in the lsinfo order, - is an unknown value and the
+ * lines starting with # are ignored.
+ */
+
+/* Calls of scheduleAndDispatchJobs()
+ * in a session before giving up.
+ */
+#define BENCH_MAX_CALLS 1000
+
+int benchSessions;
+char *benchLoadFile;
+
+static struct hostLoad *benchLoads;
+static int numBenchLoads;
+static int benchSession;
+static int benchDispatched;
+
+static int benchReadLoad(void);
+
+/* benchRun()
+ */
+void
+benchRun(void)
+{
+    struct timeval t0;
+    struct timeval t1;
+    char *snapshot;
+    long usec;
+    int calls;
+    int cc;
+    int i;
+
+    for (i = 0; i < benchSessions; i++) {
+
+        benchSession = i + 1;
+        benchDispatched = 0;
+
+        gettimeofday(&t0, NULL);
+        for (calls = 1; calls <= BENCH_MAX_CALLS; calls++) {
+
+            now = time(NULL);
+            gettimeofday(&t1, NULL);
+            cc = scheduleAndDispatchJobs();
+            perfPhase(PERF_SESSION, &t1);
+            if (cc == 0)
+                break;
+        }
+        gettimeofday(&t1, NULL);
+
+        usec = (t1.tv_sec - t0.tv_sec) * 1000000
+            + (t1.tv_usec - t0.tv_usec);
+        printf("session %d calls %d usec %ld dispatched %d\n",
+               benchSession, calls, usec, benchDispatched);
+    }
+
+    snapshot = perfSnapshot();
+    if (snapshot) {
+        fputs(snapshot, stdout);
+        free(snapshot);
+    }
+
+    fflush(stdout);
+    exit(0);
+}
+
+/* benchStartJob()
+ * Start the job in place of sbatchd.
+ */
+sbdReplyType
+benchStartJob(struct jData *jp, struct jobReply *jobReply)
+{
+    int i;
+
+    memset(jobReply, 0, sizeof(struct jobReply));
+    jobReply->jobId = jp->jobId;
+    jobReply->jStatus = JOB_STAT_RUN;
+
+    printf("dispatch %d %s", benchSession, lsb_jobid2str(jp->jobId));
+    for (i = 0; i < jp->numHostPtr; i++)
+        printf(" %s", jp->hPtr[i]->host);
+    printf("\n");
+
+    ++benchDispatched;
+
+    return ERR_NO_ERROR;
+}
+
+/* benchHostLoad()
+ * Set the host loads from the load file.
+ */
+int
+benchHostLoad(void)
+{
+    struct hData *hPtr;
+    int i;
+
+    if (benchLoads == NULL
+        && benchReadLoad() < 0)
+        return -1;
+
+    for (i = 0; i < numBenchLoads; i++) {
+
+        if ((hPtr = getHostData(benchLoads[i].hostName)) == NULL) {
+            ls_syslog(LOG_ERR, "\
+%s: host %s of %s unknown to MBD", __func__,
+                      benchLoads[i].hostName, benchLoadFile);
+            continue;
+        }
+
+        hostLoadUpdate(hPtr, &benchLoads[i]);
+    }
+
+    return 0;
+}
+
+/* benchReadLoad()
+ */
+static int
+benchReadLoad(void)
+{
+    char line[MAXLINELEN];
+    struct hostLoad *hl;
+    char *p;
+    char *word;
+    FILE *fp;
+    int size;
+    int j;
+
+    fp = fopen(benchLoadFile, "r");
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "\
+%s: fopen(%s) failed %m", __func__, benchLoadFile);
+        return -1;
+    }
+
+    size = 0;
+    while (fgets(line, sizeof(line), fp)) {
+
+        p = line;
+        if ((word = getNextWord_(&p)) == NULL
+            || word[0] == '#')
+            continue;
+
+        if (numBenchLoads == size) {
+            size = 2 * size + 16;
+            hl = realloc(benchLoads, size * sizeof(struct hostLoad));
+            if (hl == NULL) {
+                ls_syslog(LOG_ERR, "%s: realloc() failed %m", __func__);
+                fclose(fp);
+                return -1;
+            }
+            benchLoads = hl;
+        }
+
+        hl = &benchLoads[numBenchLoads];
+        strncpy(hl->hostName, word, MAXHOSTNAMELEN - 1);
+        hl->hostName[MAXHOSTNAMELEN - 1] = 0;
+        hl->status = my_calloc(1 + GET_INTNUM(allLsInfo->numIndx),
+                               sizeof(int), __func__);
+        hl->li = my_calloc(allLsInfo->numIndx, sizeof(float), __func__);
+
+        for (j = 0; j < allLsInfo->numIndx; j++) {
+            word = getNextWord_(&p);
+            if (word == NULL
+                || strcmp(word, "-") == 0)
+                hl->li[j] = INFINIT_LOAD;
+            else
+                hl->li[j] = atof(word);
+        }
+
+        ++numBenchLoads;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
@@ -41,6 +41,14 @@ static sbdReplyType  callSBD(char *,
                              int *);
 
 extern sbdReplyType start_ajob (struct jData *jDataPtr, struct qData *qp, struct jobReply *jobReply);
+static int jfCacheSend(struct hData *, struct jData *, struct lenData *,
+                       char *);
+static int jobFileKeyAppend(char *, const char *);
+
+/* Job files cached by sbatchd on a host are not
+ * remembered past this number.
+ */
+#define JFCACHE_MAX_ENTS 10000
 
 struct sbdNode sbdNodeList = {&sbdNodeList, &sbdNodeList, 0, NULL, NULL, 0};
 
@@ -75,6 +83,9 @@ start_ajob (struct jData *jDataPtr,
     struct sbdNode     sbdNode;
     int                socket;
     struct lsfAuth     *auth = NULL;
+    char               jfKey[2 * JOBFILE_KEYLEN];
+    int                (*sndFunc)();
+    int                len;
 
     if (logclass & (LC_SCHED | LC_EXEC))
         ls_syslog(LOG_DEBUG2, "%s: job=%s", fname, lsb_jobid2str(jDataPtr->jobId));
@@ -131,6 +142,7 @@ start_ajob (struct jData *jDataPtr,
     for (i = 0; i < jobSpecs.numEnv; i++)
         buflen += strlen(jobSpecs.env[i]);
     buflen = (buflen * 4) / 4;
+    buflen += NET_INTSIZE_ + JOBFILE_KEYLEN;
 
     request_buf = (char *) my_malloc (buflen, fname);
     xdrmem_create(&xdrs, request_buf, buflen, XDR_ENCODE);
@@ -143,13 +155,24 @@ start_ajob (struct jData *jDataPtr,
         free(jf.data);
         return ERR_FAIL;
     }
+    len = XDR_GETPOS(&xdrs);
 
     sbdNode.jData = jDataPtr;
     sbdNode.hData = hostData;
     sbdNode.reqCode = MBD_NEW_JOB;
 
-    reply = callSBD(toHost, request_buf, XDR_GETPOS(&xdrs), &reply_buf, &hdr,
-                    sndJobFile_, (int *) &jf, hostData, lastHost, fname,
+    /* The key follows the request in place of the
+     * job file, without the user that sbatchd knows
+     * from the job specs.
+     */
+    sndFunc = sndJobFile_;
+    if (jfCacheSend(hostData, jDataPtr, &jf, jfKey)) {
+        len += jobFileKeyAppend(request_buf + len, strchr(jfKey, '.') + 1);
+        sndFunc = NULL;
+    }
+
+    reply = callSBD(toHost, request_buf, len, &reply_buf, &hdr,
+                    sndFunc, (int *)&jf, hostData, lastHost, fname,
                     &errcnt, &cc,
                     CALL_SERVER_NO_WAIT_REPLY | CALL_SERVER_NO_HANDSHAKE,
                     &sbdNode, &socket);
@@ -162,6 +185,21 @@ start_ajob (struct jData *jDataPtr,
     if (reply == ERR_NULL || reply == ERR_FAIL || reply == ERR_UNREACH_SBD)
         return (reply);
 
+    if (hostData->jfCache
+        && jfKey[0] != 0) {
+        time_t *t;
+        hEnt *ent;
+
+        if (HTAB_NUM_ELEMENTS(hostData->jfCache) >= JFCACHE_MAX_ENTS)
+            sbdJobFileCache(hostData, SBD_HDR_JFCACHE, TRUE);
+
+        ent = h_addEnt_(hostData->jfCache, jfKey, NULL);
+        if (ent->hData == NULL)
+            ent->hData = my_malloc(sizeof(time_t), __func__);
+        t = ent->hData;
+        *t = now;
+    }
+
 
 
     if (reply == ERR_NO_ERROR) {
@@ -184,6 +222,88 @@ start_ajob (struct jData *jDataPtr,
 
 }
 
+/* jfCacheSend()
+ *
+ * Compute the key of the job file if the host caches
+ * job files and return TRUE if the key can be sent
+ * in place of the file.
+ */
+static int
+jfCacheSend(struct hData *hPtr, struct jData *jPtr,
+            struct lenData *jf, char *jfKey)
+{
+    char key[JOBFILE_KEYLEN];
+    time_t *t;
+    hEnt *ent;
+
+    jfKey[0] = 0;
+    if (hPtr->jfCache == NULL)
+        return FALSE;
+
+    jobFileKey(jf, key);
+    sprintf(jfKey, "%d.%s", jPtr->userId, key);
+
+    ent = h_getEnt_(hPtr->jfCache, jfKey);
+    if (ent == NULL)
+        return FALSE;
+
+    t = ent->hData;
+    if (now - *t > JFCACHE_TRUST)
+        return FALSE;
+
+    if (logclass & LC_EXEC)
+        ls_syslog(LOG_DEBUG, "\
+%s: job %s file %s cached on host %s", __func__,
+                  lsb_jobid2str(jPtr->jobId), jfKey, hPtr->host);
+
+    return TRUE;
+}
+
+/* jobFileKeyAppend()
+ *
+ * Write the key where the job file would go, the
+ * negative length tells sbatchd that a key follows.
+ */
+static int
+jobFileKeyAppend(char *buf, const char *key)
+{
+    int len = strlen(key);
+    int nlen = htonl(-len);
+
+    memcpy(buf, NET_INTADDR_(&nlen), NET_INTSIZE_);
+    memcpy(buf + NET_INTSIZE_, key, len);
+
+    return NET_INTSIZE_ + len;
+}
+
+/* sbdJobFileCache()
+ *
+ * Record whether the sbatchd of the host caches the job
+ * files, reset forgets the files sent so far.
+ */
+void
+sbdJobFileCache(struct hData *hPtr, int hdrFlags, int reset)
+{
+    if (! (hdrFlags & SBD_HDR_JFCACHE)) {
+        if (hPtr->jfCache) {
+            h_freeTab_(hPtr->jfCache, NULL);
+            FREEUP(hPtr->jfCache);
+        }
+        return;
+    }
+
+    if (hPtr->jfCache == NULL) {
+        hPtr->jfCache = my_calloc(1, sizeof(hTab), __func__);
+        h_initTab_(hPtr->jfCache, 101);
+        return;
+    }
+
+    if (reset) {
+        h_freeTab_(hPtr->jfCache, NULL);
+        h_initTab_(hPtr->jfCache, 101);
+    }
+}
+
 sbdReplyType
 switch_job (struct jData *jDataPtr, int options)
 {
@@ -691,6 +811,16 @@ callSBD(char *toHost,
         && strcmp(caller, "msg_job") != 0)
         callServerFlags |= CALL_SERVER_ENQUEUE_ONLY;
 
+    /* Requests whose reply is handled by the main loop do
+     * not wait for the connection either, a host slow to
+     * accept fails later in expireSbdConnects() or with an
+     * exception on the channel.
+     */
+    if ((callServerFlags & CALL_SERVER_ENQUEUE_ONLY)
+        && (callServerFlags & CALL_SERVER_NO_WAIT_REPLY)
+        && sockPtr != NULL)
+        callServerFlags |= CALL_SERVER_ASYNC_CONNECT;
+
     *cc = call_server(toHost,
                       sbd_port,
                       request_buf,
@@ -31,6 +31,28 @@ static void    	       	       getSpecifiedHostGroup(char **, int,
 						     int *);
 static void    	       	       copyHostGroup(struct gData *, int,
 					     struct groupInfoEnt *);
+static void                    closureBuild(struct gData *);
+static void                    closureFill(struct gData *, struct gData *);
+static struct gData *          grpIndexGet(hTab *, int *,
+                                           struct gData **, int, char *);
+
+/* Group closures.
+ *
+ * gMember() runs for every job in the scheduling loop, limit
+ * and fairshare code. The first time a group is tested after
+ * the groups changed its members and the members of all its
+ * subgroups, at any depth, are flattened in one table so a
+ * test is a single lookup. A group in the closure having no
+ * member means all, as for gDirectMember(). The configured
+ * groups are also indexed by name. mbd.init.c calls
+ * groupsChanged() whenever it edits a group, this drops the
+ * closures and the indexes which are rebuilt on demand.
+ */
+static int grpGen = 1;
+static hTab uGrpIndex;
+static int uGrpIndexGen;
+static hTab hGrpIndex;
+static int hGrpIndexGen;
 
 LS_BITSET_T                    *uGrpAllSet;
 
@@ -396,22 +418,86 @@ gDirectMember(char *word, struct gData *gp)
 char
 gMember(char *word, struct gData *gp)
 {
-    int i;
-
     INC_CNT(PROF_CNT_gMember);
 
     if (word == NULL || gp == NULL)
         return FALSE;
 
-    if (gDirectMember(word, gp))
+    if (gp->closure == NULL
+        || gp->closureGen != grpGen)
+        closureBuild(gp);
+
+    if (gp->closureAll)
+        return TRUE;
+
+    if (h_getEnt_(gp->closure, word))
         return TRUE;
 
-    for (i = 0; i < gp->numGroups; i++) {
-        if (gMember(word, gp->gPtr[i]))
-            return TRUE;
-    }
     return FALSE;
+}
+
+/* groupsChanged()
+ */
+void
+groupsChanged(void)
+{
+    ++grpGen;
+}
+
+/* closureFree()
+ */
+void
+closureFree(struct gData *gp)
+{
+    if (gp->closure == NULL)
+        return;
+
+    h_freeTab_(gp->closure, NULL);
+    FREEUP(gp->closure);
+}
+
+/* closureBuild()
+ */
+static void
+closureBuild(struct gData *gp)
+{
+    if (gp->closure)
+        h_freeTab_(gp->closure, NULL);
+    else
+        gp->closure = my_malloc(sizeof(hTab), __func__);
+
+    h_initTab_(gp->closure, gp->memberTab.numEnts);
+    gp->closureAll = FALSE;
+    gp->closureGen = grpGen;
 
+    closureFill(gp, gp);
+}
+
+/* closureFill()
+ */
+static void
+closureFill(struct gData *gp, struct gData *sub)
+{
+    sTab sTab;
+    hEnt *ent;
+    int i;
+
+    if (sub->numGroups == 0
+        && sub->memberTab.numEnts == 0) {
+        gp->closureAll = TRUE;
+        return;
+    }
+
+    for (ent = h_firstEnt_(&sub->memberTab, &sTab);
+         ent;
+         ent = h_nextEnt_(&sTab))
+        h_addEnt_(gp->closure, ent->keyname, NULL);
+
+    for (i = 0; i < sub->numGroups; i++) {
+        if (gp->closureAll)
+            return;
+        closureFill(gp, sub->gPtr[i]);
+    }
 }
 
 
@@ -436,13 +522,53 @@ countEntries(struct gData *gp, char first)
 struct gData *
 getUGrpData(char *gname)
 {
-    return (getGrpData (usergroups, gname, numofugroups));
+    return grpIndexGet(&uGrpIndex, &uGrpIndexGen,
+                       usergroups, numofugroups, gname);
 }
 
 struct gData *
 getHGrpData(char *gname)
 {
-    return (getGrpData (hostgroups, gname, numofhgroups));
+    return grpIndexGet(&hGrpIndex, &hGrpIndexGen,
+                       hostgroups, numofhgroups, gname);
+}
+
+/* grpIndexGet()
+ * Look up a configured group in its name index, the
+ * first of the groups having the name wins as with
+ * getGrpData().
+ */
+static struct gData *
+grpIndexGet(hTab *index, int *gen,
+            struct gData *groups[], int num, char *name)
+{
+    hEnt *ent;
+    int new;
+    int i;
+
+    if (name == NULL)
+        return NULL;
+
+    if (*gen != grpGen) {
+
+        if (index->slotPtr)
+            h_freeRefTab_(index);
+        h_initTab_(index, num);
+
+        for (i = 0; i < num; i++) {
+            if (groups[i] == NULL)
+                continue;
+            ent = h_addEnt_(index, groups[i]->group, &new);
+            if (new)
+                ent->hData = groups[i];
+        }
+        *gen = grpGen;
+    }
+
+    if ((ent = h_getEnt_(index, name)) == NULL)
+        return NULL;
+
+    return ent->hData;
 }
 
 struct gData *
@@ -48,6 +48,10 @@
 #define DEF_PEND_EXIT       512
 #define DEF_JOB_ARRAY_SIZE  1000
 #define DEF_LONG_JOB_TIME  1800
+/* Size of the messages carrying several jobs
+ * sent to the job information clients.
+ */
+#define JOBINFO_PACK_SIZE  (256 * 1024)
 /* Default decay of the accumulated ran time of share accounts.
  */
 #define DEF_HIST_MINUTES 120;
@@ -229,6 +233,24 @@ struct askedHost {
     int    priority;
 };
 
+/* Pending reasons of a queue or a user by host id, the
+ * entry of host 0 is the reason for all the hosts. Only
+ * the hosts with a reason take room and the entries
+ * of older generations are free so clearing is O(1).
+ */
+struct hReasonEnt {
+    int          hostId;
+    int          reason;
+    unsigned int gen;
+};
+
+struct hReasons {
+    unsigned int gen;
+    int          size;
+    int          num;
+    struct hReasonEnt *ents;
+};
+
 #define CLEAR_REASON(v, reason) if (v == reason) v = 0;
 #define SET_REASON(condition, v, reason) \
         if (condition) v = reason; else CLEAR_REASON(v, reason)
@@ -449,13 +471,13 @@ struct uData {
     int    numUSUSP;
     int    numJobs;
     int    numRESERVE;
-    int    **reasonTb;
+    struct hReasons **reasonTb;
     int    numSlots;
     LS_BITSET_T *children;
     LS_BITSET_T *descendants;
     LS_BITSET_T *parents;
     LS_BITSET_T *ancestors;
-    struct dlink *jobs;
+    hTab   *qJobs;     /* pending job references by queue */
 };
 
 #define USER_GROUP_IS_ALL_USERS(UserGroup) \
@@ -532,7 +554,7 @@ struct qData {
     int       numSSUSP;
     int       numUSUSP;
     int       numRESERVE;
-    int       **reasonTb;
+    struct hReasons **reasonTb;
     int       numReasons;
     int       numSlots;
     int       numUsable;
@@ -624,6 +646,7 @@ struct hData {
     char      message[MAXLINELEN];
     int       affinity;
     hTab *dres_tab; /* host dedicated resources */
+    hTab *jfCache;  /* job files cached by sbatchd */
 };
 
 
@@ -649,6 +672,9 @@ struct gData {
     struct gData *gPtr[MAX_GROUPS];
     char *group_slots;
     int max_slots;
+    hTab *closure;
+    int  closureAll;
+    int  closureGen;
 };
 
 /* resource account for limits */
@@ -789,6 +815,10 @@ struct clientNode {
     char *fromHost;
     mbdReqType reqType;
     time_t lastTime;
+    int numWatch;
+    LS_LONG_INT *watchJobs;
+    LS_LONG_INT streamSeq;
+    int streamMask[2];
 };
 
 struct condData {
@@ -822,6 +852,18 @@ struct profileCounters {
     char *cntDescr;
 };
 
+/* Scheduler phases timed by perfPhase()
+ */
+typedef enum {
+    PERF_SESSION,
+    PERF_LOAD,
+    PERF_CANDIDATES,
+    PERF_DISPATCH,
+    PERF_LOG,
+    PERF_FLUSH,
+    PERF_NUM_PHASES
+} perfPhase_t;
+
 #undef MBD_PROF_COUNTER
 #define MBD_PROF_COUNTER(Func) PROF_CNT_ ## Func,
 
@@ -1175,6 +1217,13 @@ extern int                  freeReservePreemptResources(struct jData *jp);
 extern int                  deallocReservePreemptResources(struct jData *jp);
 extern int                  orderByStatus (struct candHost *, int , bool_t);
 extern void                 setLsbPtilePack(const bool_t );
+extern void                 free_udata_jref(struct uData *);
+extern int                  do_submitPackReq(XDR *, int,
+                                             struct sockaddr_in *, char *,
+                                             struct LSFHeader *,
+                                             struct sockaddr_in *,
+                                             struct lsfAuth *, int *, int,
+                                             struct jData **);
 extern int                  do_submitReq(XDR *, int, struct sockaddr_in *,
                                          char *, struct LSFHeader *,
                                          struct sockaddr_in *,
@@ -1287,6 +1336,8 @@ extern char                 gMember(char *word,
                                     struct gData *);
 extern char                 gDirectMember(char *,
                                           struct gData *);
+extern void                 groupsChanged(void);
+extern void                 closureFree(struct gData *);
 extern int                  countEntries(struct gData *, char );
 extern struct gData *       getUGrpData(char *);
 extern struct gData *       getHGrpData(char *);
@@ -1322,7 +1373,15 @@ extern void                 updLimitJobData(struct jData *, int, int,
                                         int, int, int, int);
 extern struct resData *     getLimitUsageData(limitConsumerType_t, char *, char *);
 extern struct limitRes     *getActiveLimit(struct limitRes *, int);
+extern void                 compileResLimits(void);
 extern struct uData *       getUserData(char *user);
+extern struct hReasons **   allocHReasons(void);
+extern void                 freeHReasons(struct hReasons **);
+extern int                  getHReason(struct hReasons *, int);
+extern void                 setHReason(struct hReasons *, int, int);
+extern void                 clearHReasons(struct hReasons *);
+extern void                 copyHReasons(struct hReasons *,
+                                         struct hReasons *);
 extern struct userAcct *    getUAcct(struct hTab *, struct uData *);
 extern struct hostAcct *    getHAcct(struct hTab  *, struct hData *);
 extern struct uData *       addUserData (char *, int, float, char *, int, int);
@@ -1396,6 +1455,35 @@ extern void                 log_signaljob(struct jData *, struct signalReq *,
 extern char                 *readJobInfoFile(struct jData *, int *);
 extern void                 writeJobInfoFile(struct jData * , char *, int);
 extern int                  replaceJobInfoFile(char *, char *, char *, int);
+extern int                  jstoreInit(void);
+extern int                  jstorePut(const char *, const char *, int);
+extern char                 *jstoreGet(const char *, int *);
+extern int                  jstoreRemove(const char *);
+extern void                 jstoreCompact(void);
+extern int                  do_jobWatch(XDR *, struct clientNode *,
+                                        struct LSFHeader *);
+extern void                 jobWatchClear(struct clientNode *);
+extern void                 jobWatchLog(struct eventRec *);
+extern void                 eventStreamInit(void);
+extern void                 eventStreamPut(struct eventRec *);
+extern int                  do_eventStream(XDR *, struct clientNode *,
+                                           struct LSFHeader *);
+extern void                 eventStreamClear(struct clientNode *);
+extern void                 eventStreamFlush(void);
+extern void                 perfInit(void);
+extern void                 perfPhase(perfPhase_t, struct timeval *);
+extern void                 perfRequest(int, struct timeval *);
+extern char                 *perfSnapshot(void);
+extern int                  benchSessions;
+extern char                 *benchLoadFile;
+extern void                 benchRun(void);
+extern sbdReplyType         benchStartJob(struct jData *, struct jobReply *);
+extern int                  benchHostLoad(void);
+extern void                 hostLoadUpdate(struct hData *, struct hostLoad *);
+extern int                  do_perfInfo(XDR *, int, struct sockaddr_in *,
+                                        struct LSFHeader *);
+extern void                 beginEventGroup(void);
+extern int                  endEventGroup(void);
 extern void                 log_executejob (struct jData *);
 extern void                 log_jobsigact (struct jData *, struct statusReq *,
                                            int);
@@ -1416,6 +1504,7 @@ extern sbdReplyType         switch_job(struct jData *, int);
 extern sbdReplyType         msg_job(struct jData *, struct Buffer *,
                                     struct jobReply *);
 extern sbdReplyType         probe_slave(struct hData *, char);
+extern void                 sbdJobFileCache(struct hData *, int, int);
 extern sbdReplyType         rebootSbd(char *);
 extern sbdReplyType         shutdownSbd(char *);
 extern struct dptNode       *parseDepCond(char *, struct lsfAuth * ,
@@ -966,6 +966,65 @@ getLsbHostInfo(void)
         queueHostsPF(qp, &i);
 }
 
+/* hostLoadUpdate()
+ * Set the load of a host and its busy status.
+ */
+void
+hostLoadUpdate(struct hData *hPtr, struct hostLoad *hl)
+{
+    int j;
+
+    if (!LS_ISUNAVAIL(hl->status))
+        hPtr->hStatus &= ~HOST_STAT_NO_LIM;
+
+    for (j = 0; j < allLsInfo->numIndx; j++) {
+        hPtr->lsfLoad[j] = hl->li[j];
+        hPtr->lsbLoad[j] = hl->li[j];
+    }
+
+    for (j = 0; j < GET_INTNUM (allLsInfo->numIndx); j++) {
+        hPtr->busyStop[j] = 0;
+        hPtr->busySched[j] = 0;
+    }
+
+    for (j = 0; j < 1 + GET_INTNUM(allLsInfo->numIndx); j++)
+        hPtr->limStatus[j] = hl->status[j];
+
+    hPtr->hStatus &= ~HOST_STAT_BUSY;
+    hPtr->hStatus &= ~HOST_STAT_LOCKED;
+    hPtr->hStatus &= ~HOST_STAT_LOCKED_MASTER;
+
+    for (j = 0; j < allLsInfo->numIndx; j++) {
+
+        if (hPtr->lsbLoad[j] >= INFINIT_LOAD
+            || hPtr->lsbLoad[j] <= -INFINIT_LOAD)
+            continue;
+
+        if (allLsInfo->resTable[j].orderType == INCR) {
+            if (hPtr->lsfLoad[j] >= hPtr->loadStop[j]) {
+                hPtr->hStatus |= HOST_STAT_BUSY;
+                SET_BIT(j, hPtr->busyStop);
+            }
+            if (hPtr->lsbLoad[j] >= hPtr->loadSched[j]){
+                hPtr->hStatus |= HOST_STAT_BUSY;
+                SET_BIT(j, hPtr->busySched);
+            }
+        } else {
+            if (hPtr->lsfLoad[j] <= hPtr->loadStop[j]) {
+                hPtr->hStatus |= HOST_STAT_BUSY;
+                SET_BIT (j, hPtr->busyStop);
+            }
+            if (hPtr->lsbLoad[j]<= hPtr->loadSched[j]){
+                hPtr->hStatus |= HOST_STAT_BUSY;
+                SET_BIT(j, hPtr->busySched);
+            }
+        }
+    }
+
+    hPtr->flags |= HOST_UPDATE_LOAD;
+    hPtr->flags |= HOST_UPDATE;
+}
+
 /* getLsbHostLoad()
  *
  * Get the load of all hosts used by the batch system
@@ -977,13 +1036,15 @@ getLsbHostLoad(void)
     struct hostLoad *hosts;
     int i;
     int num;
-    int j;
     int gone;
     char update;
     struct hData *hPtr;
 
     ls_syslog(LOG_DEBUG, "%s: Entering this routine...", __func__);
 
+    if (benchLoadFile)
+        return benchHostLoad();
+
     /* Reset the HOST_UPDATE flag to detect migrant
      * hosts that left the cluster. Only if allow
      * migrants and the hostlist is already built.
@@ -1047,55 +1108,7 @@ getLsbHostLoad(void)
             continue;
         }
 
-        if (!LS_ISUNAVAIL(hosts[i].status))
-            hPtr->hStatus &= ~HOST_STAT_NO_LIM;
-
-        for (j = 0; j < allLsInfo->numIndx; j++) {
-            hPtr->lsfLoad[j] = hosts[i].li[j];
-            hPtr->lsbLoad[j] = hosts[i].li[j];
-        }
-
-        for (j = 0; j < GET_INTNUM (allLsInfo->numIndx); j++) {
-            hPtr->busyStop[j] = 0;
-            hPtr->busySched[j] = 0;
-        }
-
-        for (j = 0; j < 1 + GET_INTNUM(allLsInfo->numIndx); j++)
-            hPtr->limStatus[j] = hosts[i].status[j];
-
-        hPtr->hStatus &= ~HOST_STAT_BUSY;
-        hPtr->hStatus &= ~HOST_STAT_LOCKED;
-        hPtr->hStatus &= ~HOST_STAT_LOCKED_MASTER;
-
-        for (j = 0; j < allLsInfo->numIndx; j++) {
-
-            if (hPtr->lsbLoad[j] >= INFINIT_LOAD
-                || hPtr->lsbLoad[j] <= -INFINIT_LOAD)
-                continue;
-
-            if (allLsInfo->resTable[j].orderType == INCR) {
-                if (hPtr->lsfLoad[j] >= hPtr->loadStop[j]) {
-                    hPtr->hStatus |= HOST_STAT_BUSY;
-                    SET_BIT(j, hPtr->busyStop);
-                }
-                if (hPtr->lsbLoad[j] >= hPtr->loadSched[j]){
-                    hPtr->hStatus |= HOST_STAT_BUSY;
-                    SET_BIT(j, hPtr->busySched);
-                }
-            } else {
-                if (hPtr->lsfLoad[j] <= hPtr->loadStop[j]) {
-                    hPtr->hStatus |= HOST_STAT_BUSY;
-                    SET_BIT (j, hPtr->busyStop);
-                }
-                if (hPtr->lsbLoad[j]<= hPtr->loadSched[j]){
-                    hPtr->hStatus |= HOST_STAT_BUSY;
-                    SET_BIT(j, hPtr->busySched);
-                }
-            }
-        }
-
-        hPtr->flags |= HOST_UPDATE_LOAD;
-        hPtr->flags |= HOST_UPDATE;
+        hostLoadUpdate(hPtr, &hosts[i]);
 
     } /* for ( i = 0; i < num; i++) */
 
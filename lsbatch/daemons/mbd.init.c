@@ -305,6 +305,7 @@ minit(int mbdInitFlags)
 
     updUserList(mbdInitFlags);
     updQueueList();
+    compileResLimits();
 
     if (chanInit_() < 0) {
         ls_syslog(LOG_ERR, "\
@@ -321,7 +322,8 @@ minit(int mbdInitFlags)
             lsb_CheckError = FATAL_ERR;
     }
 
-    if (getenv("RECONFIG_CHECK") == NULL) {
+    if (getenv("RECONFIG_CHECK") == NULL
+        && benchSessions == 0) {
         batchSock = init_ServSock(mbd_port);
         if (batchSock < 0) {
             ls_syslog(LOG_ERR, "\
@@ -1022,6 +1024,7 @@ addGroup(struct gData **groups, char *gname, int *ngroups)
     h_initTab_(&groups[*ngroups]->memberTab, 0);
     groups[*ngroups]->numGroups = 0;
     (*ngroups)++;
+    groupsChanged();
 
     return (groups[*ngroups - 1]);
 
@@ -1126,6 +1129,7 @@ addMember(struct gData *groupPtr,
         ent = h_addEnt_(&groupPtr->memberTab, name, NULL);
         ent->hData = strdup(name);
     }
+    groupsChanged();
 
     return;
 
@@ -1301,11 +1305,8 @@ freeQData(struct qData *qp, int delete)
         offList((struct listEntry *)qp);
         numofqueues--;
     }
-    if (qp->reasonTb) {
-        FREEUP(qp->reasonTb[0]);
-        FREEUP(qp->reasonTb[1]);
-        FREEUP(qp->reasonTb);
-    }
+    freeHReasons(qp->reasonTb);
+    qp->reasonTb = NULL;
 
     if (qp->hostInQueue) {
         setDestroy(qp->hostInQueue);
@@ -1326,7 +1327,7 @@ parseGroups (int groupType, struct gData **group, char *line, char *filename)
     struct passwd *pw;
     struct hostent *hp;
 
-    mygp = my_malloc(sizeof (struct gData), fname);
+    mygp = my_calloc(1, sizeof (struct gData), fname);
     *group = mygp;
     mygp->group = "";
     h_initTab_(&mygp->memberTab, 16);
@@ -1429,6 +1430,7 @@ parseGroups (int groupType, struct gData **group, char *line, char *filename)
         }
     }
     FREEUP (grpSl);
+    groupsChanged();
 
     return;
 }
@@ -1585,12 +1587,8 @@ initQData (void)
     qPtr->askedPtr = NULL;
     qPtr->numAskedPtr = 0;
     qPtr->askedOthPrio = -1;
-    FREEUP(qPtr->reasonTb);
-    qPtr->reasonTb = my_calloc(2, sizeof(int *), __func__);
-    qPtr->reasonTb[0] = my_calloc(numofhosts() + 1,
-                                  sizeof(int), __func__);
-    qPtr->reasonTb[1] = my_calloc(numofhosts() + 1,
-                                  sizeof(int), __func__);
+    freeHReasons(qPtr->reasonTb);
+    qPtr->reasonTb = allocHReasons();
     qPtr->schedStage = 0;
     qPtr->chkpntPeriod = -1;
     qPtr->chkpntDir = NULL;
@@ -1661,8 +1659,8 @@ lostFoundQueue(void)
     qPtr->pJobLimit = 0.0;
     qPtr->acceptIntvl = DEF_ACCEPT_INTVL;
     qPtr->qStatus = (!QUEUE_STAT_OPEN | !QUEUE_STAT_ACTIVE);
-    qPtr->uGPtr = (struct gData *) my_malloc
-        (sizeof (struct gData), "lostFoundQueue");
+    qPtr->uGPtr = (struct gData *) my_calloc
+        (1, sizeof (struct gData), "lostFoundQueue");
     qPtr->uGPtr->group = "";
     h_initTab_(&qPtr->uGPtr->memberTab, 16);
     qPtr->uGPtr->numGroups = 0;
@@ -2384,27 +2382,13 @@ addQData(struct queueConf *queueConf, int mbdInitFlags )
             copyQData (qPtr, oldQPtr);
             oldQPtr->flags |= QUEUE_UPDATE;
             FREEUP(qPtr->queue);
-            FREEUP(qPtr->reasonTb[0]);
-            FREEUP(qPtr->reasonTb[1]);
-            FREEUP(qPtr->reasonTb);
+            freeHReasons(qPtr->reasonTb);
             FREEUP(qPtr);
 
             if (mbdInitFlags == RECONFIG_CONF
                 || mbdInitFlags == WINDOW_CONF) {
-
-                FREEUP(oldQPtr->reasonTb[0]);
-                FREEUP(oldQPtr->reasonTb[1]);
-                oldQPtr->reasonTb[0] = my_calloc(numLIMhosts + 2,
-                                                 sizeof(int),
-                                                 __func__);
-                oldQPtr->reasonTb[1] = my_calloc(numLIMhosts + 2,
-                                                 sizeof(int),
-                                                 __func__);
-
-                for(j = 0; j < numLIMhosts+2; j++) {
-                    oldQPtr->reasonTb[0][j] = 0;
-                    oldQPtr->reasonTb[1][j] = 0;
-                }
+                clearHReasons(oldQPtr->reasonTb[0]);
+                clearHReasons(oldQPtr->reasonTb[1]);
             }
         }
 
@@ -2827,6 +2811,7 @@ copyGroups(int copyHGroups)
         }
         numofugroups = nTempUGroups;
         nTempUGroups = 0;
+        groupsChanged();
         return;
     }
     for (i = 0; i < numofhgroups; i++) {
@@ -2839,6 +2824,7 @@ copyGroups(int copyHGroups)
         hostgroups[i] = tempHGData[i];
     numofhgroups = nTempHGroups;
     nTempHGroups = 0;
+    groupsChanged();
 
 } /* copyGroups */
 
@@ -3247,28 +3233,20 @@ updHostList(void)
     hReasonTb[0] = my_calloc(numofhosts() + 1, sizeof(int), __func__);
     hReasonTb[1] = my_calloc(numofhosts() + 1, sizeof(int), __func__);
 
-    /* Resize the other reason tables...
+    /* The other reason tables are sparse, just
+     * forget what they hold about the old hosts.
      */
     for (qPtr = qDataList->forw; qPtr != qDataList; qPtr = qPtr->forw) {
-
-        FREEUP(qPtr->reasonTb);
-        qPtr->reasonTb = my_calloc(2, sizeof(int *), __func__);
-        qPtr->reasonTb[0] = my_calloc(numofhosts() + 1,
-                                      sizeof(int), __func__);
-        qPtr->reasonTb[1] = my_calloc(numofhosts() + 1,
-                                      sizeof(int), __func__);
+        clearHReasons(qPtr->reasonTb[0]);
+        clearHReasons(qPtr->reasonTb[1]);
     }
 
     e = h_firstEnt_(&uDataList, &stab);
     while (e) {
 
         uPtr = e->hData;
-        FREEUP(uPtr->reasonTb);
-        uPtr->reasonTb = my_calloc(2, sizeof(int *), __func__);
-        uPtr->reasonTb[0] = my_calloc(numofhosts() + 1,
-                                      sizeof(int), __func__);
-        uPtr->reasonTb[1] = my_calloc(numofhosts() + 1,
-                                      sizeof(int), __func__);
+        clearHReasons(uPtr->reasonTb[0]);
+        clearHReasons(uPtr->reasonTb[1]);
         e = h_nextEnt_(&stab);
     }
 
@@ -3353,18 +3331,8 @@ updUserList(int mbdInitFlags)
 
         if (mbdInitFlags == RECONFIG_CONF
             || mbdInitFlags == WINDOW_CONF) {
-            int j;
-            FREEUP( uData->reasonTb[0]);
-            FREEUP( uData->reasonTb[1]);
-            uData->reasonTb[0] = my_calloc(numLIMhosts + 2,
-                                           sizeof(int), __func__);
-            uData->reasonTb[1] = my_calloc(numLIMhosts + 2,
-                                           sizeof(int), __func__);
-
-            for(j = 0; j < numLIMhosts+2; j++) {
-                uData->reasonTb[0][j] = 0;
-                uData->reasonTb[1][j] = 0;
-            }
+            clearHReasons(uData->reasonTb[0]);
+            clearHReasons(uData->reasonTb[1]);
         }
 
         if (uData->flags & USER_UPDATE) {
@@ -3403,9 +3371,8 @@ updUserList(int mbdInitFlags)
 
                 FREEUP (uData->user);
 
-                FREEUP(uData->reasonTb[0]);
-                FREEUP(uData->reasonTb[1]);
-                FREEUP(uData->reasonTb);
+                freeHReasons(uData->reasonTb);
+                uData->reasonTb = NULL;
                 setDestroy(uData->ancestors);
                 uData->ancestors = NULL;
                 setDestroy(uData->parents);
@@ -3417,6 +3384,7 @@ updUserList(int mbdInitFlags)
 
                 if (uData->hAcct)
                     h_delTab_(uData->hAcct);
+                free_udata_jref(uData);
                 h_delEnt_(&uDataList, ent);
             }
         }
@@ -3603,6 +3571,8 @@ freeGrp(struct gData *grpPtr)
         return;
 
     h_delTab_(&grpPtr->memberTab);
+    closureFree(grpPtr);
+    groupsChanged();
     if (grpPtr->group && grpPtr->group[0] != '\0')
         FREEUP(grpPtr->group);
     FREEUP(grpPtr->group_slots);
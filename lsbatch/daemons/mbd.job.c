@@ -168,8 +168,21 @@ newJob(struct submitReq *subReq, struct submitMbdReply *Reply, int chan,
     if (logclass & (LC_TRACE | LC_EXEC))
         ls_syslog(LOG_DEBUG1, "%s: Entering this routine...", __func__);
 
-    if ((nextId = getNextJobId()) < 0)
+    /* Get the job file from the library first, in a pack of
+     * submissions the next job follows it on the connection
+     * whatever happens to this one.
+     */
+    if ((mbdRcvJobFile(chan, &jf)) == -1) {
+        ls_syslog(LOG_ERR, "\
+%s: failed receiving job file for userid %d: %M",
+                  __func__, auth->uid);
+        return LSBE_MBATCHD;
+    }
+
+    if ((nextId = getNextJobId()) < 0) {
+        FREEUP(jf.data);
         return LSBE_NO_JOBID;
+    }
 
     hData = getHostData(subReq->fromHost);
     if (hData == NULL
@@ -186,6 +199,7 @@ newJob(struct submitReq *subReq, struct submitMbdReply *Reply, int chan,
             if (!(subReq->options & SUB_RESTART)) {
                 ls_syslog(LOG_ERR, "\
 %s: Host <%s> is not used by LSF", __func__, subReq->fromHost);
+                FREEUP(jf.data);
                 return LSBE_BAD_SUBMISSION_HOST;
             }
             if (getHostByType (subReq->schedHostType) == NULL) {
@@ -193,6 +207,7 @@ newJob(struct submitReq *subReq, struct submitMbdReply *Reply, int chan,
 %s: Can not find restarted job's submission host %s and type %s",
                           __func__, subReq->fromHost,
                           subReq->schedHostType);
+                FREEUP(jf.data);
                 return LSBE_BAD_SUBMISSION_HOST;
             }
             strcpy(hostType, subReq->schedHostType);
@@ -249,20 +264,6 @@ newJob(struct submitReq *subReq, struct submitMbdReply *Reply, int chan,
         }
     }
 
-    /* Get the job file from the library before we
-     * close the connection with it
-     */
-    if ((mbdRcvJobFile(chan, &jf)) == -1) {
-        ls_syslog(LOG_ERR, "\
-%s: failed receiving job file for userid %d: %M",
-                  __func__, auth->uid);
-        freeNewJob (newjob);
-        if (returnErr != LSBE_NO_ERROR)
-            return returnErr;
-        else
-            return LSBE_MBATCHD;
-    }
-
     if (returnErr != LSBE_NO_ERROR) {
         freeNewJob (newjob);
         FREEUP (jf.data);
@@ -2574,6 +2575,13 @@ statusJob(struct statusReq *statusReq, struct hostent *hp, int *schedule)
             || statusReq->reason == PEND_JOB_NO_FILE)) {
         jpbw->newReason = statusReq->reason;
 
+        /* The job file may have been sent by key and
+         * not found, send the files again.
+         */
+        if (statusReq->reason == PEND_JOB_NO_FILE
+            && hData->jfCache)
+            sbdJobFileCache(hData, SBD_HDR_JFCACHE, TRUE);
+
         if (IS_START(jpbw->jStatus)) {
 
             if (jpbw->hPtr == NULL)
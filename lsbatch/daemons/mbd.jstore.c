@@ -0,0 +1,588 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "mbd.h"
+
+/* Job script store.
+ *
+ * With MBD_JOBINFO_STORE=y in lsf.conf the job files, which are
+ * otherwise written one per job in logdir/info, are appended to
+ * the single file logdir/info/jobinfo.store and identical job
+ * files are stored only once. The store is a sequence of records:
+ *
+ *   D <hash> <len>\n<len bytes>\n    a job file body
+ *   J <jobFile> <hash>\n             jobFile has the body <hash>
+ *   R <jobFile>\n                    jobFile has been removed
+ *
+ * The offset of every body and the body of every job file are
+ * kept in core and rebuilt by replaying the store at startup.
+ * Bodies no longer used by any job are dead space until
+ * jstoreCompact() rewrites the store with the live records only.
+ *
+ * Lookups fall back to the per job files, so jobs submitted
+ * before the store was turned on, or after it was turned off,
+ * keep working.
+ */
+
+#define JSTORE_NAME         "jobinfo.store"
+#define JSTORE_COMPACT_MIN  (4 * 1024 * 1024)
+#define JSTORE_HASHLEN      16
+
+/* Length of the J record of a job file.
+ */
+#define JREC_LEN(f)  (strlen(f) + JSTORE_HASHLEN + 4)
+
+struct jsBody {
+    char    hash[JSTORE_HASHLEN + 1];
+    off_t   off;      /* offset of the body data */
+    off_t   noff;     /* offset in the compacted store */
+    int     len;
+    int     rlen;     /* length of the whole D record */
+    int     refs;
+};
+
+static hTab     bodyTab;
+static hTab     fileTab;
+static int      storeFd = -1;
+static int      storeOn;
+static off_t    storeSize;
+static off_t    deadSize;
+static char     storeFn[MAXFILENAMELEN];
+
+static void             jsHash(const char *, int, char *);
+static struct jsBody    *jsAddBody(const char *, off_t, int, int);
+static void             jsLink(const char *, struct jsBody *);
+static int              jsUnlink(const char *);
+static int              jsReplay(void);
+static char             *jsRead(struct jsBody *);
+static int              jsAppend(char *, int);
+
+/* jstoreInit()
+ */
+int
+jstoreInit(void)
+{
+    char *p;
+    int flags;
+
+    if (storeFd >= 0)
+        return 0;
+
+    p = daemonParams[MBD_JOBINFO_STORE].paramValue;
+    if (p && (*p == 'y' || *p == 'Y'))
+        storeOn = TRUE;
+
+    sprintf(storeFn, "%s/logdir/info/%s",
+            daemonParams[LSB_SHAREDIR].paramValue, JSTORE_NAME);
+
+    /* Even if the store is off open an existing one
+     * as it may still have the job files of some jobs.
+     */
+    flags = O_RDWR | O_APPEND;
+    if (storeOn)
+        flags |= O_CREAT;
+
+    storeFd = open(storeFn, flags, 0600);
+    if (storeFd < 0) {
+        if (storeOn || errno != ENOENT) {
+            ls_syslog(LOG_ERR, "%s: open() %s failed: %m",
+                      __func__, storeFn);
+            mbdDie(MASTER_FATAL);
+        }
+        return 0;
+    }
+    fcntl(storeFd, F_SETFD, FD_CLOEXEC);
+
+    h_initTab_(&bodyTab, 1024);
+    h_initTab_(&fileTab, 1024);
+
+    if (jsReplay() < 0)
+        mbdDie(MASTER_FATAL);
+
+    ls_syslog(LOG_INFO, "\
+%s: %s has %d job files %d bodies %ld bytes %ld dead", __func__, storeFn,
+              fileTab.numEnts, bodyTab.numEnts,
+              (long)storeSize, (long)deadSize);
+
+    return 0;
+}
+
+/* jstorePut()
+ *
+ * Store the job file of jobFile. Return -1 if the job file
+ * must be written as a regular file instead.
+ */
+int
+jstorePut(const char *jobFile, const char *data, int len)
+{
+    char hash[JSTORE_HASHLEN + 1];
+    struct jsBody *body;
+    hEnt *ent;
+    char *buf;
+    char *rec;
+    int cc;
+    int n;
+
+    if (! storeOn
+        || storeFd < 0
+        || strlen(jobFile) >= MAXFILENAMELEN
+        || strpbrk(jobFile, " \t\n") != NULL)
+        return -1;
+
+    jsHash(data, len, hash);
+
+    body = NULL;
+    ent = h_getEnt_(&bodyTab, hash);
+    if (ent) {
+        body = ent->hData;
+        buf = jsRead(body);
+        if (buf == NULL)
+            return -1;
+        cc = (body->len == len && memcmp(buf, data, len) == 0);
+        FREEUP(buf);
+        if (! cc) {
+            ls_syslog(LOG_WARNING, "\
+%s: hash collision on %s for job file %s", __func__, hash, jobFile);
+            return -1;
+        }
+    }
+
+    rec = my_malloc(len + 2 * MAXFILENAMELEN, __func__);
+    n = 0;
+    if (body == NULL) {
+        n = sprintf(rec, "D %s %d\n", hash, len);
+        memcpy(rec + n, data, len);
+        n += len;
+        rec[n++] = '\n';
+        body = jsAddBody(hash, storeSize + (n - len - 1), len, n);
+    }
+    n += sprintf(rec + n, "J %s %s\n", jobFile, hash);
+
+    if (jsAppend(rec, n) < 0) {
+        FREEUP(rec);
+        mbdDie(MASTER_FATAL);
+    }
+    FREEUP(rec);
+
+    jsLink(jobFile, body);
+
+    return 0;
+}
+
+/* jstoreGet()
+ *
+ * Return the job file of jobFile, NULL if it is not
+ * in the store.
+ */
+char *
+jstoreGet(const char *jobFile, int *len)
+{
+    struct jsBody *body;
+    hEnt *ent;
+    char *buf;
+
+    if (storeFd < 0)
+        return NULL;
+
+    ent = h_getEnt_(&fileTab, jobFile);
+    if (ent == NULL)
+        return NULL;
+
+    body = ent->hData;
+    buf = jsRead(body);
+    if (buf == NULL)
+        return NULL;
+
+    *len = body->len;
+    return buf;
+}
+
+/* jstoreRemove()
+ *
+ * Remove jobFile from the store, return -1 if
+ * it is not there.
+ */
+int
+jstoreRemove(const char *jobFile)
+{
+    char rec[MAXFILENAMELEN + 8];
+    int n;
+
+    if (storeFd < 0
+        || h_getEnt_(&fileTab, jobFile) == NULL)
+        return -1;
+
+    n = sprintf(rec, "R %s\n", jobFile);
+    if (jsAppend(rec, n) < 0)
+        mbdDie(MASTER_FATAL);
+
+    jsUnlink(jobFile);
+    deadSize += n;
+
+    return 0;
+}
+
+/* jstoreCompact()
+ *
+ * Rewrite the store keeping only the live records once at
+ * least half of it is dead. mbatchd is the only writer so
+ * the store is rewritten from the periodic check rather
+ * than by a child which would race with the appends.
+ */
+void
+jstoreCompact(void)
+{
+    char tmpFn[MAXFILENAMELEN + 8];
+    struct jsBody *body;
+    hEnt *ent;
+    hEnt **dead;
+    sTab st;
+    FILE *fp;
+    off_t off;
+    char *buf;
+    int fd;
+    int n;
+
+    if (storeFd < 0
+        || deadSize < JSTORE_COMPACT_MIN
+        || deadSize < storeSize / 2)
+        return;
+
+    sprintf(tmpFn, "%s.tmp", storeFn);
+    fd = open(tmpFn, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    if (fd < 0) {
+        ls_syslog(LOG_ERR, "%s: open() %s failed: %m", __func__, tmpFn);
+        return;
+    }
+    fp = fdopen(fd, "w");
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "%s: fdopen() %s failed: %m", __func__, tmpFn);
+        close(fd);
+        unlink(tmpFn);
+        return;
+    }
+
+    off = 0;
+    for (ent = h_firstEnt_(&bodyTab, &st);
+         ent != NULL;
+         ent = h_nextEnt_(&st)) {
+
+        body = ent->hData;
+        if (body->refs == 0)
+            continue;
+
+        if ((buf = jsRead(body)) == NULL)
+            goto error;
+
+        n = fprintf(fp, "D %s %d\n", body->hash, body->len);
+        if (n < 0
+            || fwrite(buf, 1, body->len, fp) != body->len
+            || fputc('\n', fp) == EOF) {
+            FREEUP(buf);
+            goto error;
+        }
+        FREEUP(buf);
+        body->noff = off + n;
+        off += n + body->len + 1;
+    }
+
+    for (ent = h_firstEnt_(&fileTab, &st);
+         ent != NULL;
+         ent = h_nextEnt_(&st)) {
+
+        body = ent->hData;
+        n = fprintf(fp, "J %s %s\n", ent->keyname, body->hash);
+        if (n < 0)
+            goto error;
+        off += n;
+    }
+
+    if (fflush(fp) == EOF
+        || fsync(fileno(fp)) < 0)
+        goto error;
+
+    if (rename(tmpFn, storeFn) < 0) {
+        ls_syslog(LOG_ERR, "%s: rename() %s %s failed: %m",
+                  __func__, tmpFn, storeFn);
+        fclose(fp);
+        unlink(tmpFn);
+        return;
+    }
+    fclose(fp);
+
+    fd = open(storeFn, O_RDWR | O_APPEND);
+    if (fd < 0) {
+        ls_syslog(LOG_ERR, "%s: open() %s failed: %m", __func__, storeFn);
+        mbdDie(MASTER_FATAL);
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    close(storeFd);
+    storeFd = fd;
+
+    /* Now the new offsets are valid, drop the dead bodies.
+     */
+    for (ent = h_firstEnt_(&bodyTab, &st);
+         ent != NULL;
+         ent = h_nextEnt_(&st)) {
+        body = ent->hData;
+        body->off = body->noff;
+    }
+    dead = my_calloc(bodyTab.numEnts + 1, sizeof(hEnt *), __func__);
+    n = 0;
+    for (ent = h_firstEnt_(&bodyTab, &st);
+         ent != NULL;
+         ent = h_nextEnt_(&st)) {
+        body = ent->hData;
+        if (body->refs == 0)
+            dead[n++] = ent;
+    }
+    while (--n >= 0)
+        h_delEnt_(&bodyTab, dead[n]);
+    FREEUP(dead);
+
+    ls_syslog(LOG_INFO, "\
+%s: %s compacted from %ld to %ld bytes", __func__, storeFn,
+              (long)storeSize, (long)off);
+
+    storeSize = off;
+    deadSize = 0;
+    return;
+
+error:
+    ls_syslog(LOG_ERR, "%s: writing %s failed: %m", __func__, tmpFn);
+    fclose(fp);
+    unlink(tmpFn);
+}
+
+/* jsHash()
+ *
+ * 64 bit FNV-1a of the job file, a match is
+ * always confirmed by comparing the bodies.
+ */
+static void
+jsHash(const char *buf, int len, char *hash)
+{
+    unsigned long long h;
+    int i;
+
+    h = 14695981039346656037ULL;
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)buf[i];
+        h *= 1099511628211ULL;
+    }
+
+    sprintf(hash, "%016llx", h);
+}
+
+/* jsAddBody()
+ *
+ * A body is dead space until a job file links to it.
+ */
+static struct jsBody *
+jsAddBody(const char *hash, off_t off, int len, int rlen)
+{
+    struct jsBody *body;
+    hEnt *ent;
+    int new;
+
+    ent = h_addEnt_(&bodyTab, hash, &new);
+    if (new) {
+        body = my_calloc(1, sizeof(struct jsBody), __func__);
+        strcpy(body->hash, hash);
+        ent->hData = body;
+    } else {
+        body = ent->hData;
+        if (body->refs > 0) {
+            /* A copy of a live body, the copy is dead.
+             */
+            deadSize += rlen;
+            return body;
+        }
+    }
+
+    /* A dead body stored again, its old
+     * record stays dead.
+     */
+    body->off = off;
+    body->len = len;
+    body->rlen = rlen;
+    deadSize += rlen;
+
+    return body;
+}
+
+static void
+jsLink(const char *jobFile, struct jsBody *body)
+{
+    hEnt *ent;
+    int new;
+
+    ent = h_addEnt_(&fileTab, jobFile, &new);
+    if (! new) {
+        jsUnlink(jobFile);
+        ent = h_addEnt_(&fileTab, jobFile, &new);
+    }
+
+    ent->hData = body;
+    if (body->refs == 0)
+        deadSize -= body->rlen;
+    body->refs++;
+}
+
+static int
+jsUnlink(const char *jobFile)
+{
+    struct jsBody *body;
+    hEnt *ent;
+
+    ent = h_getEnt_(&fileTab, jobFile);
+    if (ent == NULL)
+        return -1;
+
+    body = ent->hData;
+    body->refs--;
+    if (body->refs == 0)
+        deadSize += body->rlen;
+    deadSize += JREC_LEN(jobFile);
+
+    /* The body belongs to bodyTab.
+     */
+    h_rmEnt_(&fileTab, ent);
+
+    return 0;
+}
+
+/* jsReplay()
+ *
+ * Rebuild the in core index from the store. A record
+ * truncated by a crash ends the store.
+ */
+static int
+jsReplay(void)
+{
+    char line[2 * MAXFILENAMELEN];
+    char key[MAXFILENAMELEN];
+    char hash[JSTORE_HASHLEN + 1];
+    struct jsBody *body;
+    hEnt *ent;
+    FILE *fp;
+    off_t end;
+    off_t off;
+    int len;
+    int fd;
+
+    fd = dup(storeFd);
+    if (fd < 0
+        || (fp = fdopen(fd, "r")) == NULL) {
+        ls_syslog(LOG_ERR, "%s: fdopen() %s failed: %m", __func__, storeFn);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    rewind(fp);
+
+    end = 0;
+    while (fgets(line, sizeof(line), fp)) {
+
+        len = strlen(line);
+        if (line[len - 1] != '\n')
+            break;
+        off = end + len;
+
+        if (line[0] == 'D') {
+
+            if (sscanf(line, "D %16s %d", hash, &len) != 2
+                || len < 0
+                || fseeko(fp, off + len, SEEK_SET) < 0
+                || fgetc(fp) != '\n')
+                break;
+            jsAddBody(hash, off, len, off + len + 1 - end);
+            end = off + len + 1;
+
+        } else if (line[0] == 'J') {
+
+            if (sscanf(line, "J %s %16s", key, hash) != 2)
+                break;
+            ent = h_getEnt_(&bodyTab, hash);
+            if (ent == NULL)
+                break;
+            body = ent->hData;
+            jsLink(key, body);
+            end = off;
+
+        } else if (line[0] == 'R') {
+
+            if (sscanf(line, "R %s", key) != 1)
+                break;
+            jsUnlink(key);
+            deadSize += off - end;
+            end = off;
+
+        } else {
+            break;
+        }
+    }
+
+    if (fseeko(fp, 0, SEEK_END) == 0
+        && ftello(fp) != end) {
+        ls_syslog(LOG_WARNING, "\
+%s: %s has a bad record at offset %ld, truncated",
+                  __func__, storeFn, (long)end);
+        if (ftruncate(storeFd, end) < 0) {
+            ls_syslog(LOG_ERR, "%s: ftruncate() %s failed: %m",
+                      __func__, storeFn);
+            fclose(fp);
+            return -1;
+        }
+    }
+
+    fclose(fp);
+    storeSize = end;
+
+    return 0;
+}
+
+static char *
+jsRead(struct jsBody *body)
+{
+    char *buf;
+
+    buf = my_malloc(body->len + 1, __func__);
+    if (pread(storeFd, buf, body->len, body->off) != body->len) {
+        ls_syslog(LOG_ERR, "%s: pread() %s at %ld failed: %m",
+                  __func__, storeFn, (long)body->off);
+        FREEUP(buf);
+        return NULL;
+    }
+    buf[body->len] = 0;
+
+    return buf;
+}
+
+static int
+jsAppend(char *rec, int len)
+{
+    if (b_write_fix(storeFd, rec, len) != len) {
+        ls_syslog(LOG_ERR, "%s: write() %s failed: %m", __func__, storeFn);
+        return -1;
+    }
+    storeSize += len;
+
+    return 0;
+}
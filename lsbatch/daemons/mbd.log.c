@@ -28,6 +28,7 @@
 #define SKIPSPACE(sp)      while (isspace(*(sp))) (sp)++;
 
 time_t eventTime;
+static int eventGroup;
 
 extern bool_t          logMapFileEnable;
 
@@ -58,6 +59,7 @@ static int              replay_modifyjob(char *, int);
 static int              replay_modifyjob2(char *, int);
 
 static struct jData    *replay_jobdata(char *, int, char *);
+static int              replaceInfoFile(char *, char *, char *, int);
 static int              replay_signaljob(char *, int);
 static int              replay_jobsigact(char *, int);
 static int              replay_jobrequeue(char *, int);
@@ -240,7 +242,11 @@ init_log(void)
         ConfigError = -1;
     }
 
-    getElogLock();
+    /* The benchmark runs on a copy of the
+     * cluster, the lock is not ours.
+     */
+    if (benchSessions == 0)
+        getElogLock();
 
     sprintf(infoDir, "%s/logdir/info",
             daemonParams[LSB_SHAREDIR].paramValue);
@@ -250,6 +256,13 @@ init_log(void)
         mbdDie(MASTER_FATAL);
     }
 
+    /* The job file store must be loaded before
+     * the replay removes the files of cleaned jobs.
+     */
+    jstoreInit();
+
+    eventStreamInit();
+
     /* Create the stream directory.
      */
     sprintf(infoDir, "%s/logdir/stream",
@@ -2574,20 +2587,62 @@ putEventRecTime(const char *fname, time_t eventTime)
 static int
 putEventRec1(const char *fname)
 {
+    struct timeval t0;
+
+    gettimeofday(&t0, NULL);
     if (lsb_puteventrec(log_fp, logPtr) < 0) {
         ls_syslog(LOG_ERR, "\
 %s: lsb_puteventrec() failed %s", __func__, lsb_sysmsg());
         return -1;
     }
+    perfPhase(PERF_LOG, &t0);
 
     if (mbdParams->maxStreamRecords > 0)
         streamEvent(logPtr);
 
+    eventStreamPut(logPtr);
+    jobWatchLog(logPtr);
+
     free(logPtr);
+    if (eventGroup > 0)
+        return 0;
+
+    gettimeofday(&t0, NULL);
+    if (fflush(log_fp) != 0) {
+        ls_syslog(LOG_ERR, "%s: fflush() failed %m", __func__);
+        return -1;
+    }
+    perfPhase(PERF_FLUSH, &t0);
+
+    return 0;
+}
+
+/* beginEventGroup()
+ *
+ * The events logged until endEventGroup() are written
+ * to lsb.events together by one flush.
+ */
+void
+beginEventGroup(void)
+{
+    ++eventGroup;
+}
+
+int
+endEventGroup(void)
+{
+    struct timeval t0;
+
+    if (--eventGroup > 0
+        || log_fp == NULL)
+        return 0;
+
+    gettimeofday(&t0, NULL);
     if (fflush(log_fp) != 0) {
         ls_syslog(LOG_ERR, "%s: fflush() failed %m", __func__);
         return -1;
     }
+    perfPhase(PERF_FLUSH, &t0);
 
     return 0;
 }
@@ -3399,6 +3454,11 @@ logJobInfo(struct submitReq * req, struct jData *jp, struct lenData * jf)
     mode_t                  omask = umask(077);
     sigset_t                newmask, oldmask;
 
+    if (jstorePut(jp->shared->jobBill.jobFile, jf->data, jf->len) == 0) {
+        umask(omask);
+        return;
+    }
+
     sprintf(logFn, "%s/logdir/info/%s",
             daemonParams[LSB_SHAREDIR].paramValue,
             jp->shared->jobBill.jobFile);
@@ -3469,6 +3529,9 @@ rmLogJobInfo(struct jData *jp, int check)
         }
     }
 
+    if (jstoreRemove(req->jobFile) == 0)
+        return 0;
+
     sprintf(logFn, "%s/logdir/info/%s",
             daemonParams[LSB_SHAREDIR].paramValue, req->jobFile);
 
@@ -3520,39 +3583,42 @@ readLogJobInfo(struct jobSpecs *jobSpecs, struct jData *jpbw,
              daemonParams[LSB_SHAREDIR].paramValue,
              jpbw->shared->jobBill.jobFile);
 
-    fd = open(logFn, O_RDONLY);
-    if (fd < 0) {
-
-        sprintf(logFn, "%s/logdir/info/%d",
-                daemonParams[LSB_SHAREDIR].paramValue,
-                LSB_ARRAY_JOBID(jpbw->jobId));
+    buf = jstoreGet(jpbw->shared->jobBill.jobFile, &cc);
+    if (buf == NULL) {
         fd = open(logFn, O_RDONLY);
-    }
+        if (fd < 0) {
 
-    if (fd < 0) {
-        if (errno != ENOENT) {
+            sprintf(logFn, "%s/logdir/info/%d",
+                    daemonParams[LSB_SHAREDIR].paramValue,
+                    LSB_ARRAY_JOBID(jpbw->jobId));
+            fd = open(logFn, O_RDONLY);
+        }
+
+        if (fd < 0) {
+            if (errno != ENOENT) {
+                ls_syslog(LOG_ERR, I18N_JOB_FAIL_S_S_M,
+                          fname,
+                          lsb_jobid2str(jpbw->jobId),
+                          "open",
+                          logFn);
+            }
+            return -1;
+        }
+
+        fstat(fd, &st);
+        buf = my_malloc(st.st_size, fname);
+        if ((cc = read(fd, buf, st.st_size)) != st.st_size) {
             ls_syslog(LOG_ERR, I18N_JOB_FAIL_S_S_M,
                       fname,
                       lsb_jobid2str(jpbw->jobId),
-                      "open",
+                      "read",
                       logFn);
+            close(fd);
+            FREEUP(buf);
+            return -1;
         }
-        return -1;
-    }
-
-    fstat(fd, &st);
-    buf = my_malloc(st.st_size, fname);
-    if ((cc = read(fd, buf, st.st_size)) != st.st_size) {
-        ls_syslog(LOG_ERR, I18N_JOB_FAIL_S_S_M,
-                  fname,
-                  lsb_jobid2str(jpbw->jobId),
-                  "read",
-                  logFn);
         close(fd);
-        FREEUP(buf);
-        return -1;
     }
-    close(fd);
 
     for (sp = buf + strlen(SHELLLINE), numEnv = 0;
          strncmp(sp, ENVEND, sizeof(ENVEND) - 1); numEnv++) {
@@ -3731,6 +3797,9 @@ readJobInfoFile (struct jData *jp, int *len)
     int fd;
     char *buf;
 
+    if ((buf = jstoreGet(jp->shared->jobBill.jobFile, len)) != NULL)
+        return buf;
+
     sprintf(logFn, "%s/logdir/info/%s",
             daemonParams[LSB_SHAREDIR].paramValue,
             jp->shared->jobBill.jobFile);
@@ -3777,6 +3846,9 @@ writeJobInfoFile(struct jData *jp, char *jf, int len)
     char                    logFn[MAXFILENAMELEN];
     int                     fd, errnoSv;
 
+    if (jstorePut(jp->shared->jobBill.jobFile, jf, len) == 0)
+        return;
+
     sprintf(logFn, "%s/logdir/info/%s",
             daemonParams[LSB_SHAREDIR].paramValue,
             jp->shared->jobBill.jobFile);
@@ -3807,11 +3879,85 @@ writeJobInfoFile(struct jData *jp, char *jf, int len)
 }
 
 
+/* replaceJobInfoFile()
+ *
+ * The job file store has no in place update, so a job
+ * file kept there is edited as a scratch regular file
+ * which is then stored back.
+ */
 int
 replaceJobInfoFile(char *jobFileName,
                    char *newCommand,
                    char *jobStarter,
                    int options)
+{
+    char fn[MAXFILENAMELEN];
+    LS_STAT_T st;
+    char *buf;
+    int len;
+    int fd;
+    int cc;
+
+    buf = jstoreGet(jobFileName, &len);
+    if (buf == NULL)
+        return replaceInfoFile(jobFileName, newCommand, jobStarter, options);
+
+    sprintf(fn, "%s/logdir/info/%s",
+            daemonParams[LSB_SHAREDIR].paramValue, jobFileName);
+
+    fd = open(fn, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    if (fd < 0) {
+        ls_syslog(LOG_ERR, "%s: open() %s failed: %m", __func__, fn);
+        FREEUP(buf);
+        return -1;
+    }
+    cc = b_write_fix(fd, buf, len);
+    close(fd);
+    FREEUP(buf);
+    if (cc != len) {
+        ls_syslog(LOG_ERR, "%s: write() %s failed: %m", __func__, fn);
+        unlink(fn);
+        return -1;
+    }
+
+    if (replaceInfoFile(jobFileName, newCommand, jobStarter, options) < 0) {
+        unlink(fn);
+        return -1;
+    }
+
+    fd = open(fn, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        ls_syslog(LOG_ERR, "%s: open() %s failed: %m", __func__, fn);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    buf = my_malloc(st.st_size + 1, __func__);
+    len = read(fd, buf, st.st_size);
+    close(fd);
+    if (len != st.st_size) {
+        ls_syslog(LOG_ERR, "%s: read() %s failed: %m", __func__, fn);
+        FREEUP(buf);
+        return -1;
+    }
+
+    /* If the new job file cannot go to the store
+     * keep it as a regular file.
+     */
+    if (jstorePut(jobFileName, buf, len) < 0)
+        jstoreRemove(jobFileName);
+    else
+        unlink(fn);
+    FREEUP(buf);
+
+    return 0;
+}
+
+static int
+replaceInfoFile(char *jobFileName,
+                char *newCommand,
+                char *jobStarter,
+                int options)
 {
     static char fname[] = "replaceJobInfoFile";
     char jobFile[MAXFILENAMELEN];
@@ -183,6 +183,8 @@ static int processClient(struct clientNode *, int *);
 static void clientIO(struct chanData *);
 static int forkOnRequest(mbdReqType);
 static void shutdownSbdConnections(void);
+static void expireSbdConnects(void);
+static void sbdConnectFailed(struct sbdNode *);
 static void processSbdNode(struct sbdNode *, int);
 static void setNextSchedTimeWhenJobFinish(void);
 static void acceptConnection(int);
@@ -214,7 +216,7 @@ main(int argc, char **argv)
     saveDaemonDir_(argv[0]);
 
     opterr = 0;
-    while ((cc = getopt(argc, argv, "hVd:12C")) != EOF) {
+    while ((cc = getopt(argc, argv, "hVd:12Cb:L:")) != EOF) {
         switch (cc) {
             case '1':
             case '2':
@@ -227,17 +229,42 @@ main(int argc, char **argv)
                 putEnv("RECONFIG_CHECK","YES");
                 lsb_CheckMode = 1;
                 break;
+            case 'b':
+                benchSessions = atoi(optarg);
+                if (benchSessions <= 0) {
+                    fprintf(stderr, "\
+%s: invalid number of sessions %s\n", __func__, optarg);
+                    return -1;
+                }
+                break;
+            case 'L':
+                benchLoadFile = optarg;
+                break;
             case 'V':
                 fputs(_LS_VERSION_, stderr);
                 return -1;
             case 'h':
             default:
                 fprintf(stderr, "\
-%s: mbatchd [-h] [-V] [-C] [-d env_dir] [-1 |-2]\n", __func__);
+%s: mbatchd [-h] [-V] [-C] [-d env_dir] [-1 |-2] \
+[-b sessions [-L loadfile]]\n", __func__);
                 return -1;
         }
     }
 
+    if (benchSessions > 0) {
+        /* Run in the foreground and keep
+         * stdout for the results.
+         */
+        if (env_dir == NULL) {
+            fprintf(stderr, "\
+%s: the benchmark needs -d env_dir of a copy of the cluster\n", __func__);
+            return -1;
+        }
+        if (debug == 0)
+            debug = 1;
+    }
+
     if (initenv_(daemonParams, env_dir) < 0) {
 
         ls_openlog("mbatchd",
@@ -422,6 +449,9 @@ mbd:%s: MBD_MAX_JOBS_SCHED %d", __func__, max_job_sched);
     /* Go go go...
      */
     TIMEIT(0, minit(FIRST_START),"minit");
+    perfInit();
+    if (benchSessions > 0)
+        benchRun();
     log_mbdStart();
     ls_syslog(LOG_INFO, "%s: mbatchd (re-)started", __func__);
     pollSbatchds(FIRST_START);
@@ -444,6 +474,7 @@ mbd:%s: MBD_MAX_JOBS_SCHED %d", __func__, max_job_sched);
         }
 
         shutdownSbdConnections();
+        expireSbdConnects();
 
         if (now - lastElockTouch >= msleeptime) {
             touchElogLock();
@@ -456,6 +487,8 @@ mbd:%s: MBD_MAX_JOBS_SCHED %d", __func__, max_job_sched);
             timeout.tv_sec = 0;
         }
 
+        eventStreamFlush();
+
         nready = chanPoll_(&chans, &timeout);
         if (nready < 0) {
             if (errno != EINTR)
@@ -564,8 +597,11 @@ clientIO(struct chanData *chans)
 
         if (chans[cc].revents & POLLIN)
             processSbdNode(sbdPtr, false);
-        if (chans[cc].revents & POLLERR)
+        if (chans[cc].revents & POLLERR) {
+            if (chanPreconn_(cc))
+                sbdConnectFailed(sbdPtr);
             processSbdNode(sbdPtr, true);
+        }
     }
 
     for (cliPtr = clientList->forw;
@@ -613,7 +649,9 @@ processClient(struct clientNode *client, int *needFree)
     XDR                  xdrs;
     int                  statusReqCC = 0;
     int                  hostOkFlag = 0;
+    struct timeval       t0;
 
+    gettimeofday(&t0, NULL);
     laddrLen = sizeof(laddr);
     memset(&auth, 0, sizeof(auth));
     s = client->chanfd;
@@ -717,6 +755,15 @@ processClient(struct clientNode *client, int *needFree)
             setNextSchedTimeUponNewJob(jobData);
             statusChanged = 1;
             break;
+        case BATCH_JOB_SUB_PACK:
+            jobData = NULL;
+            TIMEIT(0, do_submitPackReq(&xdrs, s, &from, client->fromHost,
+                                       &reqHdr, &laddr, &auth, &schedule1,
+                                       dispatch, &jobData),
+                   "do_submitPackReq()");
+            setNextSchedTimeUponNewJob(jobData);
+            statusChanged = 1;
+            break;
         case BATCH_JOB_SIG:
             TIMEIT(0, do_signalReq(&xdrs, s, &from, client->fromHost, &reqHdr, &auth),"do_signalReq()");
             break;
@@ -866,6 +913,12 @@ processClient(struct clientNode *client, int *needFree)
                                         &auth),
                    "do_jobGroupModify()");
             break;
+        case BATCH_JOB_WATCH:
+            statusReqCC = do_jobWatch(&xdrs, client, &reqHdr);
+            break;
+        case BATCH_EVENT_STREAM:
+            statusReqCC = do_eventStream(&xdrs, client, &reqHdr);
+            break;
         case BATCH_RESLIMIT_INFO:
             TIMEIT(0, do_resLimitInfo(&xdrs,
                                       s,
@@ -873,6 +926,9 @@ processClient(struct clientNode *client, int *needFree)
                                       &reqHdr),
                    "do_resLimitInfo()");
             break;
+        case BATCH_PERF_INFO:
+            do_perfInfo(&xdrs, s, &from, &reqHdr);
+            break;
         default:
             errorBack(s, LSBE_PROTOCOL, &from);
             if (reqHdr.version <= OPENLAVA_XDR_VERSION)
@@ -888,6 +944,7 @@ processClient(struct clientNode *client, int *needFree)
         exit(0);
     }
 endLoop:
+    perfRequest(mbdReqtype, &t0);
     client->reqType = mbdReqtype;
     client->lastTime = now;
     xdr_destroy(&xdrs);
@@ -899,7 +956,9 @@ endLoop:
          && reqHdr.opCode != BATCH_STATUS_CHUNK
          && reqHdr.opCode != BATCH_JGRP_ADD
          && reqHdr.opCode != BATCH_JGRP_DEL
-         && reqHdr.opCode != BATCH_JGRP_MOD)
+         && reqHdr.opCode != BATCH_JGRP_MOD
+         && reqHdr.opCode != BATCH_JOB_WATCH
+         && reqHdr.opCode != BATCH_EVENT_STREAM)
         || statusReqCC < 0) {
         shutDownClient(client);
         return -1;
@@ -917,6 +976,10 @@ shutDownClient(struct clientNode *client)
         && client->lastTime)
         nSbdConnections--;
 
+    if (client->numWatch > 0)
+        jobWatchClear(client);
+    eventStreamClear(client);
+
     chanClose_(client->chanfd);
     offList((struct listEntry *)client);
     if (client->fromHost)
@@ -935,6 +998,7 @@ houseKeeping(int *hsKeeping)
     static int resignal = FALSE;
     static time_t lastAcctSched = 0;
     static int myTurn = RESIG;
+    struct timeval t0;
 
     ls_syslog(LOG_DEBUG, "\
 %s: mSchedStage=%x schedule=%d eventPending=%d now=%d lastSchedTime=%d nextSchedTime=%d", __func__, mSchedStage, schedule, eventPending,
@@ -959,8 +1023,10 @@ houseKeeping(int *hsKeeping)
         if (schedule) {
             lastSchedTime = now;
             nextSchedTime = now + msleeptime;
+            gettimeofday(&t0, NULL);
             TIMEIT(0, schedule = scheduleAndDispatchJobs(),
                    "scheduleAndDispatchJobs");
+            perfPhase(PERF_SESSION, &t0);
             if (schedule == 0) {
                 schedule = FALSE;
             } else {
@@ -1002,6 +1068,7 @@ periodicCheck(void)
     }
 
     switchELog();
+    jstoreCompact();
 
     if (jobPriorityUpdIntvl > 0) {
         if (now - last_jobPriUpdTime >= jobPriorityUpdIntvl * 60 ) {
@@ -1119,6 +1186,7 @@ authRequest(struct lsfAuth *auth,
     char buf[MAXLSFNAMELEN];
 
     if (!(reqType == BATCH_JOB_SUB
+          || reqType == BATCH_JOB_SUB_PACK
           || reqType == BATCH_JOB_PEEK
           || reqType == BATCH_JOB_SIG
           || reqType == BATCH_QUE_CTRL
@@ -1161,6 +1229,7 @@ authRequest(struct lsfAuth *auth,
 
     switch(reqType) {
         case BATCH_JOB_SUB:
+        case BATCH_JOB_SUB_PACK:
             if (auth->uid == 0
                 && daemonParams[LSF_ROOT_REX].paramValue  == NULL) {
                 ls_syslog(LOG_CRIT, "\
@@ -1267,6 +1336,43 @@ shutdownSbdConnections(void)
     }
 }
 
+/* expireSbdConnects()
+ *
+ * Give up on the sbatchd connections still
+ * in progress after connTimeout.
+ */
+static void
+expireSbdConnects(void)
+{
+    struct sbdNode *sbdPtr;
+    struct sbdNode *nextSbdPtr;
+
+    for (sbdPtr = sbdNodeList.forw;
+         sbdPtr != &sbdNodeList;
+         sbdPtr = nextSbdPtr) {
+        nextSbdPtr = sbdPtr->forw;
+
+        if (! chanPreconn_(sbdPtr->chanfd)
+            || now - sbdPtr->lastTime < connTimeout)
+            continue;
+
+        sbdConnectFailed(sbdPtr);
+        processSbdNode(sbdPtr, TRUE);
+    }
+}
+
+/* sbdConnectFailed()
+ */
+static void
+sbdConnectFailed(struct sbdNode *sbdPtr)
+{
+    ls_syslog(LOG_ERR, "\
+%s: failed to connect to sbatchd on host %s", __func__,
+              sbdPtr->hData->host);
+
+    hStatChange(sbdPtr->hData, HOST_STAT_UNREACH);
+}
+
 static void
 processSbdNode(struct sbdNode *sbdPtr, int exception)
 {
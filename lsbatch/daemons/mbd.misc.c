@@ -464,6 +464,7 @@ updQaccount(struct jData *jp, int numJobs, int numPEND,
     struct qData *qp = jp->qPtr;
     int numSlots;
     int newJob;
+    int reason;
 
     if (logclass & LC_SCHED)
         ls_syslog(LOG_INFO, "\
@@ -484,11 +485,13 @@ updQaccount(struct jData *jp, int numJobs, int numPEND,
         numSlots = INFINIT_INT;
     else
         numSlots = qp->maxJobs - (qp->numJobs - qp->numPEND);
-    if (qp->reasonTb[1][0] == INFINIT_INT)
-        qp->reasonTb[1][0] = 0;
-    SET_REASON(numSlots <= 0, qp->reasonTb[1][0], PEND_QUE_JOB_LIMIT);
+    reason = getHReason(qp->reasonTb[1], 0);
+    if (reason == INFINIT_INT)
+        reason = 0;
+    SET_REASON(numSlots <= 0, reason, PEND_QUE_JOB_LIMIT);
+    setHReason(qp->reasonTb[1], 0, reason);
     if (numSlots <= 0 && (logclass & LC_JLIMIT))
-        ls_syslog(LOG_DEBUG3, "%s: Q's MAX reached; reason=%d numSlots=%d", fname, qp->reasonTb[1][0], numSlots);
+        ls_syslog(LOG_DEBUG3, "%s: Q's MAX reached; reason=%d numSlots=%d", fname, reason, numSlots);
 
     newJob = (numRUN == 0 && numSSUSP == 0 && numUSUSP == 0
               && numRESERVE == 0 && numPEND == 0);
@@ -545,6 +548,7 @@ updUAcct (struct jData *jData,
     struct userAcct *foundU;
     struct qData *qp = jData->qPtr;
     int numSlots;
+    int reason;
 
     if (*uAcct == NULL) {
         *uAcct = (struct hTab *) my_malloc(sizeof(struct hTab), fname);
@@ -608,8 +612,9 @@ updUAcct (struct jData *jData,
 
         numSlots = hp->uJobLimit - foundU->numRUN - foundU->numSSUSP
             - foundU->numUSUSP - foundU->numRESERVE;
-        SET_REASON(numSlots <= 0, up->reasonTb[1][hp->hostId],
-                   PEND_HOST_USR_JLIMIT);
+        reason = getHReason(up->reasonTb[1], hp->hostId);
+        SET_REASON(numSlots <= 0, reason, PEND_HOST_USR_JLIMIT);
+        setHReason(up->reasonTb[1], hp->hostId, reason);
         if (numSlots <= 0 && (logclass & LC_JLIMIT))
             ls_syslog(LOG_DEBUG3, "%s: H's JL/U reached; job=%s host=%s user=%s", fname, lsb_jobid2str(jData->jobId), hp->host, jData->uPtr->user);
     }
@@ -849,6 +854,7 @@ updHAcct(struct jData *jData,
     struct hostAcct *foundH = NULL;
     struct hData *hp;
     int i, numSlots;
+    int reason;
 
     if (jData->hPtr == NULL)
         return;
@@ -891,7 +897,9 @@ updHAcct(struct jData *jData,
 
         if (qp != NULL) {
 
-            int svReason = qp->reasonTb[1][hp->hostId];
+            int svReason = getHReason(qp->reasonTb[1], hp->hostId);
+
+            reason = svReason;
             qp->flags &= ~QUEUE_UPDATE_USABLE;
             numSlots = pJobLimitOk(hp, foundH, qp->pJobLimit);
             if (numSlots <= 0
@@ -899,27 +907,26 @@ updHAcct(struct jData *jData,
                 && ! (hp->hStatus & HOST_STAT_UNAVAIL)
                 && ! LS_ISUNAVAIL (hp->limStatus)) {
 
-                SET_REASON(numSlots <= 0,
-                           qp->reasonTb[1][hp->hostId], PEND_QUE_PROC_JLIMIT);
-                CHECKQUSABLE (qp, svReason, qp->reasonTb[1][hp->hostId]);
+                SET_REASON(numSlots <= 0, reason, PEND_QUE_PROC_JLIMIT);
+                CHECKQUSABLE (qp, svReason, reason);
                 if (numSlots <= 0 && (logclass & (LC_PEND | LC_JLIMIT)))
-                    ls_syslog(LOG_DEBUG2, "%s: Q's JL/P reached. Set reason <%d>; job=%s host=%s queue=%s", fname, qp->reasonTb[1][hp->hostId], lsb_jobid2str(jData->jobId), hp->host, qp->queue);
+                    ls_syslog(LOG_DEBUG2, "%s: Q's JL/P reached. Set reason <%d>; job=%s host=%s queue=%s", fname, reason, lsb_jobid2str(jData->jobId), hp->host, qp->queue);
             } else {
                 numSlots = hJobLimitOk(hp, foundH, qp->hJobLimit);
-                SET_REASON(numSlots <= 0,
-                           qp->reasonTb[1][hp->hostId], PEND_QUE_HOST_JLIMIT);
-                CHECKQUSABLE (qp, svReason, qp->reasonTb[1][hp->hostId]);
+                SET_REASON(numSlots <= 0, reason, PEND_QUE_HOST_JLIMIT);
+                CHECKQUSABLE (qp, svReason, reason);
                 if (numSlots <= 0 && (logclass & (LC_PEND | LC_JLIMIT)))
-                    ls_syslog(LOG_DEBUG2, "%s: Q's JL/H reached. Set reason <%d>; job=%s host=%s queue=%s", fname, qp->reasonTb[1][hp->hostId], lsb_jobid2str(jData->jobId), hp->host, qp->queue);
+                    ls_syslog(LOG_DEBUG2, "%s: Q's JL/H reached. Set reason <%d>; job=%s host=%s queue=%s", fname, reason, lsb_jobid2str(jData->jobId), hp->host, qp->queue);
             }
             if (numSlots > 0
                 && (svReason == PEND_QUE_PROC_JLIMIT
                     || svReason == PEND_QUE_HOST_JLIMIT)) {
-                CLEAR_REASON(qp->reasonTb[1][hp->hostId], svReason);
-                CHECKQUSABLE (qp, svReason, qp->reasonTb[1][hp->hostId]);
+                CLEAR_REASON(reason, svReason);
+                CHECKQUSABLE (qp, svReason, reason);
                 if (logclass & (LC_PEND | LC_JLIMIT))
                     ls_syslog(LOG_DEBUG2, "%s: Clear reason <%d>; job=%s host=%s queue=%s", fname, svReason, lsb_jobid2str(jData->jobId), hp->host, qp->queue);
             }
+            setHReason(qp->reasonTb[1], hp->hostId, reason);
 
         } else {
 
@@ -930,14 +937,15 @@ updHAcct(struct jData *jData,
                     && !(hp->hStatus & HOST_STAT_UNREACH)
                     && ! (hp->hStatus & HOST_STAT_UNAVAIL)
                     && ! LS_ISUNAVAIL (hp->limStatus)) {
-                    SET_REASON(numSlots <= 0,
-                               up->reasonTb[1][hp->hostId],
-                               PEND_UGRP_PROC_JLIMIT);
+                    reason = getHReason(up->reasonTb[1], hp->hostId);
+                    SET_REASON(numSlots <= 0, reason, PEND_UGRP_PROC_JLIMIT);
+                    setHReason(up->reasonTb[1], hp->hostId, reason);
 
                 } else if (numSlots > 0) {
 
-                    CLEAR_REASON(up->reasonTb[1][hp->hostId],
-                                 PEND_UGRP_PROC_JLIMIT);
+                    reason = getHReason(up->reasonTb[1], hp->hostId);
+                    CLEAR_REASON(reason, PEND_UGRP_PROC_JLIMIT);
+                    setHReason(up->reasonTb[1], hp->hostId, reason);
                 }
 
             } else {
@@ -945,14 +953,15 @@ updHAcct(struct jData *jData,
                     && !(hp->hStatus & HOST_STAT_UNREACH)
                     && ! (hp->hStatus & HOST_STAT_UNAVAIL)
                     && ! LS_ISUNAVAIL (hp->limStatus)) {
-                    SET_REASON(numSlots <= 0,
-                               up->reasonTb[1][hp->hostId],
-                               PEND_USER_PROC_JLIMIT);
+                    reason = getHReason(up->reasonTb[1], hp->hostId);
+                    SET_REASON(numSlots <= 0, reason, PEND_USER_PROC_JLIMIT);
+                    setHReason(up->reasonTb[1], hp->hostId, reason);
 
                 } else if (numSlots > 0) {
 
-                    CLEAR_REASON(up->reasonTb[1][hp->hostId],
-                                 PEND_USER_PROC_JLIMIT);
+                    reason = getHReason(up->reasonTb[1], hp->hostId);
+                    CLEAR_REASON(reason, PEND_USER_PROC_JLIMIT);
+                    setHReason(up->reasonTb[1], hp->hostId, reason);
 
                 }
             }
@@ -1089,18 +1098,20 @@ updUserData (struct jData *jData, int numJobs, int numPEND,
     newJob = (numRUN == 0 && numSSUSP == 0 && numUSUSP == 0
               && numRESERVE == 0);
     if (!newJob) {
-        int svReason = up->reasonTb[1][0];
+        int svReason = getHReason(up->reasonTb[1], 0);
+        int reason = svReason;
         if (up->maxJobs == INFINIT_INT)
             numSlots = INFINIT_INT;
         else
             numSlots = up->maxJobs - up->numRUN - up->numSSUSP
                 - up->numUSUSP - up->numRESERVE;
-        if (up->reasonTb[1][0] == INFINIT_INT)
-            up->reasonTb[1][0] = 0;
-        SET_REASON(numSlots <= 0, up->reasonTb[1][0], PEND_USER_JOB_LIMIT);
+        if (reason == INFINIT_INT)
+            reason = 0;
+        SET_REASON(numSlots <= 0, reason, PEND_USER_JOB_LIMIT);
+        setHReason(up->reasonTb[1], 0, reason);
         if (logclass & (LC_PEND | LC_JLIMIT)) {
             if (numSlots <= 0) {
-                ls_syslog(LOG_DEBUG2, "%s: Set reason <%d> job=%s user=%s numJobs=%d maxJobs=%d numPEND=%d", fname, up->reasonTb[1][0], lsb_jobid2str(jData->jobId), up->user, up->numJobs, up->maxJobs, up->numPEND);
+                ls_syslog(LOG_DEBUG2, "%s: Set reason <%d> job=%s user=%s numJobs=%d maxJobs=%d numPEND=%d", fname, reason, lsb_jobid2str(jData->jobId), up->user, up->numJobs, up->maxJobs, up->numPEND);
             }
             else if (svReason == PEND_USER_JOB_LIMIT
                      && (logclass & (LC_PEND | LC_JLIMIT))) {
@@ -1150,19 +1161,21 @@ updUserData (struct jData *jData, int numJobs, int numPEND,
 
         if (!newJob) {
             int num;
-            int svReason = ugp->reasonTb[1][0];
+            int svReason = getHReason(ugp->reasonTb[1], 0);
+            int reason = svReason;
             if (ugp->maxJobs == INFINIT_INT)
                 num = INFINIT_INT;
             else
                 num = ugp->maxJobs - ugp->numRUN - ugp->numSSUSP
                     - ugp->numUSUSP - ugp->numRESERVE;
             numSlots = MIN(num, numSlots);
-            if (ugp->reasonTb[1][0] == INFINIT_INT)
-                ugp->reasonTb[1][0] = 0;
-            SET_REASON(num <= 0, ugp->reasonTb[1][0], PEND_UGRP_JOB_LIMIT);
+            if (reason == INFINIT_INT)
+                reason = 0;
+            SET_REASON(num <= 0, reason, PEND_UGRP_JOB_LIMIT);
+            setHReason(ugp->reasonTb[1], 0, reason);
             if (logclass & (LC_PEND | LC_JLIMIT)) {
                 if (num <= 0)
-                    ls_syslog(LOG_DEBUG2, "%s: Set reason <%d>; job=%s group=%s numJobs=%d maxJobs=%d numPEND=%d", fname, ugp->reasonTb[1][0], lsb_jobid2str(jData->jobId), ugp->user, ugp->numJobs, ugp->maxJobs, ugp->numPEND);
+                    ls_syslog(LOG_DEBUG2, "%s: Set reason <%d>; job=%s group=%s numJobs=%d maxJobs=%d numPEND=%d", fname, reason, lsb_jobid2str(jData->jobId), ugp->user, ugp->numJobs, ugp->maxJobs, ugp->numPEND);
                 else
                     if (svReason == PEND_UGRP_JOB_LIMIT
                         && (logclass & (LC_PEND | LC_JLIMIT)))
@@ -1297,9 +1310,11 @@ updHostData(char updHPart, struct jData *jData, int numJobs, int numRUN,
             }
 
             CLEAR_REASON(hReasonTb[1][hp->hostId], PEND_HOST_JOB_LIMIT);
-            for (qp = qDataList->forw; qp != qDataList; qp = qp->forw)
-                CLEAR_REASON(qp->reasonTb[1][hp->hostId],
-                             PEND_HOST_JOB_LIMIT);
+            for (qp = qDataList->forw; qp != qDataList; qp = qp->forw) {
+                if (getHReason(qp->reasonTb[1], hp->hostId)
+                    == PEND_HOST_JOB_LIMIT)
+                    setHReason(qp->reasonTb[1], hp->hostId, 0);
+            }
         }
 
         if (hp->numJobs <= 0)
@@ -1803,20 +1818,17 @@ initUData(struct uData *uPtr)
     uPtr->numGrpPtr = 0;
     uPtr->gPtr = NULL;
     uPtr->gData = NULL;
-    FREEUP(uPtr->reasonTb);
-    uPtr->reasonTb = my_calloc(2, sizeof(int *), __func__);
-    uPtr->reasonTb[0] = my_calloc(numofhosts() + 1,
-                                  sizeof(int), __func__);
-    uPtr->reasonTb[1] = my_calloc(numofhosts() + 1,
-                                  sizeof(int), __func__);
+    freeHReasons(uPtr->reasonTb);
+    uPtr->reasonTb = allocHReasons();
     uPtr->uDataIndex  = -1;
     uPtr->children    = NULL;
     uPtr->descendants = NULL;
     uPtr->parents     = NULL;
     uPtr->ancestors   = NULL;
-    /* User jobs references
+    /* User jobs references, a list per queue
+     * made when the user has jobs in the queue.
      */
-    uPtr->jobs = dlink_make();
+    uPtr->qJobs = NULL;
 }
 
 void
@@ -1902,3 +1914,160 @@ fork_mbd(void)
 
     return pid;
 }
+
+/* allocHReasons()
+ * The saved and the current reason tables
+ * of a queue or a user.
+ */
+struct hReasons **
+allocHReasons(void)
+{
+    struct hReasons **tb;
+
+    tb = my_calloc(2, sizeof(struct hReasons *), __func__);
+    tb[0] = my_calloc(1, sizeof(struct hReasons), __func__);
+    tb[1] = my_calloc(1, sizeof(struct hReasons), __func__);
+    tb[0]->gen = tb[1]->gen = 1;
+
+    return tb;
+}
+
+/* freeHReasons()
+ */
+void
+freeHReasons(struct hReasons **tb)
+{
+    int i;
+
+    if (tb == NULL)
+        return;
+
+    for (i = 0; i < 2; i++) {
+        if (tb[i] == NULL)
+            continue;
+        FREEUP(tb[i]->ents);
+        FREEUP(tb[i]);
+    }
+    free(tb);
+}
+
+/* findHReason()
+ * Linear probing from the host id, an entry of an
+ * older generation ends the probe since all the
+ * entries of this generation were placed in the
+ * first such slot of their probe.
+ */
+static struct hReasonEnt *
+findHReason(struct hReasons *tb, int hostId)
+{
+    struct hReasonEnt *e;
+    int i;
+
+    if (tb->size == 0)
+        return NULL;
+
+    i = hostId & (tb->size - 1);
+    for (;;) {
+        e = &tb->ents[i];
+        if (e->gen != tb->gen
+            || e->hostId == hostId)
+            return e;
+        i = (i + 1) & (tb->size - 1);
+    }
+}
+
+/* getHReason()
+ */
+int
+getHReason(struct hReasons *tb, int hostId)
+{
+    struct hReasonEnt *e;
+
+    e = findHReason(tb, hostId);
+    if (e == NULL
+        || e->gen != tb->gen)
+        return 0;
+
+    return e->reason;
+}
+
+/* setHReason()
+ */
+void
+setHReason(struct hReasons *tb, int hostId, int reason)
+{
+    struct hReasonEnt *e;
+    struct hReasonEnt *ents;
+    int size;
+    int i;
+
+    e = findHReason(tb, hostId);
+    if (e && e->gen == tb->gen) {
+        e->reason = reason;
+        return;
+    }
+
+    /* Only the hosts with a reason take room.
+     */
+    if (reason == 0)
+        return;
+
+    if (2 * (tb->num + 1) > tb->size) {
+
+        ents = tb->ents;
+        size = tb->size;
+        tb->size = size > 0 ? 2 * size : 8;
+        tb->ents = my_calloc(tb->size, sizeof(struct hReasonEnt), __func__);
+        tb->num = 0;
+        for (i = 0; i < size; i++) {
+            if (ents[i].gen != tb->gen)
+                continue;
+            e = findHReason(tb, ents[i].hostId);
+            *e = ents[i];
+            tb->num++;
+        }
+        FREEUP(ents);
+    }
+
+    e = findHReason(tb, hostId);
+    e->hostId = hostId;
+    e->reason = reason;
+    e->gen = tb->gen;
+    tb->num++;
+}
+
+/* clearHReasons()
+ */
+void
+clearHReasons(struct hReasons *tb)
+{
+    tb->num = 0;
+    tb->gen++;
+    if (tb->gen == 0) {
+        /* Wrapped, old entries could look current.
+         */
+        if (tb->ents)
+            memset(tb->ents, 0, tb->size * sizeof(struct hReasonEnt));
+        tb->gen = 1;
+    }
+}
+
+/* copyHReasons()
+ */
+void
+copyHReasons(struct hReasons *to, struct hReasons *from)
+{
+    if (to->size != from->size) {
+        FREEUP(to->ents);
+        if (from->size > 0)
+            to->ents = my_calloc(from->size,
+                                 sizeof(struct hReasonEnt), __func__);
+    }
+
+    if (from->size > 0)
+        memcpy(to->ents, from->ents,
+               from->size * sizeof(struct hReasonEnt));
+    to->size = from->size;
+    to->num = from->num;
+    to->gen = from->gen;
+}
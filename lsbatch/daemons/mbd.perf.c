@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "mbd.h"
+
+/* Performance metrics.
+ *
+ * Unlike TIMEIT() and the profile counters, which only log
+ * when a timing level is set, these are always collected.
+ * Every sample is one gettimeofday() and an increment in a
+ * histogram of power of two microsecond buckets, one per
+ * scheduler phase and one per request opcode.
+ *
+ * BATCH_PERF_INFO returns a snapshot as text lines, one
+ * metric per line, the first word naming it:
+ *
+ *   uptime <seconds>
+ *   clients <connections> sbd <sbatchd connections>
+ *   queue <name> <jobs> <pend> <run> <ssusp> <ususp> <reserve>
+ *   buckets <upper bound in usec of every bucket>
+ *   phase <name> <count> <total usec> <max usec> <bucket counts>
+ *   request <opcode> <count> <total usec> <max usec> <bucket counts>
+ *
+ * the last bucket has no upper bound and is shown as 0.
+ * The event log throughput is the count of the log phase
+ * over the uptime.
+ */
+
+#define PERF_BUCKETS 24
+#define PERF_MAX_OPCODE 128
+
+struct perfHist {
+    LS_LONG_INT count;
+    LS_LONG_INT total;
+    LS_LONG_INT max;
+    LS_LONG_INT bucket[PERF_BUCKETS];
+};
+
+static char *phaseNames[PERF_NUM_PHASES] = {
+    "session",
+    "load",
+    "candidates",
+    "dispatch",
+    "log",
+    "flush"
+};
+
+static struct perfHist phases[PERF_NUM_PHASES];
+static struct perfHist requests[PERF_MAX_OPCODE];
+static time_t perfStart;
+
+static void perfAdd(struct perfHist *, struct timeval *);
+static void perfPrint(FILE *, const char *, const char *, struct perfHist *);
+
+/* perfInit()
+ */
+void
+perfInit(void)
+{
+    perfStart = time(NULL);
+}
+
+/* perfPhase()
+ * Account the time since t0 to a scheduler phase.
+ */
+void
+perfPhase(perfPhase_t phase, struct timeval *t0)
+{
+    perfAdd(&phases[phase], t0);
+}
+
+/* perfRequest()
+ * Account the time since t0 to a request, the
+ * opcodes beyond the table go in its slot 0.
+ */
+void
+perfRequest(int opCode, struct timeval *t0)
+{
+    if (opCode <= 0 || opCode >= PERF_MAX_OPCODE)
+        opCode = 0;
+
+    perfAdd(&requests[opCode], t0);
+}
+
+/* do_perfInfo()
+ */
+int
+do_perfInfo(XDR *xdrs,
+            int chfd,
+            struct sockaddr_in *from,
+            struct LSFHeader *hdr)
+{
+    struct perfInfoReply reply;
+    struct LSFHeader replyHdr;
+    char *reply_buf;
+    XDR xdrs2;
+    int size;
+
+    reply.snapshot = perfSnapshot();
+    if (reply.snapshot == NULL) {
+        errorBack(chfd, LSBE_NO_MEM, from);
+        return -1;
+    }
+
+    size = sizeof(struct LSFHeader) + strlen(reply.snapshot) + 16;
+    reply_buf = my_calloc(size, sizeof(char), __func__);
+    xdrmem_create(&xdrs2, reply_buf, size, XDR_ENCODE);
+
+    initLSFHeader_(&replyHdr);
+    replyHdr.opCode = LSBE_NO_ERROR;
+
+    if (! xdr_encodeMsg(&xdrs2,
+                        (char *)&reply,
+                        &replyHdr,
+                        xdr_perfInfoReply,
+                        0,
+                        NULL)) {
+        ls_syslog(LOG_ERR, "\
+%s: failed encode %d bytes reply to %s", __func__,
+                  size, sockAdd2Str_(from));
+        xdr_destroy(&xdrs2);
+        FREEUP(reply_buf);
+        FREEUP(reply.snapshot);
+        return -1;
+    }
+
+    if (chanWrite_(chfd, reply_buf, XDR_GETPOS(&xdrs2)) <= 0) {
+        ls_syslog(LOG_ERR, "\
+%s: failed sending %d bytes reply to %s", __func__,
+                  XDR_GETPOS(&xdrs2), sockAdd2Str_(from));
+        xdr_destroy(&xdrs2);
+        FREEUP(reply_buf);
+        FREEUP(reply.snapshot);
+        return -1;
+    }
+
+    xdr_destroy(&xdrs2);
+    FREEUP(reply_buf);
+    FREEUP(reply.snapshot);
+
+    return 0;
+}
+
+/* perfAdd()
+ */
+static void
+perfAdd(struct perfHist *h, struct timeval *t0)
+{
+    struct timeval t1;
+    LS_LONG_INT usec;
+    int i;
+
+    gettimeofday(&t1, NULL);
+    usec = (LS_LONG_INT)(t1.tv_sec - t0->tv_sec) * 1000000
+        + (t1.tv_usec - t0->tv_usec);
+    if (usec < 0)
+        usec = 0;
+
+    for (i = 0; i < PERF_BUCKETS - 1; i++) {
+        if (usec < (1LL << i))
+            break;
+    }
+
+    ++h->count;
+    h->total += usec;
+    if (usec > h->max)
+        h->max = usec;
+    ++h->bucket[i];
+}
+
+/* perfSnapshot()
+ */
+char *
+perfSnapshot(void)
+{
+    struct clientNode *cl;
+    struct qData *qp;
+    char opCode[16];
+    char *buf;
+    size_t len;
+    FILE *fp;
+    int numClients;
+    int i;
+
+    fp = open_memstream(&buf, &len);
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "%s: open_memstream() failed %m", __func__);
+        return NULL;
+    }
+
+    numClients = 0;
+    for (cl = clientList->forw; cl != clientList; cl = cl->forw)
+        ++numClients;
+
+    fprintf(fp, "uptime %ld\n", (long)(time(NULL) - perfStart));
+    fprintf(fp, "clients %d sbd %d\n", numClients, nSbdConnections);
+
+    for (qp = qDataList->forw; qp != qDataList; qp = qp->forw) {
+        fprintf(fp, "queue %s %d %d %d %d %d %d\n", qp->queue,
+                qp->numJobs, qp->numPEND, qp->numRUN,
+                qp->numSSUSP, qp->numUSUSP, qp->numRESERVE);
+    }
+
+    fprintf(fp, "buckets");
+    for (i = 0; i < PERF_BUCKETS - 1; i++)
+        fprintf(fp, " %lld", 1LL << i);
+    fprintf(fp, " 0\n");
+
+    for (i = 0; i < PERF_NUM_PHASES; i++)
+        perfPrint(fp, "phase", phaseNames[i], &phases[i]);
+
+    for (i = 0; i < PERF_MAX_OPCODE; i++) {
+        if (requests[i].count == 0)
+            continue;
+        sprintf(opCode, "%d", i);
+        perfPrint(fp, "request", opCode, &requests[i]);
+    }
+
+    if (fclose(fp) != 0) {
+        free(buf);
+        return NULL;
+    }
+
+    return buf;
+}
+
+/* perfPrint()
+ */
+static void
+perfPrint(FILE *fp, const char *kind, const char *name, struct perfHist *h)
+{
+    int i;
+
+    fprintf(fp, "%s %s %lld %lld %lld", kind, name,
+            (long long)h->count, (long long)h->total, (long long)h->max);
+    for (i = 0; i < PERF_BUCKETS; i++)
+        fprintf(fp, " %lld", (long long)h->bucket[i]);
+    fprintf(fp, "\n");
+}
@@ -67,6 +67,36 @@ struct leftTimeTable {
     int slots;
 };
 
+/* A limit of lsb.resources with its consumers parsed
+ * once at configuration time. Names are kept lowercase
+ * in the tables since consumers match case insensitive,
+ * a NULL table means the consumer is not in the limit.
+ */
+struct limitRule {
+    struct resLimit *limit;
+    int perQueue;
+    int perHost;
+    hTab *queues;
+    int numQNames;
+    char **qNames;
+    hTab *hosts;
+    hTab *users;
+    hTab *userDef;
+    hTab *userNeg;
+    int userAll;
+    hTab *projects;
+    hTab *projNeg;
+    int projAll;
+};
+
+static struct limitRule *limitRules;
+static int numLimitRules;
+
+static int *reasonPos;
+static int reasonPosSize;
+static int reasonTbSize;
+static struct jData *reasonJob;
+
 #define OUT_SCHED_RS(reason)                    \
     ((reason) == PEND_HOST_JOB_LIMIT            \
      || (reason) ==  PEND_QUE_JOB_LIMIT         \
@@ -205,6 +235,8 @@ static enum candRetCode getCandHosts(struct jData *);
 static int getLsbUsable(void);
 static struct candHost *getJUsable(struct jData *, int *, int *);
 static void addReason(struct jData *jp, int hostId, int aReason);
+static void reasonIndexOn(struct jData *);
+static void reasonIndexOff(void);
 static int allInOne(struct jData *jp);
 static int ckResReserve(struct hData *,
                         struct resVal *,
@@ -233,9 +265,18 @@ static int checkIfLimitIsOk(struct limitRes *,
                         limitConsumerType_t,
                         char *,
                         limitConsumerType_t,
-                        char *,
+                        struct limitRule *,
                         struct jData *);
-static int cntConsumerSlots(limitConsumerType_t, char*, char*, int);
+static int checkRuleLimit(struct limitRule *, limitConsumerType_t, char *,
+                          struct resData *, struct jData *, struct hData *);
+static int ruleListMatch(hTab *, hTab *, int, const char *);
+static void compileRule(struct limitRule *, struct resLimit *);
+static void freeRule(struct limitRule *);
+static hTab *ruleTab(hTab *);
+static void ruleWord(hTab *, hTab *, char *, int);
+static char *ruleKey(const char *, char *);
+static int cntConsumerSlots(limitConsumerType_t, char*,
+                            struct limitRule *, int);
 static int cntQSlots(limitConsumerType_t, char*, char*, int);
 static int allocHosts(struct jData *jp);
 static int deallocHosts(struct jData *jp);
@@ -290,6 +331,7 @@ static void copyCandHostData(struct candHost* , struct candHost* );
 static int noPreference(struct askedHost *, int, int);
 static int imposeDCSOnJob(struct jData *, time_t *, int *, int *);
 static void copyReason(void);
+static void keepOutSchedReasons(struct hReasons *);
 static void clearJobReason(void);
 static int isInCandList (struct candHost *, struct hData *, int);
 static bool_t enoughMaxUsableSlots(struct jData *);
@@ -490,10 +532,10 @@ readyToDisp (struct jData *jpbw, int *numAvailSlots)
         if (jpbw->newReason == PEND_JOB_NO_PASSWD ){
             jReason = jpbw->newReason;
         }
-    } else if (OUT_SCHED_RS(jpbw->qPtr->reasonTb[1][0])) {
-        jReason = jpbw->qPtr->reasonTb[1][0];
-    } else if (OUT_SCHED_RS(jpbw->uPtr->reasonTb[1][0])) {
-        jReason = jpbw->uPtr->reasonTb[1][0];
+    } else if (OUT_SCHED_RS(getHReason(jpbw->qPtr->reasonTb[1], 0))) {
+        jReason = getHReason(jpbw->qPtr->reasonTb[1], 0);
+    } else if (OUT_SCHED_RS(getHReason(jpbw->uPtr->reasonTb[1], 0))) {
+        jReason = getHReason(jpbw->uPtr->reasonTb[1], 0);
     } else if (!(jpbw->qPtr->qStatus & QUEUE_STAT_ACTIVE)) {
         jReason = PEND_QUE_INACT;
     } else if (!(jpbw->qPtr->qStatus & QUEUE_STAT_RUN)) {
@@ -525,8 +567,8 @@ readyToDisp (struct jData *jpbw, int *numAvailSlots)
         int i;
         for (i = 0; i < jpbw->uPtr->numGrpPtr; i++) {
             struct uData *ugp = jpbw->uPtr->gPtr[i];
-            if (OUT_SCHED_RS(ugp->reasonTb[1][0])) {
-                jReason = ugp->reasonTb[1][0];
+            if (OUT_SCHED_RS(getHReason(ugp->reasonTb[1], 0))) {
+                jReason = getHReason(ugp->reasonTb[1], 0);
                 break;
             }
         }
@@ -1142,10 +1184,10 @@ getQUsable(struct qData *qp)
     qp->numReasons = 0;
     qp->qAttrib &= ~Q_ATTRIB_NO_HOST_TYPE;
 
-    if (OUT_SCHED_RS(qp->reasonTb[1][0])) {
+    if (OUT_SCHED_RS(getHReason(qp->reasonTb[1], 0))) {
         ls_syslog(LOG_DEBUG, "\
 %s: Queue %s can't dispatch jobs at the moment; reason=%d",
-                  __func__, qp->queue, qp->reasonTb[1][0]);
+                  __func__, qp->queue, getHReason(qp->reasonTb[1], 0));
         return 0;
     }
 
@@ -1213,8 +1255,8 @@ getQUsable(struct qData *qp)
         if (hReason)
             goto next;
 
-        if (OUT_SCHED_RS(qp->reasonTb[1][i])) {
-            hReason = qp->reasonTb[1][i];
+        if (OUT_SCHED_RS(getHReason(qp->reasonTb[1], i))) {
+            hReason = getHReason(qp->reasonTb[1], i);
             goto next;
         }
 
@@ -1226,11 +1268,11 @@ getQUsable(struct qData *qp)
 
     next:
         if (hReason) {
-            qp->reasonTb[1][i] = hReason;
+            setHReason(qp->reasonTb[1], i, hReason);
             qp->numReasons++;
             continue;
         }
-        qp->reasonTb[1][i] = 0;
+        setHReason(qp->reasonTb[1], i, 0);
 
         ls_syslog(LOG_DEBUG, "\
 %s: Got one eligible host %s",
@@ -1343,11 +1385,11 @@ getJUsable(struct jData *jp, int *numJUsable, int *nProc)
             if (HOST_UNUSABLE_TO_JOB_DUE_TO_H_REASON(hReasonTb[1][i], jp))
                 continue;
 
-            if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(jp->qPtr->reasonTb[1][i], jp))
+            if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(getHReason(jp->qPtr->reasonTb[1], i), jp))
                 continue;
 
-            if (OUT_SCHED_RS(jp->uPtr->reasonTb[1][i])
-                && HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(jp->uPtr->reasonTb[1][i], jp))
+            if (OUT_SCHED_RS(getHReason(jp->uPtr->reasonTb[1], i))
+                && HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(getHReason(jp->uPtr->reasonTb[1], i), jp))
                 continue;
 
             if (hPtr->hStatus & HOST_STAT_REMOTE)
@@ -1383,11 +1425,11 @@ getJUsable(struct jData *jp, int *numJUsable, int *nProc)
             if (HOST_UNUSABLE_TO_JOB_DUE_TO_H_REASON(hReasonTb[1][i], jp))
                 continue;
 
-            if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(jp->qPtr->reasonTb[1][i], jp))
+            if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(getHReason(jp->qPtr->reasonTb[1], i), jp))
                 continue;
 
-            if (OUT_SCHED_RS(jp->uPtr->reasonTb[1][i])
-                && HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(jp->uPtr->reasonTb[1][i], jp))
+            if (OUT_SCHED_RS(getHReason(jp->uPtr->reasonTb[1], i))
+                && HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(getHReason(jp->uPtr->reasonTb[1], i), jp))
                 continue;
 
             if (jp->numAskedPtr == 0 || jp->askedOthPrio >= 0) {
@@ -1987,12 +2029,98 @@ ckResReserve(struct hData *hPtr,
     return 0;
 }
 
+/* reasonIndexOn()
+ * Index the host reasons of a job by host so that
+ * addReason() does not search the table when called
+ * for every candidate host. The index is shared by all
+ * jobs and is valid until reasonIndexOff(), in between
+ * the table of the job may change only by addReason().
+ */
+static void
+reasonIndexOn(struct jData *jp)
+{
+    int hostId;
+    int i;
+
+    if (reasonPosSize < numofhosts() + 1) {
+        FREEUP(reasonPos);
+        reasonPosSize = numofhosts() + 1;
+        reasonPos = my_calloc(reasonPosSize, sizeof(int), __func__);
+    }
+
+    for (i = 0; i < jp->numReasons; i++) {
+        GET_HIGH(hostId, jp->reasonTb[i]);
+        if (hostId < reasonPosSize
+            && reasonPos[hostId] == 0)
+            reasonPos[hostId] = i + 1;
+    }
+
+    reasonJob = jp;
+    reasonTbSize = jp->numReasons;
+}
+
+/* reasonIndexOff()
+ * Clear the entries of the index and give back
+ * the room addReason() allocated ahead.
+ */
+static void
+reasonIndexOff(void)
+{
+    struct jData *jp = reasonJob;
+    int *newTb;
+    int hostId;
+    int i;
+
+    for (i = 0; i < jp->numReasons; i++) {
+        GET_HIGH(hostId, jp->reasonTb[i]);
+        if (hostId < reasonPosSize)
+            reasonPos[hostId] = 0;
+    }
+
+    if (jp->numReasons > 0
+        && reasonTbSize > jp->numReasons) {
+        newTb = myrealloc(jp->reasonTb, jp->numReasons * sizeof(int));
+        if (newTb)
+            jp->reasonTb = newTb;
+    }
+
+    reasonJob = NULL;
+    reasonTbSize = 0;
+}
+
 static void
 addReason(struct jData *jp, int hostId, int aReason)
 {
     int *newTb;
     int i;
     int oldhostId;
+    int size;
+
+    if (jp == reasonJob
+        && hostId < reasonPosSize) {
+
+        i = reasonPos[hostId] - 1;
+        if (i >= 0) {
+            jp->reasonTb[i] = aReason;
+            PUT_HIGH(jp->reasonTb[i], hostId);
+            return;
+        }
+
+        if (jp->numReasons == reasonTbSize) {
+            size = 2 * reasonTbSize + 16;
+            newTb = myrealloc(jp->reasonTb, size * sizeof(int));
+            if (newTb == NULL)
+                return;
+            jp->reasonTb = newTb;
+            reasonTbSize = size;
+        }
+
+        jp->reasonTb[jp->numReasons] = aReason;
+        PUT_HIGH(jp->reasonTb[jp->numReasons], hostId);
+        jp->numReasons++;
+        reasonPos[hostId] = jp->numReasons;
+        return;
+    }
 
     for (i = 0; i < jp->numReasons; i++) {
         GET_HIGH(oldhostId, jp->reasonTb[i]);
@@ -2010,6 +2138,8 @@ addReason(struct jData *jp, int hostId, int aReason)
             jp->reasonTb[jp->numReasons] = aReason;
             PUT_HIGH(jp->reasonTb[jp->numReasons], hostId);
             jp->numReasons++;
+            if (jp == reasonJob)
+                reasonTbSize = jp->numReasons;
         }
     }
 }
@@ -2464,7 +2594,7 @@ getHostJobSlots (struct jData *jp, struct hData *hp, int *numAvailSlots,
     INC_CNT(PROF_CNT_getHostJobSlots);
 
 #define HOST_USABLE(jp, hp)                                             \
-    ((jp)->qPtr->reasonTb[1][(hp)->hostId] != PEND_HOST_ACCPT_ONE)
+    (getHReason((jp)->qPtr->reasonTb[1], (hp)->hostId) != PEND_HOST_ACCPT_ONE)
 
 
     *backfilleeList = NULL;
@@ -3030,285 +3160,338 @@ hostSlots (int numNeeded, struct jData *jp, struct hData *hp,
     return (slots);
 }
 
-static int
-checkResLimit(struct jData *jp, struct hData *hp)
+/* compileResLimits()
+ * Parse the consumers of the lsb.resources limits once,
+ * checkResLimit() runs for every job and candidate host.
+ * The user groups are expanded here so this must run
+ * after the groups have been configured.
+ */
+void
+compileResLimits(void)
 {
-    int i, j;
-    char *hostname = NULL;
-    char *queue = NULL;
-    char *save_queue = NULL;
-    int  per_queue = FALSE;
-    char *project = NULL;
-    char *save_project = NULL;
-    char *user = NULL;
-    char *save_user =NULL;
-    char *user_def = NULL;
-    char *save_user_def = NULL;
-    char *host = NULL;
-    char *save_host = NULL;
-    int  per_host = FALSE;
-    char *word = NULL;
-    int hasMe = FALSE;
-    char all[5] = "all";
-    int hasAll = FALSE;
-    int neg = FALSE;
-    int ret;
-    static struct limitRes *lr;
+    int i;
+
+    for (i = 0; i < numLimitRules; i++)
+        freeRule(&limitRules[i]);
+    FREEUP(limitRules);
+    numLimitRules = 0;
 
     if (limitConf == NULL || limitConf->nLimit == 0)
-        return TRUE;
+        return;
 
-    if (hp)
-        hostname = hp->host;
+    limitRules = my_calloc(limitConf->nLimit,
+                           sizeof(struct limitRule), __func__);
 
     for (i = 0; i < limitConf->nLimit; i++) {
         /* no consumer defined, ignore */
         if (limitConf->limits[i].nConsumer <= 0)
             continue;
+        compileRule(&limitRules[numLimitRules], &limitConf->limits[i]);
+        ++numLimitRules;
+    }
+}
 
-        per_queue = per_host = FALSE;
-        for (j = 0; j < limitConf->limits[i].nConsumer; j++) {
-            if (limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_QUEUES
-                    || limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_PER_QUEUE) {
-                per_queue = limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_QUEUES ? FALSE : TRUE;
-                queue = strdup(limitConf->limits[i].consumers[j].value);
-                save_queue = queue;
-            }else if (limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_PROJECTS
-                          || limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_PER_PROJECT) {
-                project = strdup(limitConf->limits[i].consumers[j].value);
-                save_project = project;
-            } else if (limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_HOSTS
-                            || limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_PER_HOST) {
-                per_host = limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_HOSTS ? FALSE : TRUE;
-                host = strdup(limitConf->limits[i].consumers[j].value);
-                save_host = host;
-            } else if (limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_USERS
-                            || limitConf->limits[i].consumers[j].consumer == LIMIT_CONSUMER_PER_USER) {
-                user = strdup(limitConf->limits[i].consumers[j].value);
-                save_user = user;
-                user_def = strdup(limitConf->limits[i].consumers[j].def);
-                save_user_def = user_def;
-            }
+/* compileRule()
+ * If a consumer is configured more than once
+ * in a limit the last one is used.
+ */
+static void
+compileRule(struct limitRule *rule, struct resLimit *limit)
+{
+    struct limitConsumer *c;
+    char *list;
+    char *save;
+    char *word;
+    char *def;
+    int j;
+
+    rule->limit = limit;
+
+    for (j = 0; j < limit->nConsumer; j++) {
+
+        c = &limit->consumers[j];
+        list = save = safeSave(c->value ? c->value : "");
+
+        switch (c->consumer) {
+            case LIMIT_CONSUMER_QUEUES:
+            case LIMIT_CONSUMER_PER_QUEUE:
+                rule->perQueue = (c->consumer == LIMIT_CONSUMER_PER_QUEUE);
+                rule->queues = ruleTab(rule->queues);
+                while (rule->numQNames > 0)
+                    FREEUP(rule->qNames[--rule->numQNames]);
+                FREEUP(rule->qNames);
+                rule->qNames = my_calloc(strlen(save) / 2 + 1,
+                                         sizeof(char *), __func__);
+                while ((word = getNextWord_(&list)) != NULL) {
+                    rule->qNames[rule->numQNames++] = safeSave(word);
+                    ruleWord(rule->queues, NULL, word, FALSE);
+                }
+                break;
+            case LIMIT_CONSUMER_HOSTS:
+            case LIMIT_CONSUMER_PER_HOST:
+                rule->perHost = (c->consumer == LIMIT_CONSUMER_PER_HOST);
+                rule->hosts = ruleTab(rule->hosts);
+                while ((word = getNextWord_(&list)) != NULL)
+                    ruleWord(rule->hosts, NULL, word, FALSE);
+                break;
+            case LIMIT_CONSUMER_USERS:
+            case LIMIT_CONSUMER_PER_USER:
+                rule->users = ruleTab(rule->users);
+                rule->userDef = ruleTab(rule->userDef);
+                rule->userNeg = ruleTab(rule->userNeg);
+                while ((word = getNextWord_(&list)) != NULL)
+                    ruleWord(rule->users, NULL, word, FALSE);
+                def = c->def ? c->def : "";
+                rule->userAll = (strstr(def, "all") == def);
+                FREEUP(save);
+                list = save = safeSave(def);
+                while ((word = getNextWord_(&list)) != NULL)
+                    ruleWord(rule->userDef, rule->userNeg, word, TRUE);
+                break;
+            case LIMIT_CONSUMER_PROJECTS:
+            case LIMIT_CONSUMER_PER_PROJECT:
+                rule->projects = ruleTab(rule->projects);
+                rule->projNeg = ruleTab(rule->projNeg);
+                rule->projAll = (strstr(save, "all") == save);
+                while ((word = getNextWord_(&list)) != NULL)
+                    ruleWord(rule->projects, rule->projNeg, word, FALSE);
+                break;
+            default:
+                break;
         }
 
+        FREEUP(save);
+    }
+}
+
+/* ruleWord()
+ * Add a consumer word to the rule tables. With a neg
+ * table a leading ~ negates the word, a name keeps the
+ * sign of the first word it matched as checkResLimit()
+ * stops at the first match.
+ */
+static void
+ruleWord(hTab *pos, hTab *neg, char *word, int expand)
+{
+    char key[MAXLINELEN];
+    hTab *tab;
+    struct gData *gp;
+    char **members;
+    int num;
+    int i;
+
+    tab = pos;
+    if (neg && word[0] == '~') {
+        tab = neg;
+        word++;
+    }
+
+    ruleKey(word, key);
+    if (h_getEnt_(pos, key) == NULL
+        && (neg == NULL || h_getEnt_(neg, key) == NULL))
+        h_addEnt_(tab, key, NULL);
+
+    if (! expand
+        || (gp = getUGrpData(word)) == NULL)
+        return;
+
+    members = expandGrp(gp, word, &num);
+    for (i = 0; i < num; i++) {
+        ruleKey(members[i], key);
+        if (h_getEnt_(pos, key) == NULL
+            && h_getEnt_(neg, key) == NULL)
+            h_addEnt_(tab, key, NULL);
+    }
+    FREEUP(members);
+}
+
+/* ruleTab()
+ */
+static hTab *
+ruleTab(hTab *tab)
+{
+    if (tab)
+        h_freeTab_(tab, NULL);
+    else
+        tab = my_malloc(sizeof(hTab), __func__);
+
+    h_initTab_(tab, 16);
+
+    return tab;
+}
+
+/* freeRule()
+ */
+static void
+freeRule(struct limitRule *rule)
+{
+    hTab **tabs[7];
+    int i;
+
+    tabs[0] = &rule->queues;
+    tabs[1] = &rule->hosts;
+    tabs[2] = &rule->users;
+    tabs[3] = &rule->userDef;
+    tabs[4] = &rule->userNeg;
+    tabs[5] = &rule->projects;
+    tabs[6] = &rule->projNeg;
+
+    for (i = 0; i < 7; i++) {
+        if (*tabs[i] == NULL)
+            continue;
+        h_freeTab_(*tabs[i], NULL);
+        FREEUP(*tabs[i]);
+    }
+
+    for (i = 0; i < rule->numQNames; i++)
+        FREEUP(rule->qNames[i]);
+    FREEUP(rule->qNames);
+    memset(rule, 0, sizeof(struct limitRule));
+}
+
+/* ruleKey()
+ */
+static char *
+ruleKey(const char *name, char *key)
+{
+    int i;
+
+    for (i = 0; name[i] && i < MAXLINELEN - 1; i++)
+        key[i] = tolower((unsigned char)name[i]);
+    key[i] = 0;
+
+    return key;
+}
+
+/* ruleListMatch()
+ * A list starting with all applies to everybody
+ * not negated, otherwise only to its members.
+ */
+static int
+ruleListMatch(hTab *pos, hTab *neg, int all, const char *key)
+{
+    int hasMe;
+    int isNeg;
+
+    isNeg = (h_getEnt_(neg, key) != NULL);
+    hasMe = isNeg || h_getEnt_(pos, key) != NULL;
+
+    if ((!all && hasMe)
+        || (all && hasMe && !isNeg)
+        || (all && !hasMe))
+        return TRUE;
+
+    return FALSE;
+}
+
+static int
+checkResLimit(struct jData *jp, struct hData *hp)
+{
+    struct limitRule *rule;
+    char queue[MAXLINELEN];
+    char host[MAXLINELEN];
+    char user[MAXLINELEN];
+    char project[MAXLINELEN];
+    char *projectName;
+    int i;
+
+    if (numLimitRules == 0)
+        return TRUE;
+
+    projectName = jp->shared->jobBill.projectName;
+    ruleKey(jp->qPtr->queue, queue);
+    ruleKey(jp->userName, user);
+    ruleKey(projectName ? projectName : "", project);
+    if (hp)
+        ruleKey(hp->host, host);
+
+    for (i = 0; i < numLimitRules; i++) {
+
+        rule = &limitRules[i];
+
         /* checking hostname but HOSTS is not defined in limit, ignore */
-        if ((hostname && !host)
-            || (!hostname && host))
-            goto clean4next;
+        if ((hp && !rule->hosts)
+            || (!hp && rule->hosts))
+            continue;
 
         /* enforce limit only if job is submitted to this particular queue */
-        if (queue) {
-            hasMe = FALSE;
-            while ( ( word = getNextWord_ ( &queue) ) != NULL ) {
-                if (strcasecmp(word, jp->qPtr->queue) == 0) {
-                    hasMe = TRUE;
-                    break;
-                }
-            }
-            if (!hasMe)
-                goto clean4next;
-        }
+        if (rule->queues
+            && h_getEnt_(rule->queues, queue) == NULL)
+            continue;
 
         /* enforce limit only if scheduler is evaluating particular hosts */
-        if (host) {
-            hasMe = FALSE;
-            while (( word = getNextWord_(&host)) != NULL ) {
-                if (strcasecmp(word, hostname) == 0) {
-                    hasMe = TRUE;
-                    break;
-                }
-            }
-            if (!hasMe)
-                goto clean4next;
+        if (rule->hosts) {
 
-            if (per_host) {
+            if (h_getEnt_(rule->hosts, host) == NULL)
+                continue;
+
+            if (rule->perHost) {
                 if (!jp->hqPtr
-                    || strcmp(hostname, jp->hqPtr->host))
+                    || strcmp(hp->host, jp->hqPtr->host))
                     jp->hqPtr = getLimitUsageData(LIMIT_CONSUMER_PER_HOST,
-                                                  hostname,
+                                                  hp->host,
                                                   jp->qPtr->queue);
-
-                lr = getActiveLimit(limitConf->limits[i].res, limitConf->limits[i].nRes);
-                if (lr) {
-                    cntMaxResLimit(lr, jp->hqPtr, hp);
-                    ret = checkIfLimitIsOk(lr,
-                                       LIMIT_CONSUMER_PER_HOST,
-                                       hostname,
-                                       per_queue,
-                                       save_queue,
-                                       jp);
-                    if (!ret) {
-                        FREEUP(save_queue);
-                        FREEUP(save_project);
-                        FREEUP(save_host);
-                        FREEUP(save_user);
-                        FREEUP(save_user_def);
-                        return FALSE;
-                    }
-                }
+                if (! checkRuleLimit(rule, LIMIT_CONSUMER_PER_HOST,
+                                     hp->host, jp->hqPtr, jp, hp))
+                    return FALSE;
             }
         }
 
         /* check if user is allowed to use the queue/host */
-        if (user) {
-            hasMe = FALSE;
-            while ((word = getNextWord_(&user)) != NULL ) {
-                if (strcasecmp(word, jp->userName) == 0) {
-                    hasMe = TRUE;
-                    break;
-                }
-            }
+        if (rule->users) {
 
-            if (hasMe) {
-                lr = getActiveLimit(limitConf->limits[i].res, limitConf->limits[i].nRes);
-                if (lr) {
-                    cntMaxResLimit(lr, jp->uqPtr, hp);
-                    ret = checkIfLimitIsOk(lr,
-                                       LIMIT_CONSUMER_PER_USER,
-                                       jp->userName,
-                                       per_queue,
-                                       save_queue,
-                                       jp);
-                    if (!ret) {
-                        FREEUP(save_queue);
-                        FREEUP(save_project);
-                        FREEUP(save_host);
-                        FREEUP(save_user);
-                        FREEUP(save_user_def);
-                        return FALSE;
-                    }
-                }
-            } else {
-                /* check unix user */
-                char *word2 = NULL;
-                if (strstr(user_def, all) == user_def)
-                    hasAll = TRUE;
-                while ((word2 = getNextWord_(&user_def)) != NULL) {
-                    if (word2[0] == '~') {
-                        neg = TRUE;
-                        word2++;
-                    }
-                    if (strcasecmp(word2, jp->userName) == 0) {
-                        hasMe = TRUE;
-                        break;
-                    } else {
-                        /* check LSF or UNIX user group */
-                        struct gData *gp = NULL;
-
-                        gp = getUGrpData(word2);
-                        if (gp) {
-                            char  **gUsers = NULL;
-                            int   numUsers = 0;
-                            int   i;
-
-                            gUsers = expandGrp(gp, word2, &numUsers);
-                            for (i = 0; i < numUsers; i++) {
-                                if (strcasecmp(gUsers[i], jp->userName) == 0) {
-                                    hasMe = TRUE;
-                                    break;
-                                }
-                            }
-                            FREEUP(gUsers);
-                            if (hasMe)
-                                break;
-                        }
-                    }
-                    neg = FALSE;
-                }
+            if (h_getEnt_(rule->users, user) == NULL
+                && ! ruleListMatch(rule->userDef, rule->userNeg,
+                                   rule->userAll, user))
+                continue;
 
-                if ((!hasAll && hasMe)
-                        || (hasAll && hasMe && !neg)
-                        || (hasAll && !hasMe)) {
-                    lr = getActiveLimit(limitConf->limits[i].res, limitConf->limits[i].nRes);
-                    if (lr) {
-                        cntMaxResLimit(lr, jp->uqPtr, hp);
-                        ret = checkIfLimitIsOk(lr,
-                                           LIMIT_CONSUMER_PER_USER,
-                                           jp->userName,
-                                           per_queue,
-                                           save_queue,
-                                           jp);
-                        if (!ret) {
-                            FREEUP(save_queue);
-                            FREEUP(save_project);
-                            FREEUP(save_host);
-                            FREEUP(save_user);
-                            FREEUP(save_user_def);
-                            return FALSE;
-                        }
-                    }
-                } else {
-                    goto clean4next;
-                }
-            }
+            if (! checkRuleLimit(rule, LIMIT_CONSUMER_PER_USER,
+                                 jp->userName, jp->uqPtr, jp, hp))
+                return FALSE;
         }
 
         /* check if project is allowed to use the queue/host */
-        if (project) {
-            hasMe = FALSE;
-            neg = FALSE;
-            hasAll = FALSE;
-
-            if (strstr(project, all) == project)
-                hasAll = TRUE;
-
-            while ((word = getNextWord_( &project)) != NULL) {
-                if (word[0] == '~') {
-                    neg = TRUE;
-                    word++;
-                }
-                if (strcasecmp(word, jp->shared->jobBill.projectName) == 0) {
-                    hasMe = TRUE;
-                    break;
-                }
-                neg = FALSE;
-            }
-
-             if ((!hasAll && hasMe)
-                    || (hasAll && hasMe && !neg)
-                    || (hasAll && !hasMe)) {
-                lr = getActiveLimit(limitConf->limits[i].res, limitConf->limits[i].nRes);
-                if (lr) {
-                    cntMaxResLimit(lr, jp->pqPtr, hp);
-                    ret = checkIfLimitIsOk(lr,
-                                       LIMIT_CONSUMER_PER_PROJECT,
-                                       jp->shared->jobBill.projectName,
-                                       per_queue,
-                                       save_queue,
-                                       jp);
-                    if (!ret) {
-                        FREEUP(save_queue);
-                        FREEUP(save_project);
-                        FREEUP(save_host);
-                        FREEUP(save_user);
-                        FREEUP(save_user_def);
-                        return FALSE;
-                    }
-                }
-            }else  {
-                goto clean4next;
-            }
-        }
+        if (rule->projects) {
 
-    clean4next:
-        FREEUP(save_queue);
-        FREEUP(save_project);
-        FREEUP(save_host);
-        FREEUP(save_user);
-        FREEUP(save_user_def);
-        queue = NULL;
-        project = NULL;
-        host = NULL;
-        user = NULL;
-        user_def = NULL;
-        hasMe = FALSE;
-        hasAll = FALSE;
-        neg = FALSE;
+            if (! ruleListMatch(rule->projects, rule->projNeg,
+                                rule->projAll, project))
+                continue;
+
+            if (! checkRuleLimit(rule, LIMIT_CONSUMER_PER_PROJECT,
+                                 projectName, jp->pqPtr, jp, hp))
+                return FALSE;
+        }
     }
 
     return TRUE;
 }
 
+/* checkRuleLimit()
+ */
+static int
+checkRuleLimit(struct limitRule *rule,
+               limitConsumerType_t ctype,
+               char *consumer,
+               struct resData *rp,
+               struct jData *jp,
+               struct hData *hp)
+{
+    struct limitRes *lr;
+
+    lr = getActiveLimit(rule->limit->res, rule->limit->nRes);
+    if (lr == NULL)
+        return TRUE;
+
+    cntMaxResLimit(lr, rp, hp);
+
+    return checkIfLimitIsOk(lr,
+                            ctype,
+                            consumer,
+                            rule->perQueue,
+                            rule,
+                            jp);
+}
+
 static void
 cntMaxResLimit(struct limitRes *lr,
                  struct resData *rp,
@@ -3339,7 +3522,7 @@ checkIfLimitIsOk(struct limitRes *limit,
                         limitConsumerType_t ctype,
                         char *consumer,
                         limitConsumerType_t qtype,
-                        char *queuelist,
+                        struct limitRule *rule,
                         struct jData *jp)
 {
     struct resData  *rPtr = NULL;
@@ -3367,7 +3550,7 @@ checkIfLimitIsOk(struct limitRes *limit,
         else
             used += cntConsumerSlots(ctype,
                                      consumer,
-                                     queuelist,
+                                     rule,
                                      TRUE);
         free = max
                - used
@@ -3382,7 +3565,7 @@ checkIfLimitIsOk(struct limitRes *limit,
         else
             used += cntConsumerSlots(ctype,
                                      consumer,
-                                     queuelist,
+                                     rule,
                                      FALSE);
         free = max - used - 1;
     }
@@ -3428,25 +3611,19 @@ getActiveLimit(struct limitRes *limits, int num)
 static int
 cntConsumerSlots(limitConsumerType_t type,
                        char* consumer,
-                       char* queuelist,
+                       struct limitRule *rule,
                        int slot)
 {
-    char    *queue;
-    char    *save_queue;
-    char    *word;
     int     used = 0;
+    int     i;
     struct qData *qp;
 
     if (!consumer)
         return 0;
 
-    if (queuelist != NULL) {
-        queue = strdup(queuelist);
-        save_queue = queue;
-        while ((word = getNextWord_ (&queue)) != NULL) {
-            used += cntQSlots(type, consumer, word, slot);
-        }
-        FREEUP(save_queue);
+    if (rule->queues != NULL) {
+        for (i = 0; i < rule->numQNames; i++)
+            used += cntQSlots(type, consumer, rule->qNames[i], slot);
     } else {
         /* queue not defiend in limit means all queues. */
         for (qp = qDataList->forw; qp != qDataList; qp = qp->forw) {
@@ -3518,11 +3695,11 @@ candHostOk (struct jData *jp, int indx, int *numAvailSlots,
     if (HOST_UNUSABLE_TO_JOB_DUE_TO_H_REASON(hReasonTb[1][hp->hData->hostId], jp)) {
         *hReason = hReasonTb[1][hp->hData->hostId];
     } else
-        if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(jp->qPtr->reasonTb[1][hp->hData->hostId], jp)) {
-            *hReason = jp->qPtr->reasonTb[1][hp->hData->hostId];
+        if (HOST_UNUSABLE_TO_JOB_DUE_TO_Q_H_REASON(getHReason(jp->qPtr->reasonTb[1], hp->hData->hostId), jp)) {
+            *hReason = getHReason(jp->qPtr->reasonTb[1], hp->hData->hostId);
         } else
-            if (HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(jp->uPtr->reasonTb[1][hp->hData->hostId], jp)) {
-                *hReason = jp->uPtr->reasonTb[1][hp->hData->hostId];
+            if (HOST_UNUSABLE_TO_JOB_DUE_TO_U_H_REASON(getHReason(jp->uPtr->reasonTb[1], hp->hData->hostId), jp)) {
+                *hReason = getHReason(jp->uPtr->reasonTb[1], hp->hData->hostId);
             }
 
     if ((*hReason) != 0) {
@@ -3612,7 +3789,7 @@ candHostOk (struct jData *jp, int indx, int *numAvailSlots,
     }
 
     if (!rtReason && !(*hReason)) {
-        if (jp->qPtr->reasonTb[1][hp->hData->hostId] ==
+        if (getHReason(jp->qPtr->reasonTb[1], hp->hData->hostId) ==
             PEND_HOST_ACCPT_ONE)
             *numAvailSlots = 0;
 
@@ -3634,7 +3811,7 @@ candHostOk (struct jData *jp, int indx, int *numAvailSlots,
              || rtReason == PEND_HOST_QUE_RUSAGE
              || rtReason == PEND_QUE_NO_SPAN) {
         *hReason = rtReason;
-        jp->qPtr->reasonTb[1][hp->hData->hostId] = rtReason;
+        setHReason(jp->qPtr->reasonTb[1], hp->hData->hostId, rtReason);
         if (!HAS_BACKFILL_POLICY) {
             jp->qPtr->numUsable -= hp->hData->numCPUs;
         }
@@ -3753,7 +3930,10 @@ dispatch_it (struct jData *jp)
 
     jp->dispTime = now_disp;
 
-    TIMEIT (2, (reply = start_job(jp, jp->qPtr, &jobReply)), "start_job");
+    if (benchSessions > 0)
+        reply = benchStartJob(jp, &jobReply);
+    else
+        TIMEIT (2, (reply = start_job(jp, jp->qPtr, &jobReply)), "start_job");
     INC_CNT(PROF_CNT_dispatchJob);
 
     jptr = jp;
@@ -4691,6 +4871,9 @@ jobStartTime (struct jData *jp)
     int needed, eligible;
     int tableSize, totalRunJobs = 0;
     struct leftTimeTable *jobTable;
+    int *numLeft;
+    int *seen;
+    int stamp;
 
     if (logclass & LC_SCHED)
         ls_syslog(LOG_DEBUG3, "%s: Determine the start time for job %s",
@@ -4707,34 +4890,55 @@ jobStartTime (struct jData *jp)
     jobTable  = my_calloc (tableSize,
                            sizeof(struct leftTimeTable), fname);
 
-    i = 0;
+    /* Number of running jobs to look at on each
+     * candidate host, the running jobs are then
+     * visited once instead of once per host.
+     */
+    numLeft = my_calloc(numofhosts() + 1, sizeof(int), fname);
+    seen = my_calloc(numofhosts() + 1, sizeof(int), fname);
+
+    num = 0;
     for (hPtr = (struct hData *)hostList->back;
          hPtr != (void *)hostList;
          hPtr = hPtr->back) {
 
-        if (!isCandHost(hPtr->host, jp))
+        if (hPtr->hostId > numofhosts()
+            || !isCandHost(hPtr->host, jp))
             continue;
 
-        num = hPtr->numJobs - hPtr->numRESERVE;
-        for (jpbw = jDataList[SJL]->back; num > 0 && jpbw != jDataList[SJL];
-             jpbw = jpbw->back) {
+        numLeft[hPtr->hostId] = hPtr->numJobs - hPtr->numRESERVE;
+        if (numLeft[hPtr->hostId] > 0)
+            num += numLeft[hPtr->hostId];
+    }
+
+    stamp = 0;
+    for (jpbw = jDataList[SJL]->back; num > 0 && jpbw != jDataList[SJL];
+         jpbw = jpbw->back) {
+
+        ++stamp;
+        for (i = 0; i < jpbw->numHostPtr; i++) {
             int k, numJobs;
             float runLimit;
 
+            hPtr = jpbw->hPtr[i];
+            if (hPtr->hostId > numofhosts()
+                || numLeft[hPtr->hostId] <= 0
+                || seen[hPtr->hostId] == stamp)
+                continue;
+            seen[hPtr->hostId] = stamp;
+
             numJobs = 0;
-            for (k = 0; k < jpbw->numHostPtr; k++) {
+            for (k = i; k < jpbw->numHostPtr; k++) {
                 if (hPtr == jpbw->hPtr[k])
                     numJobs++;
             }
 
-            if (numJobs == 0)
-                continue;
-
             if (totalRunJobs == tableSize) {
 
                 tableSize *= 2;
                 jobTable = realloc(jobTable, tableSize * sizeof(struct leftTimeTable));
             }
+            numLeft[hPtr->hostId]--;
             num--;
             if ((runLimit = RUN_LIMIT_OF_JOB(jpbw)) <= 0)
                 continue;
@@ -4759,6 +4963,9 @@ jobStartTime (struct jData *jp)
         }
     }
 
+    FREEUP(numLeft);
+    FREEUP(seen);
+
     if (eligible == 0) {
 
         FREEUP (jobTable);
@@ -4860,6 +5067,7 @@ scheduleAndDispatchJobs(void)
     bool_t has_ownership;
     static hTab *susp_jobs;
     hEnt *ent;
+    struct timeval t0;
     sTab stab;
 
     now_disp = time(NULL);
@@ -4902,11 +5110,7 @@ scheduleAndDispatchJobs(void)
             struct uData *up = (struct uData *) hashEntryPtr->hData;
 
             hashEntryPtr = h_nextEnt_(&hashSearchPtr);
-            for (i = 0; i <= numofhosts(); i++) {
-                if (!OUT_SCHED_RS(up->reasonTb[1][i])) {
-                    up->reasonTb[1][i] = 0;
-                }
-            }
+            keepOutSchedReasons(up->reasonTb[1]);
             empty_udata_jref(up);
         }
 
@@ -4980,7 +5184,9 @@ scheduleAndDispatchJobs(void)
                 lastSharedResourceUpdateTime = now_disp;
             }
 
+            gettimeofday(&t0, NULL);
             TIMEIT(0, returnCode = getLsbHostLoad(), "getLsbHostLoad()");
+            perfPhase(PERF_LOAD, &t0);
             if (returnCode != 0) {
                 ls_syslog(LOG_ERR, "\
 %s: ohmygosh failed to get the load of hosts, cannot schedule", __func__);
@@ -5183,7 +5389,9 @@ scheduleAndDispatchJobs(void)
         ++loopCount;
         TIMEVAL(0, scheduleAJob(jPtr, TRUE, TRUE), tmpVal);
 
+        gettimeofday(&t0, NULL);
         XORDispatch(jPtr, FALSE, dispatchAJob0);
+        perfPhase(PERF_DISPATCH, &t0);
         if (STAY_TOO_LONG) {
             if (logclass & LC_SCHED) {
                 ls_syslog(LOG_INFO, "\
@@ -5210,7 +5418,9 @@ scheduleAndDispatchJobs(void)
             }
             while ((jPtr = jiter_next_job2(jRefList))) {
                 TIMEVAL(0, scheduleAJob(jPtr, TRUE, TRUE), tmpVal);
+                gettimeofday(&t0, NULL);
                 dispatchAJob0(jPtr, false);
+                perfPhase(PERF_DISPATCH, &t0);
             }
         }
     }
@@ -5536,6 +5746,7 @@ scheduleAJob(struct jData *jp, bool_t checkReady, bool_t checkOtherGroup)
 {
     int ret;
     int tmpVal = 0;
+    struct timeval t0;
 
     if (logclass & LC_SCHED) {
         ls_syslog(LOG_INFO, "\
@@ -5575,8 +5786,10 @@ scheduleAJob(struct jData *jp, bool_t checkReady, bool_t checkOtherGroup)
             ret = checkIfCandHostIsOk(jp);
         }
     } else {
+        gettimeofday(&t0, NULL);
         TIMEVAL(2, ret = getCandHosts(jp), tmpVal);
         timeGetCandHosts += tmpVal;
+        perfPhase(PERF_CANDIDATES, &t0);
         if (logclass & (LC_SCHED | LC_PEND)) {
 
             ls_syslog(LOG_DEBUG2, "\
@@ -5797,6 +6010,7 @@ checkIfCandHostIsOk(struct jData *jp)
     int svReason = jp->newReason;
     int i;
 
+    reasonIndexOn(jp);
     for (i = 0; i < jp->numCandPtr; i++) {
 
         nSlots = candHostOk(jp, i, &nAvailSlots, &hReason);
@@ -5830,6 +6044,8 @@ checkIfCandHostIsOk(struct jData *jp)
                       jp->candPtr[i].numAvailSlots);
         }
     }
+    reasonIndexOff();
+
     if (numTotalSlots) {
         return CAND_HOST_FOUND;
     } else {
@@ -5842,6 +6058,7 @@ getNumSlots(struct jData *jp)
 {
     int i, numSlots = 0, numAvailSlots = 0;
 
+    reasonIndexOn(jp);
     for (i = 0; i < jp->numCandPtr; i++) {
 
         jp->candPtr[i].numSlots = MIN(jp->candPtr[i].numSlots,
@@ -5879,6 +6096,8 @@ getNumSlots(struct jData *jp)
             numAvailSlots += jp->candPtr[i].numAvailSlots;
         }
     }
+    reasonIndexOff();
+
     jp->numSlots = MIN(jp->numSlots, numSlots);
     jp->numAvailSlots = MIN(jp->numAvailSlots, numAvailSlots);
 }
@@ -6728,17 +6947,42 @@ copyReason(void)
     for (qp = qDataList->forw; qp != qDataList; qp = qp->forw) {
         if (qp->reasonTb == NULL)
             continue;
-        memcpy(qp->reasonTb[0], qp->reasonTb[1], cc * sizeof(int));
+        copyHReasons(qp->reasonTb[0], qp->reasonTb[1]);
     }
 
     e = h_firstEnt_(&uDataList, &stab);
     while (e) {
         struct uData *up = e->hData;
-        memcpy(up->reasonTb[0], up->reasonTb[1], cc * sizeof(int));
+        copyHReasons(up->reasonTb[0], up->reasonTb[1]);
         e = h_nextEnt_(&stab);
     }
 }
 
+/* keepOutSchedReasons()
+ * Clear the host reasons of a user at the beginning of
+ * a session except the out of schedule ones, only the
+ * hosts that have a reason are visited.
+ */
+static void
+keepOutSchedReasons(struct hReasons *tb)
+{
+    int keep;
+    int i;
+
+    keep = 0;
+    for (i = 0; i < tb->size; i++) {
+        if (tb->ents[i].gen != tb->gen)
+            continue;
+        if (OUT_SCHED_RS(tb->ents[i].reason))
+            keep++;
+        else
+            tb->ents[i].reason = 0;
+    }
+
+    if (keep == 0)
+        clearHReasons(tb);
+}
+
 static void
 clearJobReason(void)
 {
@@ -6750,9 +6994,9 @@ clearJobReason(void)
             for (jp = jDataList[i]->back; jp != jDataList[i]; jp = jp->back) {
 
                 if (jp->jFlags & JFLAG_READY2) {
-                    if (jp->qPtr->reasonTb[1][0]) {
+                    if (getHReason(jp->qPtr->reasonTb[1], 0)) {
 
-                        jp->newReason = jp->qPtr->reasonTb[1][0];
+                        jp->newReason = getHReason(jp->qPtr->reasonTb[1], 0);
                     } else {
                         jp->newReason = 0;
                     }
@@ -6858,8 +7102,8 @@ setExecHostsAcceptInterval(struct jData* jp)
             if ((jp->qPtr->acceptIntvl > 0
                  || jp->hPtr[i]->numDispJobs >= maxJobPerSession )) {
 
-                if (OUT_SCHED_RS(qp->reasonTb[1][hostId]) == FALSE) {
-                    qp->reasonTb[1][hostId] = PEND_HOST_ACCPT_ONE;
+                if (OUT_SCHED_RS(getHReason(qp->reasonTb[1], hostId)) == FALSE) {
+                    setHReason(qp->reasonTb[1], hostId, PEND_HOST_ACCPT_ONE);
                 }
 
                 qp->numUsable--;
@@ -6869,7 +7113,7 @@ setExecHostsAcceptInterval(struct jData* jp)
                 ls_syslog(LOG_DEBUG2,"\
 %s: qp->reasonTb[1][%s/%d]=%d qp->numUsable=%d",
                           fname, jp->hPtr[i]->host, hostId,
-                          qp->reasonTb[1][hostId], qp->numUsable);
+                          getHReason(qp->reasonTb[1], hostId), qp->numUsable);
             }
         }
     }
@@ -7741,26 +7985,67 @@ setLsbPtilePack(const bool_t x)
 }
 
 /* update_udate_jref()
+ * Add the job to the references of its user in
+ * its queue, the lists are in dispatch order.
  */
 static void
 update_udata_jref(struct jRef *jref)
 {
     struct uData *uPtr;
     hEnt *ent;
+    int new;
 
     ent = h_getEnt_(&uDataList, jref->job->userName);
     uPtr = ent->hData;
-    dlink_insert(uPtr->jobs, jref);
+
+    if (uPtr->qJobs == NULL) {
+        uPtr->qJobs = my_malloc(sizeof(hTab), __func__);
+        h_initTab_(uPtr->qJobs, 4);
+    }
+
+    ent = h_addEnt_(uPtr->qJobs, jref->job->qPtr->queue, &new);
+    if (new)
+        ent->hData = dlink_make();
+    dlink_insert(ent->hData, jref);
 }
 
 /* empty_jdata_jref()
+ * Empty the lists but keep them for the
+ * next session.
  */
 static void
 empty_udata_jref(struct uData *uPtr)
 {
-    while ((dlink_pop(uPtr->jobs)))
-        ;
-    assert(uPtr->jobs->num == 0);
+    struct dlink *jobs;
+    sTab stab;
+    hEnt *ent;
+
+    if (uPtr->qJobs == NULL)
+        return;
+
+    ent = h_firstEnt_(uPtr->qJobs, &stab);
+    while (ent) {
+        jobs = ent->hData;
+        while ((dlink_pop(jobs)))
+            ;
+        assert(jobs->num == 0);
+        ent = h_nextEnt_(&stab);
+    }
+}
+
+/* free_udata_jref()
+ * Free the per queue lists of a user going away,
+ * the job references belong to the session.
+ */
+void
+free_udata_jref(struct uData *uPtr)
+{
+    if (uPtr->qJobs == NULL)
+        return;
+
+    empty_udata_jref(uPtr);
+    h_freeTab_(uPtr->qJobs, NULL);
+    FREEUP(uPtr->qJobs);
 }
 
 /* handle_reserve_memory()
@@ -33,6 +33,10 @@ extern bool_t xdr_resourceInfoReq(XDR *, struct resourceInfoReq *,
                                   struct LSFHeader *);
 static int packJgrpInfo(struct jgTreeNode *, int, char **, int, int);
 static int packJobInfo(struct jData *, int, char **, int, int, int);
+static int writeJobInfoPack(int, struct nodeList *, int, int, int, int);
+static bool_t xdr_jobInfoHeadPack(XDR *, struct jobInfoHead *,
+                                  struct LSFHeader *);
+static void clearJobBillPaths(struct submitReq *);
 static void initSubmit(int *, struct submitReq *, struct submitMbdReply *);
 static int sendBack(int, struct submitReq *, struct submitMbdReply *, int);
 static void addPendSigEvent(struct sbdNode *);
@@ -131,6 +135,139 @@ sendback:
     return 0;
 }
 
+/* do_submitPackReq()
+ *
+ * A pack of submissions from lsb_submit_batch(). The body is
+ * the number of jobs followed by their submitReq, the job files
+ * follow the request in the same order. The jobs are admitted
+ * one by one as by do_submitReq(), their events are flushed to
+ * lsb.events together and the reply carries the outcome of each.
+ */
+int
+do_submitPackReq(XDR *xdrs,
+                 int chfd,
+                 struct sockaddr_in *from,
+                 char *hostName,
+                 struct LSFHeader *reqHdr,
+                 struct sockaddr_in *laddr,
+                 struct lsfAuth *auth,
+                 int *schedule,
+                 int dispatch,
+                 struct jData **jobData)
+{
+    static struct submitMbdReply submitReply;
+    static int first = true;
+    static struct submitReq subReq;
+    struct submitPackReply packReply;
+    struct submitMbdReply *r;
+    struct LSFHeader replyHdr;
+    struct jData *jp;
+    char *reply_buf;
+    XDR xdrs2;
+    int reply;
+    int size;
+    int num;
+    int i;
+
+    if (logclass & (LC_TRACE | LC_EXEC | LC_COMM))
+        ls_syslog(LOG_DEBUG, "\
+%s: Entering this routine...; host %s, socket %d",
+                  __func__, hostName, chanSock_(chfd));
+
+    if (!xdr_int(xdrs, &num)
+        || num <= 0
+        || num > SUB_PACK_MAX) {
+        ls_syslog(LOG_ERR, "%s: bad pack of %d jobs from %s",
+                  __func__, num, hostName);
+        sendLSFHeader(chfd, LSBE_XDR);
+        return -1;
+    }
+
+    packReply.numJobs = num;
+    packReply.errs = my_calloc(num, sizeof(int), __func__);
+    packReply.replies = my_calloc(num, sizeof(struct submitMbdReply),
+                                  __func__);
+
+    beginEventGroup();
+
+    size = LSF_HEADER_LEN + NET_INTSIZE_;
+    for (i = 0; i < num; i++) {
+
+        r = &packReply.replies[i];
+        initSubmit(&first, &subReq, &submitReply);
+
+        /* The remaining job files cannot be told apart
+         * from the requests anymore.
+         */
+        if (!xdr_submitReq(xdrs, &subReq, reqHdr)) {
+            ls_syslog(LOG_ERR, I18N_FUNC_FAIL, __func__, "xdr_submitReq");
+            for (; i < num; i++) {
+                packReply.errs[i] = LSBE_XDR;
+                packReply.replies[i].queue = safeSave("");
+                packReply.replies[i].badJobName = safeSave("");
+                size += 4 * NET_INTSIZE_ + 2 * (NET_INTSIZE_ + 4);
+            }
+            break;
+        }
+
+        if (!(subReq.options & SUB_RLIMIT_UNIT_IS_KB))
+            convertRLimit(subReq.rLimits, 1);
+
+        jp = NULL;
+        reply = newJob(&subReq,
+                       &submitReply,
+                       chfd,
+                       auth,
+                       schedule,
+                       dispatch,
+                       &jp);
+        if (reply == LSBE_NO_ERROR && jp != NULL)
+            *jobData = jp;
+
+        if (subReq.nxf > 0)
+            FREEUP(subReq.xf);
+
+        packReply.errs[i] = reply;
+        r->jobId = submitReply.jobId;
+        r->badReqIndx = submitReply.badReqIndx;
+        r->queue = safeSave(submitReply.queue ? submitReply.queue : "");
+        r->badJobName = safeSave(submitReply.badJobName);
+        size += 4 * NET_INTSIZE_
+            + NET_INTSIZE_ + RNDUP(strlen(r->queue))
+            + NET_INTSIZE_ + RNDUP(strlen(r->badJobName));
+    }
+
+    /* Jobs are acknowledged once their
+     * events are out.
+     */
+    if (endEventGroup() < 0)
+        mbdDie(MASTER_FATAL);
+
+    reply_buf = my_malloc(size, __func__);
+    xdrmem_create(&xdrs2, reply_buf, size, XDR_ENCODE);
+    initLSFHeader_(&replyHdr);
+    replyHdr.opCode = LSBE_NO_ERROR;
+    if (!xdr_encodeMsg(&xdrs2, (char *)&packReply, &replyHdr,
+                       xdr_submitPackReply, 0, NULL)) {
+        ls_syslog(LOG_ERR, I18N_FUNC_FAIL, __func__, "xdr_encodeMsg");
+        xdr_destroy(&xdrs2);
+        FREEUP(reply_buf);
+        freeSubmitPackReply(&packReply);
+        return -1;
+    }
+
+    if (chanWrite_(chfd, reply_buf, XDR_GETPOS(&xdrs2))
+        != XDR_GETPOS(&xdrs2))
+        ls_syslog(LOG_ERR, I18N_FUNC_D_FAIL_M, __func__, "chanWrite_",
+                  XDR_GETPOS(&xdrs2));
+
+    xdr_destroy(&xdrs2);
+    FREEUP(reply_buf);
+    freeSubmitPackReply(&packReply);
+
+    return 0;
+}
+
 int
 checkUseSelectJgrps(struct LSFHeader *reqHdr, struct jobInfoReq *req)
 {
@@ -247,10 +384,13 @@ do_jobInfoReq(XDR *xdrs,
 
     reply_buf = calloc(len, sizeof(char));
     xdrmem_create(&xdrs2, reply_buf, len, XDR_ENCODE);
+    initLSFHeader_(&replyHdr);
     replyHdr.opCode = reply;
 
     if (!xdr_encodeMsg(&xdrs2, (char *) &jobInfoHead, &replyHdr,
-                       xdr_jobInfoHead, 0, NULL)) {
+                       (reply == LSBE_NO_ERROR
+                        && (jobInfoReq.options & JOBINFO_PACK)) ?
+                       xdr_jobInfoHeadPack : xdr_jobInfoHead, 0, NULL)) {
         FREEUP (reply_buf);
         freeJobHead (&jobInfoHead);
         ls_syslog(LOG_ERR, I18N_FUNC_S_FAIL, __func__,
@@ -280,6 +420,17 @@ do_jobInfoReq(XDR *xdrs,
         return 0;
     }
 
+    if (jobInfoReq.options & JOBINFO_PACK) {
+        if (writeJobInfoPack(chfd, jgrplist, listSize, schedule,
+                             jobInfoReq.options, reqHdr->version) < 0) {
+            FREEUP(jgrplist);
+            return -1;
+        }
+        FREEUP(jgrplist);
+        chanClose_(chfd);
+        return 0;
+    }
+
     for (i = 0; i < listSize; i++) {
         if (jgrplist[i].isJData &&
             ((len = packJobInfo((struct jData *)jgrplist[i].info,
@@ -314,6 +465,135 @@ do_jobInfoReq(XDR *xdrs,
     return 0;
 }
 
+/* xdr_jobInfoHeadPack()
+ * The job information head followed by a flag telling
+ * the client the jobs come packed. Servers not packing
+ * never send it so the client cannot mistake their
+ * per job messages for packs.
+ */
+static bool_t
+xdr_jobInfoHeadPack(XDR *xdrs,
+                    struct jobInfoHead *jobInfoHead,
+                    struct LSFHeader *hdr)
+{
+    int packed;
+
+    packed = TRUE;
+    if (!xdr_jobInfoHead(xdrs, jobInfoHead, hdr)
+        || !xdr_int(xdrs, &packed))
+        return FALSE;
+
+    return TRUE;
+}
+
+/* writeJobInfoPack()
+ * Send the job information as a sequence of messages each
+ * one carrying many jobs. Each job is encoded exactly as
+ * packJobInfo() does, the message body is the number of
+ * jobs followed by the length and the body of each job.
+ * The reserved field of the message header is the number
+ * of jobs remaining after the last one in the message.
+ */
+static int
+writeJobInfoPack(int chfd,
+                 struct nodeList *jgrplist,
+                 int listSize,
+                 int schedule,
+                 int options,
+                 int version)
+{
+    struct LSFHeader hdr;
+    XDR xdrs;
+    char *pack;
+    char *buf;
+    int size;
+    int pos;
+    int num;
+    int len;
+    int blen;
+    int i;
+
+    size = JOBINFO_PACK_SIZE;
+    pack = my_malloc(size, __func__);
+    if (pack == NULL) {
+        ls_syslog(LOG_ERR, "%s: malloc() failed: %m", __func__);
+        return -1;
+    }
+    pos = LSF_HEADER_LEN + NET_INTSIZE_;
+    num = 0;
+
+    for (i = 0; i < listSize; i++) {
+
+        if (jgrplist[i].isJData)
+            len = packJobInfo((struct jData *)jgrplist[i].info,
+                              listSize - 1 - i, &buf, schedule,
+                              options, version);
+        else
+            len = packJgrpInfo((struct jgTreeNode *)jgrplist[i].info,
+                               listSize - 1 - i,
+                               &buf, schedule, version);
+        if (len < 0) {
+            ls_syslog(LOG_ERR, "%s: packJobInfo() failed: %m", __func__);
+            FREEUP(pack);
+            return -1;
+        }
+
+        blen = len - LSF_HEADER_LEN;
+        if (pos + NET_INTSIZE_ + RNDUP(blen) > size) {
+            char *p;
+
+            size = 2 * (pos + NET_INTSIZE_ + RNDUP(blen));
+            p = realloc(pack, size);
+            if (p == NULL) {
+                ls_syslog(LOG_ERR, "%s: realloc() failed: %m", __func__);
+                FREEUP(buf);
+                FREEUP(pack);
+                return -1;
+            }
+            pack = p;
+        }
+
+        *(int *)(pack + pos) = htonl(blen);
+        memset(pack + pos + NET_INTSIZE_ + blen, 0, RNDUP(blen) - blen);
+        memcpy(pack + pos + NET_INTSIZE_, buf + LSF_HEADER_LEN, blen);
+        pos += NET_INTSIZE_ + RNDUP(blen);
+        ++num;
+        FREEUP(buf);
+
+        if (pos < JOBINFO_PACK_SIZE
+            && i < listSize - 1)
+            continue;
+
+        initLSFHeader_(&hdr);
+        hdr.opCode = BATCH_JOB_INFO;
+        hdr.version = OPENLAVA_XDR_VERSION;
+        hdr.reserved = listSize - 1 - i;
+        hdr.length = pos - LSF_HEADER_LEN;
+
+        xdrmem_create(&xdrs, pack, LSF_HEADER_LEN + NET_INTSIZE_, XDR_ENCODE);
+        if (!xdr_LSFHeader(&xdrs, &hdr)
+            || !xdr_int(&xdrs, &num)) {
+            ls_syslog(LOG_ERR, "%s: xdr_LSFHeader() failed", __func__);
+            xdr_destroy(&xdrs);
+            FREEUP(pack);
+            return -1;
+        }
+        xdr_destroy(&xdrs);
+
+        if (chanWrite_(chfd, pack, pos) != pos) {
+            ls_syslog(LOG_ERR, "%s: chanWrite_() failed: %m", __func__);
+            FREEUP(pack);
+            return -1;
+        }
+
+        pos = LSF_HEADER_LEN + NET_INTSIZE_;
+        num = 0;
+    }
+
+    FREEUP(pack);
+    return 0;
+}
+
 static int
 packJgrpInfo(struct jgTreeNode * jgNode,
              int remain,
@@ -363,6 +643,7 @@ packJgrpInfo(struct jgTreeNode * jgNode,
 
     request_buf = (char *) my_malloc(len, "packJgrpInfo");
     xdrmem_create(&xdrs, request_buf, len, XDR_ENCODE);
+    initLSFHeader_(&hdr);
     hdr.reserved = remain;
     hdr.version = version;
 
@@ -452,8 +733,8 @@ packJobInfo(struct jData *jobData,
     int len;
     int svReason;
     int *pkHReasonTb;
-    int *pkQReasonTb;
-    int *pkUReasonTb;
+    struct hReasons *pkQReasonTb;
+    struct hReasons *pkUReasonTb;
     float *loadSched = NULL;
     float *loadStop = NULL;
     float *cpuFactor;
@@ -548,7 +829,7 @@ packJobInfo(struct jData *jobData,
                 if (jReasonTb[i] == PEND_HOST_USR_SPEC)
                     continue;
 
-                if (pkQReasonTb[i] == PEND_HOST_QUE_MEMB)
+                if (getHReason(pkQReasonTb, i) == PEND_HOST_QUE_MEMB)
                     continue;
 
                 if (!isHostQMember(hPtr, jobData->qPtr))
@@ -561,15 +842,15 @@ packJobInfo(struct jData *jobData,
                     continue;
                 }
 
-                if (pkQReasonTb[i]) {
-                    jobInfoReply.reasonTb[k] = pkQReasonTb[i];
+                if (getHReason(pkQReasonTb, i)) {
+                    jobInfoReply.reasonTb[k] = getHReason(pkQReasonTb, i);
                     PUT_HIGH(jobInfoReply.reasonTb[k], i);
                     k++;
                     continue;
                 }
 
-                if (pkUReasonTb[i]) {
-                    jobInfoReply.reasonTb[k] = pkUReasonTb[i];
+                if (getHReason(pkUReasonTb, i)) {
+                    jobInfoReply.reasonTb[k] = getHReason(pkUReasonTb, i);
                     PUT_HIGH(jobInfoReply.reasonTb[k], i);
                     k++;
                     continue;
@@ -595,6 +876,8 @@ packJobInfo(struct jData *jobData,
     }
 
     jobInfoReply.nIdx = allLsInfo->numIndx;
+    if (options & JOBINFO_NO_LOAD)
+        jobInfoReply.nIdx = 0;
     if (!loadSched) {
 
         loadSched = calloc(allLsInfo->numIndx, sizeof(float *));
@@ -636,6 +919,11 @@ packJobInfo(struct jData *jobData,
     else
         jobInfoReply.execUsername = jobData->execUsername;
 
+    if (options & JOBINFO_NO_PATHS) {
+        jobInfoReply.execHome = "";
+        jobInfoReply.execCwd = "";
+    }
+
     jobInfoReply.reserveTime = jobData->reserveTime;
     jobInfoReply.jobPid = jobData->jobPid;
     jobInfoReply.port = jobData->port;
@@ -651,6 +939,9 @@ packJobInfo(struct jData *jobData,
         jobInfoReply.jobBill->maxNumProcessors = 1;
     }
 
+    if (options & JOBINFO_NO_PATHS)
+        clearJobBillPaths(jobInfoReply.jobBill);
+
     if (jobInfoReply.jobBill->jobName)
         FREEUP(jobInfoReply.jobBill->jobName);
     fullJobName_r(jobData, fullName);
@@ -724,6 +1015,7 @@ packJobInfo(struct jData *jobData,
     FREEUP (request_buf);
     request_buf = my_malloc(len, "packJobInfo");
     xdrmem_create(&xdrs, request_buf, len, XDR_ENCODE);
+    initLSFHeader_(&hdr);
     hdr.reserved = remain;
     hdr.version = version;
 
@@ -756,6 +1048,33 @@ packJobInfo(struct jData *jobData,
     return i;
 }
 
+/* clearJobBillPaths()
+ * Replace the file and directory names of the job
+ * with empty strings, the caller did not ask for them.
+ */
+static void
+clearJobBillPaths(struct submitReq *jobBill)
+{
+    FREEUP(jobBill->inFile);
+    jobBill->inFile = safeSave("");
+    FREEUP(jobBill->outFile);
+    jobBill->outFile = safeSave("");
+    FREEUP(jobBill->errFile);
+    jobBill->errFile = safeSave("");
+    FREEUP(jobBill->inFileSpool);
+    jobBill->inFileSpool = safeSave("");
+    FREEUP(jobBill->commandSpool);
+    jobBill->commandSpool = safeSave("");
+    FREEUP(jobBill->chkpntDir);
+    jobBill->chkpntDir = safeSave("");
+    FREEUP(jobBill->jobFile);
+    jobBill->jobFile = safeSave("");
+    FREEUP(jobBill->cwd);
+    jobBill->cwd = safeSave("");
+    FREEUP(jobBill->subHomeDir);
+    jobBill->subHomeDir = safeSave("");
+}
+
 int
 do_jobPeekReq(XDR *xdrs, int chfd, struct sockaddr_in *from, char *hostName,
               struct LSFHeader *reqHdr, struct lsfAuth *auth)
@@ -1264,6 +1583,7 @@ do_restartReq(XDR * xdrs, int chfd, struct sockaddr_in * from,
         return -1;
     }
     hStatChange(hData, 0);
+    sbdJobFileCache(hData, reqHdr->reserved, TRUE);
 
     if ((sbdPackage.numJobs = countNumSpecs(hData)) > 0)
         sbdPackage.jobs = my_calloc(sbdPackage.numJobs,
@@ -2231,6 +2551,8 @@ doProbeReply(struct sbdNode *sbdPtr, int exception)
         goto hout;
     }
 
+    sbdJobFileCache(sbdPtr->hData, replyHdr.reserved, FALSE);
+
     if (replyHdr.opCode != ERR_NO_ERROR) {
         ls_syslog(LOG_ERR, "\
 %s: sbatchd replied %d from host %s",
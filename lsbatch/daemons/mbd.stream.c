@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "mbd.h"
+
+/* Event stream.
+ *
+ * With MBD_EVENT_RING=<records> in lsf.conf mbatchd keeps the
+ * last records it wrote to lsb.events, in the lsb.events format,
+ * in a ring numbered from its start. A client sending
+ * BATCH_EVENT_STREAM gives the epoch and the number of the next
+ * record it wants and the event types it is interested in,
+ * mbatchd replays what the ring still has and keeps sending the
+ * records as they are logged.
+ *
+ * Logging a record only copies it in the ring, the subscribers
+ * are fed from the main loop by eventStreamFlush() whenever
+ * their channel has nothing left to send. A subscriber slower
+ * than the ring skips the records that were overwritten, it
+ * sees the hole in the numbering.
+ */
+
+struct streamRec {
+    LS_LONG_INT seq;
+    int type;
+    char *line;
+    int len;
+};
+
+/* Bytes sent to a subscriber at once.
+ */
+#define STREAM_BATCH (64 * 1024)
+
+static struct streamRec *ring;
+static int ringSize;
+static LS_LONG_INT nextSeq;
+static time_t epoch;
+static struct clientNode **streams;
+static int numStreams;
+static int maxStreams;
+
+static LS_LONG_INT firstSeq(void);
+static void streamFeed(struct clientNode *);
+static int streamWants(struct clientNode *, int);
+
+/* eventStreamInit()
+ */
+void
+eventStreamInit(void)
+{
+    char *p;
+
+    if (ring)
+        return;
+
+    epoch = time(NULL);
+    nextSeq = 1;
+
+    p = daemonParams[MBD_EVENT_RING].paramValue;
+    if (p == NULL)
+        return;
+
+    if (! isint_(p)
+        || atoi(p) <= 0) {
+        ls_syslog(LOG_ERR, "\
+%s: invalid MBD_EVENT_RING %s, event stream disabled", __func__, p);
+        return;
+    }
+
+    ringSize = atoi(p);
+    ring = my_calloc(ringSize, sizeof(struct streamRec), __func__);
+
+    ls_syslog(LOG_INFO, "\
+%s: event stream ring of %d records", __func__, ringSize);
+}
+
+/* eventStreamPut()
+ * Copy a record written to lsb.events in the ring.
+ */
+void
+eventStreamPut(struct eventRec *log)
+{
+    struct streamRec *r;
+    char *line;
+    size_t len;
+    FILE *fp;
+
+    if (ringSize == 0)
+        return;
+
+    fp = open_memstream(&line, &len);
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "%s: open_memstream() failed %m", __func__);
+        return;
+    }
+
+    if (lsb_puteventrec(fp, log) < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: lsb_puteventrec() failed %s", __func__, lsb_sysmsg());
+        fclose(fp);
+        free(line);
+        return;
+    }
+    fclose(fp);
+
+    r = &ring[nextSeq % ringSize];
+    FREEUP(r->line);
+    r->seq = nextSeq;
+    r->type = log->type;
+    r->line = line;
+    r->len = len;
+
+    ++nextSeq;
+}
+
+/* do_eventStream()
+ * Subscribe the client to the event stream.
+ */
+int
+do_eventStream(XDR *xdrs, struct clientNode *client, struct LSFHeader *hdr)
+{
+    struct eventStreamReq req;
+    struct eventStreamReply reply;
+    struct LSFHeader hdr2;
+    char buf[MSGSIZE/8];
+    XDR xdrs2;
+    int i;
+
+    if (! xdr_eventStreamReq(xdrs, &req, hdr)) {
+        ls_syslog(LOG_ERR, "\
+%s: xdr_eventStreamReq() failed for host %s", __func__, client->fromHost);
+        errorBack(client->chanfd, LSBE_XDR, &client->from);
+        return -1;
+    }
+
+    if (ringSize == 0) {
+        errorBack(client->chanfd, LSBE_NO_STREAM, &client->from);
+        return -1;
+    }
+
+    reply.epoch = epoch;
+    reply.first = firstSeq();
+
+    if (req.seq <= 0)
+        reply.seq = nextSeq;
+    else if (req.epoch != epoch
+             || req.seq < reply.first)
+        reply.seq = reply.first;
+    else if (req.seq > nextSeq)
+        reply.seq = nextSeq;
+    else
+        reply.seq = req.seq;
+
+    client->streamSeq = reply.seq;
+    client->streamMask[0] = req.mask[0];
+    client->streamMask[1] = req.mask[1];
+
+    for (i = 0; i < numStreams; i++) {
+        if (streams[i] == client)
+            break;
+    }
+
+    if (i == numStreams) {
+
+        if (numStreams == maxStreams) {
+            struct clientNode **p;
+
+            p = realloc(streams,
+                        (2 * maxStreams + 4) * sizeof(struct clientNode *));
+            if (p == NULL) {
+                ls_syslog(LOG_ERR, "%s: realloc() failed %m", __func__);
+                errorBack(client->chanfd, LSBE_NO_MEM, &client->from);
+                return -1;
+            }
+            streams = p;
+            maxStreams = 2 * maxStreams + 4;
+        }
+        streams[numStreams] = client;
+        ++numStreams;
+    }
+
+    initLSFHeader_(&hdr2);
+    hdr2.opCode = LSBE_NO_ERROR;
+
+    xdrmem_create(&xdrs2, buf, sizeof(buf), XDR_ENCODE);
+    if (! xdr_encodeMsg(&xdrs2,
+                        (char *)&reply,
+                        &hdr2,
+                        xdr_eventStreamReply,
+                        0,
+                        NULL)) {
+        ls_syslog(LOG_ERR, "%s: xdr_encodeMsg() failed", __func__);
+        xdr_destroy(&xdrs2);
+        return -1;
+    }
+
+    if (chanWrite_(client->chanfd, buf, XDR_GETPOS(&xdrs2)) < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: chanWrite_() failed for host %s %M", __func__, client->fromHost);
+        xdr_destroy(&xdrs2);
+        return -1;
+    }
+    xdr_destroy(&xdrs2);
+
+    /* From now on we only enqueue to the client.
+     */
+    io_nonblock_(chanSock_(client->chanfd));
+
+    ls_syslog(LOG_DEBUG, "\
+%s: host %s subscribed to the event stream at %lld", __func__,
+              client->fromHost, (long long)reply.seq);
+
+    return 0;
+}
+
+/* eventStreamClear()
+ * Remove the client from the subscribers.
+ */
+void
+eventStreamClear(struct clientNode *client)
+{
+    int i;
+
+    for (i = 0; i < numStreams; i++) {
+        if (streams[i] == client) {
+            streams[i] = streams[numStreams - 1];
+            --numStreams;
+            return;
+        }
+    }
+}
+
+/* eventStreamFlush()
+ * Feed the subscribers having sent
+ * everything they were given.
+ */
+void
+eventStreamFlush(void)
+{
+    int i;
+
+    for (i = 0; i < numStreams; i++) {
+
+        if (streams[i]->streamSeq >= nextSeq
+            || chanSendQueued_(streams[i]->chanfd) != 0)
+            continue;
+
+        streamFeed(streams[i]);
+    }
+}
+
+/* firstSeq()
+ * The oldest record in the ring.
+ */
+static LS_LONG_INT
+firstSeq(void)
+{
+    if (nextSeq - ringSize < 1)
+        return 1;
+
+    return nextSeq - ringSize;
+}
+
+/* streamFeed()
+ * Enqueue up to STREAM_BATCH bytes of
+ * records to the client in one buffer.
+ */
+static void
+streamFeed(struct clientNode *client)
+{
+    struct eventStreamRec rec;
+    struct LSFHeader hdr;
+    struct streamRec *r;
+    struct Buffer *buf;
+    LS_LONG_INT seq;
+    LS_LONG_INT last;
+    XDR xdrs;
+    int size;
+    int pos;
+
+    seq = client->streamSeq;
+    if (seq < firstSeq())
+        seq = firstSeq();
+
+    /* Size the buffer for the records to send, every
+     * record is a header, the seq and the line.
+     */
+    size = 0;
+    for (last = seq; last < nextSeq && size < STREAM_BATCH; last++) {
+        r = &ring[last % ringSize];
+        if (streamWants(client, r->type))
+            size += sizeof(struct LSFHeader) + 3 * NET_INTSIZE_ + r->len + 4;
+    }
+
+    if (size == 0) {
+        client->streamSeq = last;
+        return;
+    }
+
+    if (chanAllocBuf_(&buf, size) < 0) {
+        ls_syslog(LOG_ERR, "%s: chanAllocBuf_() failed", __func__);
+        return;
+    }
+
+    pos = 0;
+    for (; seq < last; seq++) {
+
+        r = &ring[seq % ringSize];
+        if (! streamWants(client, r->type))
+            continue;
+
+        rec.seq = r->seq;
+        rec.line = r->line;
+
+        initLSFHeader_(&hdr);
+        hdr.opCode = LSBE_NO_ERROR;
+
+        xdrmem_create(&xdrs, buf->data + pos, size - pos, XDR_ENCODE);
+        if (! xdr_encodeMsg(&xdrs,
+                            (char *)&rec,
+                            &hdr,
+                            xdr_eventStreamRec,
+                            0,
+                            NULL)) {
+            ls_syslog(LOG_ERR, "\
+%s: xdr_encodeMsg() failed for record %lld", __func__, (long long)rec.seq);
+            xdr_destroy(&xdrs);
+            continue;
+        }
+        pos += XDR_GETPOS(&xdrs);
+        xdr_destroy(&xdrs);
+    }
+
+    client->streamSeq = seq;
+
+    if (pos == 0) {
+        chanFreeBuf_(buf);
+        return;
+    }
+
+    buf->len = pos;
+    if (chanEnqueue_(client->chanfd, buf) < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: chanEnqueue_() failed for host %s", __func__, client->fromHost);
+        chanFreeBuf_(buf);
+    }
+}
+
+/* streamWants()
+ */
+static int
+streamWants(struct clientNode *client, int type)
+{
+    if (client->streamMask[0] == 0
+        && client->streamMask[1] == 0)
+        return TRUE;
+
+    if (type <= 0 || type >= 64)
+        return FALSE;
+
+    return (client->streamMask[type / 32] & (1 << (type % 32))) != 0;
+}
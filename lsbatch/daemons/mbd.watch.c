@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "mbd.h"
+
+/* Job watch.
+ *
+ * A client sending BATCH_JOB_WATCH with a list of job ids
+ * keeps its connection and mbatchd pushes a jobWatchEnt
+ * every time one of the jobs changes state, starting with
+ * the current state of each job. The clients are nios of
+ * interactive jobs waiting for their job to start, which
+ * otherwise poll mbatchd with forked BATCH_JOB_INFO queries.
+ *
+ * The state changes are taken from the records written to
+ * lsb.events so every transition that is logged is pushed.
+ * The watched jobs are kept in a table so that the jobs
+ * nobody watches cost a single lookup.
+ */
+
+struct watchNode {
+    struct watchNode *next;
+    struct clientNode *client;
+};
+
+static struct hTab watchTab;
+static int numWatches;
+
+static void watchSend(struct clientNode *, LS_LONG_INT, int);
+
+/* do_jobWatch()
+ * Register the jobs the client watches, a new request
+ * replaces the jobs of the previous one.
+ */
+int
+do_jobWatch(XDR *xdrs, struct clientNode *client, struct LSFHeader *hdr)
+{
+    struct jobWatchReq req;
+    struct watchNode *w;
+    hEnt *ent;
+    int i;
+
+    if (! xdr_jobWatchReq(xdrs, &req, hdr)) {
+        ls_syslog(LOG_ERR, "\
+%s: xdr_jobWatchReq() failed for host %s", __func__, client->fromHost);
+        errorBack(client->chanfd, LSBE_XDR, &client->from);
+        return -1;
+    }
+
+    if (watchTab.slotPtr == NULL)
+        h_initTab_(&watchTab, 101);
+
+    jobWatchClear(client);
+
+    client->numWatch = req.numJobs;
+    client->watchJobs = req.jobIds;
+
+    for (i = 0; i < req.numJobs; i++) {
+
+        if ((ent = chekMemb(&watchTab, req.jobIds[i])) == NULL) {
+            ent = addMemb(&watchTab, req.jobIds[i]);
+            ent->hData = NULL;
+        }
+
+        w = my_calloc(1, sizeof(struct watchNode), __func__);
+        w->client = client;
+        w->next = ent->hData;
+        ent->hData = w;
+        ++numWatches;
+    }
+
+    errorBack(client->chanfd, LSBE_NO_ERROR, &client->from);
+
+    /* From now on we only enqueue to the client
+     * a slow reader must not block mbatchd.
+     */
+    io_nonblock_(chanSock_(client->chanfd));
+
+    for (i = 0; i < req.numJobs; i++)
+        watchSend(client, req.jobIds[i], -1);
+
+    return 0;
+}
+
+/* jobWatchClear()
+ * Forget the jobs watched by the client.
+ */
+void
+jobWatchClear(struct clientNode *client)
+{
+    struct watchNode *w;
+    struct watchNode *w2;
+    hEnt *ent;
+    int i;
+
+    for (i = 0; i < client->numWatch; i++) {
+
+        if ((ent = chekMemb(&watchTab, client->watchJobs[i])) == NULL)
+            continue;
+
+        for (w2 = NULL, w = ent->hData; w; w2 = w, w = w->next) {
+            if (w->client != client)
+                continue;
+            if (w2)
+                w2->next = w->next;
+            else
+                ent->hData = w->next;
+            free(w);
+            --numWatches;
+            break;
+        }
+
+        if (ent->hData == NULL)
+            remvMemb(&watchTab, client->watchJobs[i]);
+    }
+
+    FREEUP(client->watchJobs);
+    client->numWatch = 0;
+}
+
+/* jobWatchLog()
+ * Push the state change an event record
+ * is logging to the clients watching the job.
+ */
+void
+jobWatchLog(struct eventRec *log)
+{
+    struct watchNode *w;
+    LS_LONG_INT jobId;
+    hEnt *ent;
+    int status;
+
+    if (numWatches == 0)
+        return;
+
+    switch (log->type) {
+        case EVENT_JOB_START:
+            jobId = LSB_JOBID(log->eventLog.jobStartLog.jobId,
+                              log->eventLog.jobStartLog.idx);
+            status = log->eventLog.jobStartLog.jStatus;
+            break;
+        case EVENT_JOB_STATUS:
+            jobId = LSB_JOBID(log->eventLog.jobStatusLog.jobId,
+                              log->eventLog.jobStatusLog.idx);
+            status = log->eventLog.jobStatusLog.jStatus;
+            break;
+        default:
+            return;
+    }
+
+    if ((ent = chekMemb(&watchTab, jobId)) == NULL)
+        return;
+
+    for (w = ent->hData; w; w = w->next)
+        watchSend(w->client, jobId, status);
+}
+
+/* watchSend()
+ * Enqueue the state of the job to the client, status
+ * is the one being logged or -1 for the current one.
+ */
+static void
+watchSend(struct clientNode *client, LS_LONG_INT jobId, int status)
+{
+    struct jobWatchEnt jw;
+    struct LSFHeader hdr;
+    struct Buffer *buf;
+    struct jData *jp;
+    XDR xdrs;
+
+    memset(&jw, 0, sizeof(struct jobWatchEnt));
+    jw.jobId = jobId;
+    jw.status = JOB_STAT_NULL;
+
+    if ((jp = getJobData(jobId)) != NULL) {
+
+        if (status < 0)
+            status = (jp->jStatus & JOB_STAT_UNKWN) ?
+                JOB_STAT_UNKWN : jp->jStatus;
+        jw.status = status & MASK_INT_JOB_STAT;
+
+        if (IS_SUSP(jp->jStatus))
+            jw.reasons = ~SUSP_MBD_LOCK & jp->newReason;
+        else
+            jw.reasons = jp->newReason;
+        jw.subreasons = jp->subreasons;
+        jw.exitStatus = jp->exitStatus;
+    }
+
+    if (chanAllocBuf_(&buf, sizeof(struct LSFHeader) + 64) < 0) {
+        ls_syslog(LOG_ERR, "%s: chanAllocBuf_() failed", __func__);
+        return;
+    }
+
+    initLSFHeader_(&hdr);
+    hdr.opCode = LSBE_NO_ERROR;
+
+    xdrmem_create(&xdrs,
+                  buf->data,
+                  sizeof(struct LSFHeader) + 64,
+                  XDR_ENCODE);
+    if (! xdr_encodeMsg(&xdrs, (char *)&jw, &hdr, xdr_jobWatchEnt, 0, NULL)) {
+        ls_syslog(LOG_ERR, "\
+%s: xdr_encodeMsg() failed for job %s", __func__, lsb_jobid2str(jobId));
+        xdr_destroy(&xdrs);
+        chanFreeBuf_(buf);
+        return;
+    }
+    buf->len = XDR_GETPOS(&xdrs);
+    xdr_destroy(&xdrs);
+
+    if (chanEnqueue_(client->chanfd, buf) < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: chanEnqueue_() failed for job %s host %s", __func__,
+                  lsb_jobid2str(jobId), client->fromHost);
+        chanFreeBuf_(buf);
+    }
+}
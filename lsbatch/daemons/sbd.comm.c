@@ -116,7 +116,7 @@ status_job(mbdReqType reqType,
      * will messed up memory if there is no blaunch
      */
     jru = NULL;
-    if ((bjru = get_blaunch_jrusage())) {
+    if ((bjru = get_blaunch_jrusage(jp))) {
 
         jru = merge_jrusage(&jp->runRusage, bjru);
 
@@ -327,6 +327,8 @@ znovu:
     xdrmem_create(&xdrs, request_buf, MSGSIZE/8, XDR_ENCODE);
     initLSFHeader_(&hdr);
     hdr.opCode = mbdReqtype;
+    if (jfcacheOn())
+        hdr.reserved |= SBD_HDR_JFCACHE;
 
     if (! xdr_encodeMsg(&xdrs, NULL, &hdr, NULL, 0, NULL)) {
         ls_syslog(LOG_ERR, "\
@@ -46,6 +46,14 @@
 #define JOBFILE_CREATED -1
 #define JSUPER_STAT_SUSP 0
 
+/* The latest rusage of a launcher of a tree blaunch,
+ * tagged in the reserved0 field of the header.
+ */
+struct blaunchRU {
+    int tag;
+    struct jRusage *jru;
+};
+
 struct jobCard {
     struct jobCard *forw;
     struct jobCard *back;
@@ -108,6 +116,9 @@ struct jobCard {
     char   userJobSucc;
     int    *cores;    /* an array of core index that the job is bound to */
     int    numCores;  /* number of bound cores */
+    struct blaunchRU *blaunchRus; /* rusage of each blaunch launcher */
+    int    numBlaunchRus;
+    struct jRusage *blaunchRu;    /* sum of the launchers rusage */
 };
 
 /* openlava core representation
@@ -380,6 +391,12 @@ extern void writePidInfoFile(struct jobCard *, struct jRusage *);
 extern void update_job_rusage(struct jobCard *, struct jRusage *);
 extern int sbdlog_newstatus(struct jobCard *);
 extern void free_jrusage(struct jRusage **);
-extern struct jRusage *get_blaunch_jrusage(void);
+extern struct jRusage *get_blaunch_jrusage(struct jobCard *);
+extern void free_blaunch_jrusage(struct jobCard *);
 extern struct jRusage *merge_jrusage(struct jRusage *, struct jRusage *);
+
+extern void jfcacheInit(void);
+extern int jfcacheOn(void);
+extern int jfcacheRecv(int, struct jobSpecs *, struct lenData *);
+extern void jfcacheClean(void);
 #endif /* _SBD_H_ */
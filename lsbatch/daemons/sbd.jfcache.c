@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "sbd.h"
+#include <dirent.h>
+#include <utime.h>
+
+/* Job file cache.
+ *
+ * With SBD_JOBFILE_CACHE=/path/dir in lsf.conf sbatchd keeps
+ * the job files it receives in dir and says so to mbatchd
+ * when it registers and when it answers a probe. The files
+ * are named <uid>.<key> where key is the jobFileKey() of the
+ * content, so a job file is only ever shared by the jobs of
+ * one user.
+ *
+ * When mbatchd dispatches a job file it already sent to the
+ * host, a requeued job or another element of an array, it
+ * writes the negative length of the key followed by the key
+ * instead of the length of the job file followed by the file.
+ * A key that cannot be resolved fails the job start with
+ * PEND_JOB_NO_FILE, mbatchd then forgets what the host has
+ * cached and sends the whole file next time.
+ */
+
+static char cacheDir[MAXFILENAMELEN];
+
+static int  jfcacheGet(const char *, int, struct lenData *);
+static void jfcachePut(const char *, struct lenData *);
+
+/* jfcacheInit()
+ */
+void
+jfcacheInit(void)
+{
+    char *dir;
+    struct stat st;
+
+    cacheDir[0] = 0;
+
+    dir = daemonParams[SBD_JOBFILE_CACHE].paramValue;
+    if (dir == NULL)
+        return;
+
+    if (dir[0] != '/'
+        || strlen(dir) >= MAXFILENAMELEN - 2 * JOBFILE_KEYLEN) {
+        ls_syslog(LOG_ERR, "\
+%s: SBD_JOBFILE_CACHE <%s> must be an absolute path", __func__, dir);
+        return;
+    }
+
+    if (mkdir(dir, 0700) < 0
+        && errno != EEXIST) {
+        ls_syslog(LOG_ERR, "%s: mkdir(%s) failed: %m", __func__, dir);
+        return;
+    }
+
+    if (stat(dir, &st) < 0
+        || ! S_ISDIR(st.st_mode)) {
+        ls_syslog(LOG_ERR, "%s: %s is not a directory", __func__, dir);
+        return;
+    }
+
+    strcpy(cacheDir, dir);
+    ls_syslog(LOG_INFO, "%s: caching job files in %s", __func__, cacheDir);
+}
+
+/* jfcacheOn()
+ */
+int
+jfcacheOn(void)
+{
+    return cacheDir[0] != 0;
+}
+
+/* jfcacheRecv()
+ *
+ * Receive the job file of a job, either the file
+ * itself or the key of a cached copy.
+ */
+int
+jfcacheRecv(int chfd, struct jobSpecs *specs, struct lenData *jf)
+{
+    char key[JOBFILE_KEYLEN];
+    char fn[MAXFILENAMELEN];
+    int len;
+
+    jf->data = NULL;
+    jf->len = 0;
+
+    if (chanRead_(chfd, NET_INTADDR_(&len), NET_INTSIZE_) != NET_INTSIZE_) {
+        ls_syslog(LOG_ERR, "%s: chanRead_() failed: %M", __func__);
+        return -1;
+    }
+    len = ntohl(len);
+
+    if (len < 0) {
+
+        len = -len;
+        if (len >= JOBFILE_KEYLEN
+            || chanRead_(chfd, key, len) != len) {
+            ls_syslog(LOG_ERR, "\
+%s: bad job file key for job %s", __func__, lsb_jobid2str(specs->jobId));
+            return -1;
+        }
+        key[len] = 0;
+
+        if (strspn(key, "0123456789abcdef.") != len) {
+            ls_syslog(LOG_ERR, "\
+%s: bad job file key %s for job %s", __func__, key,
+                      lsb_jobid2str(specs->jobId));
+            return -1;
+        }
+
+        if (snprintf(fn, sizeof(fn), "%s/%d.%s",
+                     cacheDir, specs->userId, key) >= sizeof(fn)) {
+            ls_syslog(LOG_ERR, "\
+%s: cache path too long for job %s", __func__, lsb_jobid2str(specs->jobId));
+            return -1;
+        }
+        return jfcacheGet(fn, atoi(key), jf);
+    }
+
+    jf->len = len;
+    jf->data = my_malloc(jf->len, __func__);
+    if (chanRead_(chfd, jf->data, jf->len) != jf->len) {
+        ls_syslog(LOG_ERR, "%s: chanRead_() failed: %M", __func__);
+        FREEUP(jf->data);
+        return -1;
+    }
+
+    /* A path too long is not cached, mbatchd
+     * sends the file again next time.
+     */
+    jobFileKey(jf, key);
+    if (snprintf(fn, sizeof(fn), "%s/%d.%s",
+                 cacheDir, specs->userId, key) < sizeof(fn))
+        jfcachePut(fn, jf);
+
+    return 0;
+}
+
+/* jfcacheGet()
+ *
+ * Read a cached job file and mark it as used.
+ */
+static int
+jfcacheGet(const char *fn, int len, struct lenData *jf)
+{
+    struct stat st;
+    int fd;
+
+    fd = open(fn, O_RDONLY);
+    if (fd < 0) {
+        ls_syslog(LOG_ERR, "%s: open(%s) failed: %m", __func__, fn);
+        return -1;
+    }
+
+    if (fstat(fd, &st) < 0
+        || st.st_size != len) {
+        ls_syslog(LOG_ERR, "%s: %s has the wrong size", __func__, fn);
+        close(fd);
+        return -1;
+    }
+
+    jf->data = my_malloc(len, __func__);
+    if (read(fd, jf->data, len) != len) {
+        ls_syslog(LOG_ERR, "%s: read(%s) failed: %m", __func__, fn);
+        close(fd);
+        FREEUP(jf->data);
+        return -1;
+    }
+    close(fd);
+    jf->len = len;
+
+    utime(fn, NULL);
+
+    return 0;
+}
+
+/* jfcachePut()
+ *
+ * Save a job file, job children may save the
+ * same file at once so write a private file
+ * first and rename it.
+ */
+static void
+jfcachePut(const char *fn, struct lenData *jf)
+{
+    char tmpFn[MAXFILENAMELEN];
+    int fd;
+
+    if (access(fn, F_OK) == 0) {
+        utime(fn, NULL);
+        return;
+    }
+
+    if (snprintf(tmpFn, sizeof(tmpFn), "%s.%d",
+                 fn, (int)getpid()) >= sizeof(tmpFn))
+        return;
+
+    fd = open(tmpFn, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        ls_syslog(LOG_ERR, "%s: open(%s) failed: %m", __func__, tmpFn);
+        return;
+    }
+
+    if (write(fd, jf->data, jf->len) != jf->len) {
+        ls_syslog(LOG_ERR, "%s: write(%s) failed: %m", __func__, tmpFn);
+        close(fd);
+        unlink(tmpFn);
+        return;
+    }
+
+    if (close(fd) < 0) {
+        ls_syslog(LOG_ERR, "%s: close(%s) failed: %m", __func__, tmpFn);
+        unlink(tmpFn);
+        return;
+    }
+
+    if (rename(tmpFn, fn) < 0) {
+        ls_syslog(LOG_ERR, "%s: rename(%s) failed: %m", __func__, tmpFn);
+        unlink(tmpFn);
+    }
+}
+
+/* jfcacheClean()
+ *
+ * Remove the job files not used for JFCACHE_KEEP
+ * seconds, mbatchd stops referring to them well
+ * before that.
+ */
+void
+jfcacheClean(void)
+{
+    char fn[MAXFILENAMELEN];
+    struct dirent *dp;
+    struct stat st;
+    DIR *dir;
+    time_t t;
+
+    if (! jfcacheOn())
+        return;
+
+    if ((dir = opendir(cacheDir)) == NULL) {
+        ls_syslog(LOG_ERR, "%s: opendir(%s) failed: %m", __func__, cacheDir);
+        return;
+    }
+
+    t = time(NULL);
+    while ((dp = readdir(dir)) != NULL) {
+
+        if (strcmp(dp->d_name, ".") == 0
+            || strcmp(dp->d_name, "..") == 0
+            || snprintf(fn, sizeof(fn), "%s/%s",
+                        cacheDir, dp->d_name) >= sizeof(fn))
+            continue;
+
+        if (stat(fn, &st) == 0
+            && S_ISREG(st.st_mode)
+            && t - st.st_mtime > JFCACHE_KEEP)
+            unlink(fn);
+    }
+
+    closedir(dir);
+}
@@ -317,7 +317,12 @@ execJob(struct jobCard *jobCardPtr, int chfd)
     jobSpecsPtr->jobPGid = jobSpecsPtr->jobPid;
     jobCardPtr->stdinFile = NULL;
 
-    if (rcvJobFile(chfd, &jf) == -1) {
+    if (jfcacheOn())
+        cc = jfcacheRecv(chfd, jobSpecsPtr, &jf);
+    else
+        cc = rcvJobFile(chfd, &jf);
+
+    if (cc == -1) {
         ls_syslog(LOG_ERR, "\
 %s: failed receiving job file job %s", __func__,
                   lsb_jobid2str(jobSpecsPtr->jobId));
@@ -2661,6 +2666,7 @@ deallocJobCard(struct jobCard *jobCard)
     freeToHostsEtc (&jobCard->jobSpecs);
 
     FREEUP(jobCard->cores);
+    free_blaunch_jrusage(jobCard);
 
     if (jobCard->runRusage.npgids > 0) {
         FREEUP(jobCard->runRusage.pgid);
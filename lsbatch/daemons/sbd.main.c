@@ -103,6 +103,7 @@ struct tclLsInfo *tclLsInfo;
 extern int initenv_(struct config_param *, char *);
 
 #define CHECK_MBD_TIME 30
+#define JFCACHE_CLEAN_TIME 3600
 static char mbdStartedBySbd = FALSE;
 
 int getpwnamRetry = 1;
@@ -287,6 +288,8 @@ main(int argc, char **argv)
         init_cores();
     }
 
+    jfcacheInit();
+
     now = time(NULL);
 
     for (i = 0; i < 8; i++)
@@ -856,6 +859,7 @@ houseKeeping(void)
     static time_t lastTime;
     static time_t lastCheckMbdTime;
     static time_t lastStartMbdTime;
+    static time_t lastCleanTime;
     char *updMasterHost;
     char *myhostnm;
 
@@ -865,6 +869,11 @@ houseKeeping(void)
         lastTime = now;
     }
 
+    if (now - lastCleanTime >= JFCACHE_CLEAN_TIME) {
+        jfcacheClean();
+        lastCleanTime = now;
+    }
+
     /* Nice reverse logic
      */
     if (! (now - lastCheckMbdTime >= CHECK_MBD_TIME))
@@ -26,10 +26,9 @@ extern int  rusageUpdatePercent;
 extern int lsbJobCpuLimit;
 extern int lsbJobMemLimit;
 
-static struct jRusage *blaunch_jru;
-
 static int replyHdrWithRC(int, int, int);
 static struct jobCard *find_job_card(int);
+static struct jRusage *sum_blaunch_jrusage(struct jobCard *);
 
 void
 do_newjob(XDR *xdrs, int chfd, struct LSFHeader *reqHdr)
@@ -519,6 +518,9 @@ do_probe(XDR * xdrs, int chfd, struct LSFHeader * reqHdr)
             replyHdr.opCode = ERR_NO_LIM;
         }
     }
+    if (jfcacheOn())
+        replyHdr.reserved |= SBD_HDR_JFCACHE;
+
     xdrmem_create(&xdrs2, reply_buf, MSGSIZE, XDR_ENCODE);
 
     if (!xdr_encodeMsg(&xdrs2, NULL, &replyHdr, NULL, 0, auth)) {
@@ -1124,7 +1126,9 @@ void
 do_blaunch_rusage(XDR *xdrs, int chfd, struct LSFHeader *hdr)
 {
     struct jobCard *jPtr;
+    struct jRusage *jru;
     int jobID;
+    int i;
 
     /* Get the job id
      */
@@ -1149,20 +1153,48 @@ do_blaunch_rusage(XDR *xdrs, int chfd, struct LSFHeader *hdr)
         return;
     }
 
-    free_jrusage(&blaunch_jru);
-
     /* decode the rusage
      */
-    blaunch_jru = calloc(1, sizeof(struct jRusage));
+    jru = my_calloc(1, sizeof(struct jRusage), __func__);
 
-    if (! xdr_jRusage(xdrs, blaunch_jru, hdr)) {
+    if (! xdr_jRusage(xdrs, jru, hdr)) {
         ls_syslog(LOG_ERR, "\
 %: failed decoding jobid % or stepid %d", __func__, jobID);
+        free_jrusage(&jru);
         replyHdrWithRC(LSBE_XDR, chfd, jobID);
         xdr_destroy(xdrs);
         return;
     }
 
+    /* Replace the previous report of the same launcher
+     * of this job.
+     */
+    for (i = 0; i < jPtr->numBlaunchRus; i++) {
+        if (jPtr->blaunchRus[i].tag == hdr->reserved0)
+            break;
+    }
+    if (i == jPtr->numBlaunchRus) {
+        struct blaunchRU *ru;
+
+        ru = realloc(jPtr->blaunchRus, (i + 1) * sizeof(struct blaunchRU));
+        if (ru == NULL) {
+            ls_syslog(LOG_ERR, "%s: realloc() failed: %m", __func__);
+            free_jrusage(&jru);
+            replyHdrWithRC(LSBE_NO_MEM, chfd, jobID);
+            xdr_destroy(xdrs);
+            return;
+        }
+        jPtr->blaunchRus = ru;
+        jPtr->blaunchRus[i].tag = hdr->reserved0;
+        jPtr->blaunchRus[i].jru = NULL;
+        ++jPtr->numBlaunchRus;
+    }
+    free_jrusage(&jPtr->blaunchRus[i].jru);
+    jPtr->blaunchRus[i].jru = jru;
+
+    free_jrusage(&jPtr->blaunchRu);
+    jPtr->blaunchRu = sum_blaunch_jrusage(jPtr);
+
     /* update the job
      */
     replyHdrWithRC(LSBE_NO_ERROR, chfd, jobID);
@@ -1175,9 +1207,66 @@ do_blaunch_rusage(XDR *xdrs, int chfd, struct LSFHeader *hdr)
 }
 
 struct jRusage *
-get_blaunch_jrusage(void)
+get_blaunch_jrusage(struct jobCard *jPtr)
+{
+    return jPtr->blaunchRu;
+}
+
+/* free_blaunch_jrusage()
+ *
+ * Free the blaunch reports of a job.
+ */
+void
+free_blaunch_jrusage(struct jobCard *jPtr)
+{
+    int i;
+
+    for (i = 0; i < jPtr->numBlaunchRus; i++)
+        free_jrusage(&jPtr->blaunchRus[i].jru);
+    FREEUP(jPtr->blaunchRus);
+    jPtr->numBlaunchRus = 0;
+    free_jrusage(&jPtr->blaunchRu);
+}
+
+/* sum_blaunch_jrusage()
+ *
+ * Add up the reports of all the launchers of the job.
+ */
+static struct jRusage *
+sum_blaunch_jrusage(struct jobCard *jPtr)
 {
-    return blaunch_jru;
+    struct jRusage *jru;
+    struct jRusage *r;
+    int npids;
+    int npgids;
+    int i;
+
+    jru = my_calloc(1, sizeof(struct jRusage), __func__);
+    for (i = 0; i < jPtr->numBlaunchRus; i++) {
+        r = jPtr->blaunchRus[i].jru;
+        jru->mem += r->mem;
+        jru->swap += r->swap;
+        jru->utime += r->utime;
+        jru->stime += r->stime;
+        jru->npids += r->npids;
+        jru->npgids += r->npgids;
+    }
+
+    jru->pidInfo = my_calloc(jru->npids + 1,
+                             sizeof(struct pidInfo), __func__);
+    jru->pgid = my_calloc(jru->npgids + 1, sizeof(int), __func__);
+
+    npids = npgids = 0;
+    for (i = 0; i < jPtr->numBlaunchRus; i++) {
+        r = jPtr->blaunchRus[i].jru;
+        memcpy(jru->pidInfo + npids, r->pidInfo,
+               r->npids * sizeof(struct pidInfo));
+        npids += r->npids;
+        memcpy(jru->pgid + npgids, r->pgid, r->npgids * sizeof(int));
+        npgids += r->npgids;
+    }
+
+    return jru;
 }
 
 static struct jobCard *
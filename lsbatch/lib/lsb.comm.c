@@ -25,7 +25,7 @@ int lsb_mbd_version = -1;
 #define MAXMSGLEN  (16 * 1024 * 1024)
 
 int
-serv_connect(char *serv_host, ushort serv_port, int timeout)
+serv_connect(char *serv_host, ushort serv_port, int timeout, int options)
 {
     int chfd;
     int cc;
@@ -50,7 +50,7 @@ serv_connect(char *serv_host, ushort serv_port, int timeout)
         return -1;
     }
 
-    cc = chanConnect_(chfd, &serv_addr, timeout * 1000, 0);
+    cc = chanConnect_(chfd, &serv_addr, timeout * 1000, options);
     if (cc < 0) {
         switch(lserrno) {
             case LSE_TIME_OUT:
@@ -96,7 +96,17 @@ call_server(char * host,
     lsberrno = LSBE_NO_ERROR;
 
     if (!(flags & CALL_SERVER_USE_SOCKET)) {
-        if ((serverSock = serv_connect (host, serv_port, conn_timeout)) < 0)
+        int options = 0;
+
+        /* The connection completes while the request
+         * sits in the channel queue.
+         */
+        if ((flags & CALL_SERVER_ASYNC_CONNECT)
+            && (flags & CALL_SERVER_ENQUEUE_ONLY))
+            options = CHAN_OP_NONBLOCK;
+
+        serverSock = serv_connect(host, serv_port, conn_timeout, options);
+        if (serverSock < 0)
             return -2;
     } else {
         if (connectedSock == NULL) {
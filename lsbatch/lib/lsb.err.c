@@ -158,6 +158,7 @@ char   *lsb_errmsg[] = {
     /*133*/   "Job has no dependencies",
     /*134*/   "The job group is not empty",
     /*135*/   "The modification/creation violates the job group limit",
+    /*136*/   "The event stream is not enabled",
     /* when you add a new message here, remember  to not
      * forget to add "," after the error message otherwise
      * the error count will be wrong.
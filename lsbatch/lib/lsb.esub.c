@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "lsb.h"
+#include <dlfcn.h>
+
+/* In process esub.
+ *
+ * The traditional esub is forked and executed for every
+ * submission and talks to bsub through temporary files.
+ * Two alternatives run the esub in the submitting process
+ * so that its cost is paid once per process:
+ *
+ * LSB_ESUB_PLUGIN=/path/esub.so is a shared object loaded
+ * with dlopen() the first time a job is submitted. It must
+ * define
+ *
+ *   int esub_submit(struct submit *req)
+ *
+ * which may modify req and returns 0 to accept the job
+ * or -1 to reject it. Strings it stores in req must stay
+ * valid until the submission returns. It may define
+ *
+ *   int esub_init(void)
+ *
+ * called once after loading, a negative return rejects
+ * all the submissions.
+ *
+ * LSB_ESUB_SERVER=/path/program is started once, as the
+ * submitting user, with its stdin and stdout connected to
+ * bsub. For every job bsub writes the lines of the esub
+ * parameter file followed by a line holding only a dot.
+ * The server answers with the lines of the LSB_SUB_MODIFY_FILE,
+ * a dot line, the lines of the LSB_SUB_MODIFY_ENVFILE,
+ * a dot line and finally ACCEPT or REJECT.
+ *
+ * If the plugin or the server cannot be used the
+ * submissions are rejected since the esub is a
+ * site policy.
+ */
+
+static int esubInit(void);
+static int esubPluginCall(struct submit *);
+static int esubServerCall(struct submit *);
+static int readSection(FILE *, char **);
+static int applySection(char *, struct submit *, int);
+
+static int esubInitDone;
+static int esubBroken;
+static int (*esubSubmit)(struct submit *);
+static FILE *esubTo;
+static FILE *esubFrom;
+
+/* esubInProcess()
+ *
+ * Is the esub running inside the submitting
+ * process instead of being forked for each job.
+ */
+int
+esubInProcess(void)
+{
+    if (lsbParams[LSB_ESUB_PLUGIN].paramValue
+        || lsbParams[LSB_ESUB_SERVER].paramValue)
+        return TRUE;
+
+    return FALSE;
+}
+
+/* esubCall()
+ *
+ * Run the in process esub on the job, the plugin
+ * takes precedence over the server.
+ */
+int
+esubCall(struct submit *jobSubReq)
+{
+    if (! esubInProcess())
+        return 0;
+
+    if (esubInit() < 0) {
+        lsberrno = LSBE_ESUB_ABORT;
+        return -1;
+    }
+
+    if (esubSubmit)
+        return esubPluginCall(jobSubReq);
+
+    return esubServerCall(jobSubReq);
+}
+
+/* esubInit()
+ */
+static int
+esubInit(void)
+{
+    char *plugin;
+    char *server;
+    int (*init)(void);
+    int toServer[2];
+    int fromServer[2];
+    pid_t pid;
+
+    if (esubInitDone)
+        return esubBroken ? -1 : 0;
+
+    esubInitDone = TRUE;
+    esubBroken = TRUE;
+
+    plugin = lsbParams[LSB_ESUB_PLUGIN].paramValue;
+    if (plugin) {
+        void *handle;
+
+        handle = dlopen(plugin, RTLD_NOW);
+        if (handle == NULL) {
+            ls_syslog(LOG_ERR, "\
+%s: cannot open %s: %s", __func__, plugin, dlerror());
+            return -1;
+        }
+
+        esubSubmit = dlsym(handle, "esub_submit");
+        if (esubSubmit == NULL) {
+            ls_syslog(LOG_ERR, "\
+%s: missing esub_submit() symbol in %s: %s", __func__, plugin, dlerror());
+            dlclose(handle);
+            return -1;
+        }
+
+        init = dlsym(handle, "esub_init");
+        if (init
+            && (*init)() < 0) {
+            ls_syslog(LOG_ERR, "\
+%s: esub_init() of %s failed", __func__, plugin);
+            esubSubmit = NULL;
+            dlclose(handle);
+            return -1;
+        }
+
+        esubBroken = FALSE;
+        return 0;
+    }
+
+    server = lsbParams[LSB_ESUB_SERVER].paramValue;
+
+    if (pipe(toServer) < 0)
+        return -1;
+    if (pipe(fromServer) < 0) {
+        close(toServer[0]);
+        close(toServer[1]);
+        return -1;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        ls_syslog(LOG_ERR, "%s: fork() failed: %M", __func__);
+        close(toServer[0]);
+        close(toServer[1]);
+        close(fromServer[0]);
+        close(fromServer[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        char *argv[2];
+
+        dup2(toServer[0], 0);
+        dup2(fromServer[1], 1);
+        close(toServer[0]);
+        close(toServer[1]);
+        close(fromServer[0]);
+        close(fromServer[1]);
+
+        if (setuid(getuid()) < 0)
+            _exit(-1);
+
+        argv[0] = server;
+        argv[1] = NULL;
+        execv(server, argv);
+        ls_syslog(LOG_ERR, "%s: execv(%s) failed: %M", __func__, server);
+        _exit(-1);
+    }
+
+    close(toServer[0]);
+    close(fromServer[1]);
+    fcntl(toServer[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fromServer[0], F_SETFD, FD_CLOEXEC);
+
+    esubTo = fdopen(toServer[1], "w");
+    esubFrom = fdopen(fromServer[0], "r");
+    if (esubTo == NULL
+        || esubFrom == NULL) {
+        if (esubTo)
+            fclose(esubTo);
+        else
+            close(toServer[1]);
+        if (esubFrom)
+            fclose(esubFrom);
+        else
+            close(fromServer[0]);
+        esubTo = esubFrom = NULL;
+        return -1;
+    }
+
+    esubBroken = FALSE;
+    return 0;
+}
+
+/* esubPluginCall()
+ */
+static int
+esubPluginCall(struct submit *jobSubReq)
+{
+    if ((*esubSubmit)(jobSubReq) < 0) {
+        lsberrno = LSBE_ESUB_ABORT;
+        return -1;
+    }
+
+    return 0;
+}
+
+/* esubServerCall()
+ */
+static int
+esubServerCall(struct submit *jobSubReq)
+{
+    char status[MAXLINELEN];
+    char *parms;
+    char *env;
+    void (*pipeHandler)(int);
+    int cc;
+
+    parms = env = NULL;
+
+    /* A dead server must not kill us.
+     */
+    pipeHandler = signal(SIGPIPE, SIG_IGN);
+
+    writeEsubParms(esubTo, jobSubReq);
+    fprintf(esubTo, ".\n");
+    cc = fflush(esubTo);
+
+    signal(SIGPIPE, pipeHandler);
+
+    if (cc == EOF
+        || readSection(esubFrom, &parms) < 0
+        || readSection(esubFrom, &env) < 0
+        || fgets(status, sizeof(status), esubFrom) == NULL) {
+        ls_syslog(LOG_ERR, "\
+%s: lost the esub server %s", __func__,
+                  lsbParams[LSB_ESUB_SERVER].paramValue);
+        esubBroken = TRUE;
+        FREEUP(parms);
+        FREEUP(env);
+        lsberrno = LSBE_ESUB_ABORT;
+        return -1;
+    }
+
+    if (strncmp(status, "ACCEPT", 6) != 0) {
+        FREEUP(parms);
+        FREEUP(env);
+        lsberrno = LSBE_ESUB_ABORT;
+        return -1;
+    }
+
+    cc = 0;
+    if (applySection(parms, jobSubReq, TRUE) < 0
+        || applySection(env, jobSubReq, FALSE) < 0) {
+        lsberrno = LSBE_SYS_CALL;
+        cc = -1;
+    }
+
+    FREEUP(parms);
+    FREEUP(env);
+
+    return cc;
+}
+
+/* readSection()
+ *
+ * Read the lines up to a line holding only a dot,
+ * the lines are returned in a nul terminated buffer.
+ */
+static int
+readSection(FILE *fp, char **section)
+{
+    char line[MAXLINELEN];
+    char *buf;
+    char *p;
+    int len;
+    int size;
+    int bol;
+    int cc;
+
+    size = MAXLINELEN;
+    if ((buf = malloc(size)) == NULL)
+        return -1;
+    buf[0] = 0;
+    len = 0;
+    bol = TRUE;
+
+    while (fgets(line, sizeof(line), fp)) {
+
+        if (bol
+            && strcmp(line, ".\n") == 0) {
+            *section = buf;
+            return 0;
+        }
+
+        cc = strlen(line);
+        if (len + cc + 1 > size) {
+            size = 2 * size + cc;
+            if ((p = realloc(buf, size)) == NULL)
+                break;
+            buf = p;
+        }
+        memcpy(buf + len, line, cc + 1);
+        len += cc;
+        bol = (line[cc - 1] == '\n');
+    }
+
+    free(buf);
+    return -1;
+}
+
+/* applySection()
+ *
+ * Parse a section of the server answer with the same
+ * code that reads the esub modification files.
+ */
+static int
+applySection(char *section, struct submit *jobSubReq, int parms)
+{
+    FILE *fp;
+
+    if (section[0] == 0)
+        return 0;
+
+    fp = fmemopen(section, strlen(section), "r");
+    if (fp == NULL)
+        return -1;
+
+    if (parms)
+        readEsubParms(fp, jobSubReq);
+    else
+        readEsubEnv(fp);
+    fclose(fp);
+
+    return 0;
+}
@@ -75,6 +75,8 @@ extern int sig_encode(int);
 #define LSB_32_PAREN_ESC     15
 #define LSB_API_QUOTE_CMD    16
 #define LSB_DEFAULT_USER_GROUP 17
+#define LSB_ESUB_PLUGIN 18
+#define LSB_ESUB_SERVER 19
 
 typedef struct lsbSubSpoolFile {
     char inFileSpool[MAXFILENAMELEN];
@@ -82,7 +84,7 @@ typedef struct lsbSubSpoolFile {
 } LSB_SUB_SPOOL_FILE_T;
 
 extern int creat_p_socket(void);
-extern int serv_connect(char *, ushort, int);
+extern int serv_connect(char *, ushort, int, int);
 extern int getServerMsg(int, struct LSFHeader *, char **);
 extern int callmbd(char *,
                    char *,
@@ -119,6 +121,11 @@ extern int runBatchEsub(struct lenData *, struct submit *);
 extern void makeCleanToRunEsub();
 extern char *translateString(char *);
 extern void modifyJobInformation(struct submit *);
+extern void writeEsubParms(FILE *, struct submit *);
+extern void readEsubParms(FILE *, struct submit *);
+extern void readEsubEnv(FILE *);
+extern int esubInProcess(void);
+extern int esubCall(struct submit *);
 extern void compactXFReq(struct submit *);
 extern char *wrapCommandLine(char *);
 extern char *unwrapCommandLine(char *);
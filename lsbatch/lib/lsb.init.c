@@ -41,6 +41,8 @@ struct config_param lsbParams[] = {
      {"LSB_32_PAREN_ESC", NULL},
      {"LSB_API_QUOTE_CMD", NULL},
      {"LSB_DEFAULT_USER_GROUP", NULL},
+     {"LSB_ESUB_PLUGIN", NULL},
+     {"LSB_ESUB_SERVER", NULL},
      {NULL, NULL}
 };
 
@@ -21,6 +21,19 @@
 
 static int mbdSock = -1;
 
+/* Message carrying several jobs when the
+ * caller asked for JOBINFO_PACK and mbatchd
+ * said in the job information head it packs.
+ */
+static int packed;
+static struct LSFHeader packHdr;
+static char *packBuf;
+static int packPos;
+static int packNum;
+
+static int readJobInfoPacket(char **, struct LSFHeader *);
+static void freeJobInfoPack(void);
+
 int
 lsb_openjobinfo(LS_LONG_INT jobId, char *jobName, char *userName,
                 char *queueName, char *hostName, int options)
@@ -130,11 +143,16 @@ lsb_openjobinfo_a (LS_LONG_INT jobId, char *jobName, char *userName,
         }
         strcpy(jobInfoReq.userName, userName);
     }
-    if ((options & ~(JOBID_ONLY | JOBID_ONLY_ALL | HOST_NAME | NO_PEND_REASONS)) == 0)
-        jobInfoReq.options = CUR_JOB;
+    if ((options & ~(JOBID_ONLY | JOBID_ONLY_ALL | HOST_NAME | NO_PEND_REASONS
+                     | JOBINFO_PACK | JOBINFO_NO_LOAD | JOBINFO_NO_PATHS)) == 0)
+        jobInfoReq.options = CUR_JOB
+            | (options & (JOBINFO_PACK | JOBINFO_NO_LOAD | JOBINFO_NO_PATHS));
     else
         jobInfoReq.options = options;
 
+    freeJobInfoPack();
+    packed = FALSE;
+
     if (jobId < 0) {
         lsberrno = LSBE_BAD_ARG;
         return NULL;
@@ -178,6 +196,17 @@ lsb_openjobinfo_a (LS_LONG_INT jobId, char *jobName, char *userName,
                 free(reply_buf);
             return NULL;
         }
+        /* A packing mbatchd appends its flag
+         * to the head, older ones send nothing.
+         */
+        if ((jobInfoReq.options & JOBINFO_PACK)
+            && XDR_GETPOS(&xdrs2) < cc
+            && ! xdr_int(&xdrs2, &packed)) {
+            lsberrno = LSBE_XDR;
+            xdr_destroy(&xdrs2);
+            free(reply_buf);
+            return NULL;
+        }
         xdr_destroy(&xdrs2);
         if (cc)
             free(reply_buf);
@@ -208,11 +237,8 @@ lsb_readjobinfo(int *more)
     static int npgids = 0;
     static int *pgid = NULL;
 
-    TIMEIT(0, (num = readNextPacket(&buffer,
-                                    _lsb_recvtimeout,
-                                    &hdr,
-                                    mbdSock)),
-           "readNextPacket");
+    TIMEIT(0, (num = readJobInfoPacket(&buffer, &hdr)),
+           "readJobInfoPacket");
     if (num < 0) {
         closeSession(mbdSock);
         lsberrno = LSBE_EOF;
@@ -404,9 +430,207 @@ lsb_readjobinfo(int *more)
 void
 lsb_closejobinfo()
 {
+    freeJobInfoPack();
     closeSession(mbdSock);
 }
 
+/* lsb_watchjobs()
+ * Ask mbatchd to push the state changes of the jobs on
+ * a connection instead of polling it with lsb_openjobinfo().
+ * The current state of every job is pushed first. Returns
+ * the channel to pass to lsb_readwatch(), chanSock_() gives
+ * its socket to select() on.
+ */
+int
+lsb_watchjobs(int numJobs, LS_LONG_INT *jobIds)
+{
+    struct jobWatchReq req;
+    struct LSFHeader hdr;
+    char request_buf[MSGSIZE + MAX_WATCH_JOBS * 2 * NET_INTSIZE_];
+    char *reply_buf;
+    XDR xdrs;
+    int ch;
+    int cc;
+
+    if (numJobs <= 0
+        || numJobs > MAX_WATCH_JOBS
+        || jobIds == NULL) {
+        lsberrno = LSBE_BAD_ARG;
+        return -1;
+    }
+
+    req.numJobs = numJobs;
+    req.jobIds = jobIds;
+
+    initLSFHeader_(&hdr);
+    hdr.opCode = BATCH_JOB_WATCH;
+
+    xdrmem_create(&xdrs, request_buf, sizeof(request_buf), XDR_ENCODE);
+    if (! xdr_encodeMsg(&xdrs,
+                        (char *)&req,
+                        &hdr,
+                        xdr_jobWatchReq,
+                        0,
+                        NULL)) {
+        xdr_destroy(&xdrs);
+        lsberrno = LSBE_XDR;
+        return -1;
+    }
+
+    ch = -1;
+    cc = callmbd(NULL,
+                 request_buf,
+                 XDR_GETPOS(&xdrs),
+                 &reply_buf,
+                 &hdr,
+                 &ch,
+                 NULL,
+                 NULL);
+    xdr_destroy(&xdrs);
+    if (cc < 0)
+        return -1;
+
+    if (cc > 0)
+        free(reply_buf);
+
+    if (hdr.opCode != LSBE_NO_ERROR) {
+        closeSession(ch);
+        lsberrno = hdr.opCode;
+        return -1;
+    }
+
+    return ch;
+}
+
+/* lsb_readwatch()
+ * Read the next job state pushed by mbatchd waiting at
+ * most timeout seconds, 0 waits until mbatchd sends.
+ * On error the channel is closed.
+ */
+int
+lsb_readwatch(int ch, struct jobWatchEnt *ent, int timeout)
+{
+    struct LSFHeader hdr;
+    char *buf;
+    XDR xdrs;
+
+    if (readNextPacket(&buf, timeout, &hdr, ch) < 0) {
+        closeSession(ch);
+        return -1;
+    }
+
+    xdrmem_create(&xdrs, buf, XDR_DECODE_SIZE_(hdr.length), XDR_DECODE);
+    if (hdr.opCode != LSBE_NO_ERROR
+        || ! xdr_jobWatchEnt(&xdrs, ent, &hdr)) {
+        xdr_destroy(&xdrs);
+        free(buf);
+        closeSession(ch);
+        lsberrno = LSBE_XDR;
+        return -1;
+    }
+
+    xdr_destroy(&xdrs);
+    free(buf);
+
+    return 0;
+}
+
+/* lsb_closewatch()
+ */
+void
+lsb_closewatch(int ch)
+{
+    closeSession(ch);
+}
+
+/* readJobInfoPacket()
+ * Get the next job from mbatchd, either reading a new
+ * message or taking it from the message that packs
+ * several jobs together. The returned buffer holds one
+ * job and belongs to the caller, the return value is the
+ * number of jobs still to be read.
+ */
+static int
+readJobInfoPacket(char **buffer, struct LSFHeader *hdr)
+{
+    XDR xdrs;
+    char *buf;
+    int num;
+    int len;
+
+    if (packNum == 0) {
+
+        freeJobInfoPack();
+
+        num = readNextPacket(&buf, _lsb_recvtimeout, hdr, mbdSock);
+        if (num < 0)
+            return -1;
+
+        if (! packed) {
+            *buffer = buf;
+            return num;
+        }
+
+        if (hdr->opCode != BATCH_JOB_INFO) {
+            free(buf);
+            lsberrno = LSBE_XDR;
+            return -1;
+        }
+
+        xdrmem_create(&xdrs, buf, XDR_DECODE_SIZE_(hdr->length), XDR_DECODE);
+        if (!xdr_int(&xdrs, &packNum)
+            || packNum <= 0) {
+            xdr_destroy(&xdrs);
+            free(buf);
+            packNum = 0;
+            lsberrno = LSBE_XDR;
+            return -1;
+        }
+        packPos = XDR_GETPOS(&xdrs);
+        xdr_destroy(&xdrs);
+
+        packBuf = buf;
+        packHdr = *hdr;
+    }
+
+    xdrmem_create(&xdrs,
+                  packBuf + packPos,
+                  packHdr.length - packPos,
+                  XDR_DECODE);
+    if (!xdr_int(&xdrs, &len)
+        || len < 0
+        || packPos + NET_INTSIZE_ + len > packHdr.length) {
+        xdr_destroy(&xdrs);
+        freeJobInfoPack();
+        lsberrno = LSBE_XDR;
+        return -1;
+    }
+    xdr_destroy(&xdrs);
+
+    if ((buf = malloc(len + 1)) == NULL) {
+        freeJobInfoPack();
+        lsberrno = LSBE_NO_MEM;
+        return -1;
+    }
+    memcpy(buf, packBuf + packPos + NET_INTSIZE_, len);
+    packPos += NET_INTSIZE_ + RNDUP(len);
+    --packNum;
+
+    *hdr = packHdr;
+    hdr->length = len;
+    *buffer = buf;
+
+    return packHdr.reserved + packNum;
+}
+
+static void
+freeJobInfoPack(void)
+{
+    FREEUP(packBuf);
+    packPos = 0;
+    packNum = 0;
+}
+
 int
 lsb_runjob(struct runJobRequest* runJobRequest)
 {
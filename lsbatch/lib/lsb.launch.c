@@ -19,13 +19,42 @@
 
 #include "lsb.h"
 
+/* Tree launch.
+ *
+ * With LSB_BLAUNCH_FANOUT=k in the job environment and more
+ * than k hosts, lsb_launch() starts the task itself only on
+ * the hosts it can reach directly. The host list is cut in k
+ * contiguous subtrees and on the first host of each subtree
+ * larger than one host a relay blaunch -z <subtree> command
+ * is started. The relay runs the command on its own host and
+ * fans out the rest of its subtree in the same way, so every
+ * launcher starts at most k + 1 tasks and the launch takes
+ * log k of the number of hosts rounds.
+ *
+ * The relays find LSB_BLAUNCH_RELAY="<host> <tag>" in their
+ * environment, host is the first execution host whose sbatchd
+ * knows the job. Every launcher sends the rusage of the tasks
+ * it started to that sbatchd tagged in the reserved0 field of
+ * the header, the launching blaunch uses tag 0 and a relay
+ * the position of its host in the host list plus one, and
+ * sbatchd adds up the latest report of each tag.
+ */
+#define RELAY_ENV "LSB_BLAUNCH_RELAY"
+
 static int *tasks;
 struct jRusage **jrus;
+static char **thosts;
+static int *trelay;
 static int num_tasks;
 static int jobID;
 static char *hostname;
+static char *sbdHost;
+static int sbdTag;
 
 static void make_tasks(char **);
+static int start_task(char *, char **, char **, int);
+static int start_tree(char **, int, int, char **, char **, char **);
+static char **relay_env(char **, const char *);
 static int size_rusage(struct jRusage *);
 static void send_rusage(void);
 static int send2sbd(struct jRusage *);
@@ -41,10 +70,10 @@ int
 lsb_launch(char **host_list, char **command, int opt, char **env)
 {
     int cc;
-    int tid;
-    int num_tasks;
     int task_active;
     int rest;
+    int fanout;
+    char **envp;
     char *p;
 
     if (host_list == NULL
@@ -69,33 +98,50 @@ lsb_launch(char **host_list, char **command, int opt, char **env)
         rest = atoi(p);
     }
 
+    fanout = 0;
+    p = getenv("LSB_BLAUNCH_FANOUT");
+    if (p) {
+        fanout = atoi(p);
+    }
+
     hostname = ls_getmyhostname();
+    sbdHost = hostname;
+    sbdTag = 0;
     make_tasks(host_list);
 
-    /* Start all jobs first
-     */
+    envp = NULL;
     num_tasks = cc = 0;
-    while (host_list[cc]) {
-        /* Run the task on the host
+    if ((p = getenv(RELAY_ENV))) {
+        /* We are a relay, run the command here and
+         * fan out the rest of our subtree.
          */
-        tid = ls_rtask(host_list[cc],
-                       command,
-                       0);
-        if (tid < 0) {
+        if (! (sbdHost = strdup(p))
+            || ! (p = strrchr(sbdHost, ' '))) {
             ls_syslog(LOG_ERR, "\
-%s: task %d on host %s failed %s", __func__,
-                    tid, host_list[cc], ls_sysmsg());
+%s: bad %s %s", __func__, RELAY_ENV, getenv(RELAY_ENV));
+            lsberrno = LSBE_BAD_ARG;
             return -1;
         }
-        /* Array of taskids
-         */
-        tasks[cc] = tid;
-        ls_syslog(LOG_INFO, "\
-%s: task id %d cc %d started on host %s", __func__, tid, cc, host_list[cc]);
-        ++cc;
-        ++num_tasks;
+        *p = 0;
+        sbdTag = atoi(p + 1);
+
+        envp = relay_env(env, NULL);
+        if (start_task(host_list[0], command, envp, FALSE) < 0)
+            return -1;
+        cc = 1;
     }
 
+    /* Start all jobs first, the first host left is at
+     * position sbdTag of the host list for a relay and 0
+     * for us, either way its tag is sbdTag + 1 so no relay
+     * shares the tag 0 of the launching blaunch.
+     */
+    if (start_tree(host_list + cc,
+                   sbdTag + 1, fanout, command, env, envp) < 0)
+        return -1;
+
+    _free_(envp);
+
 znovu:
     /* Check if they are still alive
      */
@@ -118,6 +164,14 @@ znovu:
             continue;
         }
 
+        if (tid > 0
+            && trelay[cc]
+            && LS_STATUS(stat) != 0) {
+            ls_syslog(LOG_ERR, "\
+%s: relay task %d on host %s exited %d", __func__,
+                      tid, thosts[cc], LS_STATUS(stat));
+        }
+
         if (tid == 0) {
             /* Collect the rusage if still running
              */
@@ -133,7 +187,7 @@ znovu:
 
             ls_syslog(LOG_INFO, "\
 %s: got rusage for task tid %d from host %s",
-                      __func__, tasks[cc], host_list[cc]);
+                      __func__, tasks[cc], thosts[cc]);
         }
 
         if (tid > 0) {
@@ -185,7 +239,168 @@ make_tasks(char **host_list)
     /* This array holds the jRusage of each task
      */
     jrus = calloc(cc, sizeof(struct jRusage *));
+    /* The host of each task and whether it is a relay
+     */
+    thosts = calloc(cc, sizeof(char *));
+    trelay = calloc(cc, sizeof(int));
 }
+
+/* start_task()
+ */
+static int
+start_task(char *host, char **argv, char **envp, int relay)
+{
+    int tid;
+
+    /* Run the task on the host
+     */
+    if (envp)
+        tid = ls_rtaske(host, argv, 0, envp);
+    else
+        tid = ls_rtask(host, argv, 0);
+    if (tid < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: task %d on host %s failed %s", __func__,
+                  tid, host, ls_sysmsg());
+        return -1;
+    }
+
+    /* Array of taskids
+     */
+    tasks[num_tasks] = tid;
+    thosts[num_tasks] = host;
+    trelay[num_tasks] = relay;
+    ls_syslog(LOG_INFO, "\
+%s: task id %d cc %d started on host %s%s", __func__, tid, num_tasks,
+              host, relay ? " as relay" : "");
+    ++num_tasks;
+
+    return 0;
+}
+
+/* start_tree()
+ *
+ * Start the command on the hosts, with more hosts than
+ * the fanout start a relay on the first host of each
+ * subtree. tag is the relay tag of the first host.
+ */
+static int
+start_tree(char **hosts, int tag, int fanout,
+           char **command, char **env, char **leafEnv)
+{
+    char var[MAXHOSTNAMELEN + 64];
+    char **argv;
+    char **envp;
+    char *list;
+    int num;
+    int n;
+    int m;
+    int k;
+    int cc;
+    int i;
+
+    for (n = 0; hosts[n]; n++)
+        ;
+
+    if (fanout <= 0
+        || n <= fanout) {
+        for (cc = 0; cc < n; cc++) {
+            if (start_task(hosts[cc], command, leafEnv, FALSE) < 0)
+                return -1;
+        }
+        return 0;
+    }
+
+    for (num = 0; command[num]; num++)
+        ;
+    argv = calloc(num + 4, sizeof(char *));
+    list = calloc(n, MAXHOSTNAMELEN + 1);
+    if (argv == NULL
+        || list == NULL) {
+        _free_(argv);
+        _free_(list);
+        lsberrno = LSBE_NO_MEM;
+        return -1;
+    }
+
+    cc = 0;
+    for (k = 0; k < fanout; k++) {
+
+        m = n / fanout + (k < n % fanout);
+
+        if (m == 1) {
+            if (start_task(hosts[cc], command, leafEnv, FALSE) < 0)
+                break;
+            ++cc;
+            continue;
+        }
+
+        /* blaunch -z "subtree" command
+         */
+        list[0] = 0;
+        for (i = cc; i < cc + m; i++) {
+            strcat(list, hosts[i]);
+            strcat(list, " ");
+        }
+        argv[0] = "blaunch";
+        argv[1] = "-z";
+        argv[2] = list;
+        for (i = 0; i <= num; i++)
+            argv[3 + i] = command[i];
+
+        sprintf(var, "%s=%s %d", RELAY_ENV, sbdHost, tag + cc);
+        envp = relay_env(env, var);
+        i = start_task(hosts[cc], argv, envp, TRUE);
+        _free_(envp);
+        if (i < 0)
+            break;
+
+        cc += m;
+    }
+
+    _free_(argv);
+    _free_(list);
+
+    return k < fanout ? -1 : 0;
+}
+
+/* relay_env()
+ *
+ * The environment of the tasks without the relay
+ * variable of this launcher, var is added if given.
+ */
+static char **
+relay_env(char **env, const char *var)
+{
+    char **envp;
+    int len;
+    int n;
+    int i;
+
+    if (env == NULL)
+        env = environ;
+
+    for (n = 0; env[n]; n++)
+        ;
+
+    envp = calloc(n + 2, sizeof(char *));
+    if (envp == NULL)
+        return NULL;
+
+    len = strlen(RELAY_ENV);
+    n = 0;
+    for (i = 0; env[i]; i++) {
+        if (strncmp(env[i], RELAY_ENV, len) == 0
+            && env[i][len] == '=')
+            continue;
+        envp[n] = env[i];
+        ++n;
+    }
+    envp[n] = (char *)var;
+
+    return envp;
+}
+
 static void
 send_rusage(void)
 {
@@ -196,7 +411,7 @@ send_rusage(void)
     if (send2sbd(jru) < 0) {
         ls_syslog(LOG_ERR, "\
 %s: failed to send jRusage data to SBD on %s: %s",
-                  __func__, hostname, lsb_sysmsg());
+                  __func__, sbdHost, lsb_sysmsg());
     }
 
     free_rusage(jru);
@@ -290,6 +505,7 @@ send2sbd(struct jRusage *jru)
 
     initLSFHeader_(&hdr);
     hdr.opCode = SBD_BLAUNCH_RUSAGE;
+    hdr.reserved0 = sbdTag;
 
     req_buf = calloc(len, sizeof(char));
     xdrmem_create(&xdrs, req_buf, len, XDR_ENCODE);
@@ -333,10 +549,10 @@ send2sbd(struct jRusage *jru)
     /* send 2 sbatchd
      */
     reply_buf = NULL;
-    cc = cmdCallSBD_(hostname, req_buf, len, &reply_buf, &hdr, NULL);
+    cc = cmdCallSBD_(sbdHost, req_buf, len, &reply_buf, &hdr, NULL);
     if (cc < 0) {
         ls_syslog(LOG_ERR, "\
-%s: failed calling SBD on %s: %s", __func__, hostname, lsb_sysmsg());
+%s: failed calling SBD on %s: %s", __func__, sbdHost, lsb_sysmsg());
         _free_(req_buf);
         xdr_destroy(&xdrs);
         return -1;
@@ -348,7 +564,7 @@ send2sbd(struct jRusage *jru)
          */
         lsberrno = hdr.opCode;
         ls_syslog(LOG_ERR, "\
-%s: SBD on %s returned: %s", __func__, hostname, lsb_sysmsg());
+%s: SBD on %s returned: %s", __func__, sbdHost, lsb_sysmsg());
         _free_(req_buf);
         xdr_destroy(&xdrs);
         return -1;
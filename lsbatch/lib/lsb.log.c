@@ -4239,3 +4239,158 @@ readJobPreempted(char *line, struct jobPreemptedLog *jLog)
 
     return LSBE_NO_ERROR;
 }
+
+/* lsb_openstream()
+ * Subscribe to the mbatchd event stream. The records
+ * after pos are replayed from the mbatchd ring and then
+ * sent as they are logged, a pos with seq 0 sends only
+ * the new records. On return pos is where the stream
+ * starts, a different epoch or a larger seq means that
+ * records were lost and must be read from lsb.events.
+ * types lists the event types wanted, all if numTypes
+ * is 0.
+ */
+int
+lsb_openstream(struct eventStreamPos *pos, int *types, int numTypes)
+{
+    struct eventStreamReq req;
+    struct eventStreamReply reply;
+    struct LSFHeader hdr;
+    char request_buf[MSGSIZE/8];
+    char *reply_buf;
+    XDR xdrs;
+    int ch;
+    int cc;
+    int i;
+
+    memset(&req, 0, sizeof(struct eventStreamReq));
+    if (pos) {
+        req.epoch = pos->epoch;
+        req.seq = pos->seq;
+    }
+
+    for (i = 0; i < numTypes; i++) {
+        if (types[i] <= 0
+            || types[i] >= 64) {
+            lsberrno = LSBE_BAD_ARG;
+            return -1;
+        }
+        req.mask[types[i] / 32] |= 1 << (types[i] % 32);
+    }
+
+    initLSFHeader_(&hdr);
+    hdr.opCode = BATCH_EVENT_STREAM;
+
+    xdrmem_create(&xdrs, request_buf, sizeof(request_buf), XDR_ENCODE);
+    if (! xdr_encodeMsg(&xdrs,
+                        (char *)&req,
+                        &hdr,
+                        xdr_eventStreamReq,
+                        0,
+                        NULL)) {
+        xdr_destroy(&xdrs);
+        lsberrno = LSBE_XDR;
+        return -1;
+    }
+
+    ch = -1;
+    cc = callmbd(NULL,
+                 request_buf,
+                 XDR_GETPOS(&xdrs),
+                 &reply_buf,
+                 &hdr,
+                 &ch,
+                 NULL,
+                 NULL);
+    xdr_destroy(&xdrs);
+    if (cc < 0)
+        return -1;
+
+    if (hdr.opCode != LSBE_NO_ERROR) {
+        if (cc > 0)
+            free(reply_buf);
+        closeSession(ch);
+        lsberrno = hdr.opCode;
+        return -1;
+    }
+
+    xdrmem_create(&xdrs, reply_buf, XDR_DECODE_SIZE_(cc), XDR_DECODE);
+    if (! xdr_eventStreamReply(&xdrs, &reply, &hdr)) {
+        xdr_destroy(&xdrs);
+        if (cc > 0)
+            free(reply_buf);
+        closeSession(ch);
+        lsberrno = LSBE_XDR;
+        return -1;
+    }
+    xdr_destroy(&xdrs);
+    free(reply_buf);
+
+    if (pos) {
+        pos->epoch = reply.epoch;
+        pos->seq = reply.seq;
+    }
+
+    return ch;
+}
+
+/* lsb_readstream()
+ * Read the next record of the event stream waiting
+ * at most timeout seconds, 0 waits until mbatchd
+ * sends. The record is valid until the next call
+ * and seq is its position in the stream. If the
+ * connection is lost the channel is closed.
+ */
+struct eventRec *
+lsb_readstream(int ch, LS_LONG_INT *seq, int timeout)
+{
+    struct eventStreamRec rec;
+    struct eventRec *log;
+    struct LSFHeader hdr;
+    char *buf;
+    XDR xdrs;
+    FILE *fp;
+    int line;
+
+    if (readNextPacket(&buf, timeout, &hdr, ch) < 0) {
+        closeSession(ch);
+        return NULL;
+    }
+
+    xdrmem_create(&xdrs, buf, XDR_DECODE_SIZE_(hdr.length), XDR_DECODE);
+    if (hdr.opCode != LSBE_NO_ERROR
+        || ! xdr_eventStreamRec(&xdrs, &rec, &hdr)) {
+        xdr_destroy(&xdrs);
+        free(buf);
+        closeSession(ch);
+        lsberrno = LSBE_XDR;
+        return NULL;
+    }
+    xdr_destroy(&xdrs);
+    free(buf);
+
+    fp = fmemopen(rec.line, strlen(rec.line), "r");
+    if (fp == NULL) {
+        free(rec.line);
+        lsberrno = LSBE_NO_MEM;
+        return NULL;
+    }
+
+    line = 0;
+    log = lsb_geteventrec(fp, &line);
+    fclose(fp);
+    free(rec.line);
+
+    if (seq)
+        *seq = rec.seq;
+
+    return log;
+}
+
+/* lsb_closestream()
+ */
+void
+lsb_closestream(int ch)
+{
+    closeSession(ch);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "lsb.h"
+
+/* lsb_perfinfo()
+ * Get the mbatchd metrics snapshot, the returned
+ * text is malloc()ed and freed by the caller.
+ */
+char *
+lsb_perfinfo(void)
+{
+    XDR xdrs;
+    struct LSFHeader hdr;
+    struct perfInfoReply perfReply;
+    char buf[sizeof(struct LSFHeader)];
+    char *reply;
+    int cc;
+
+    initLSFHeader_(&hdr);
+    hdr.opCode = BATCH_PERF_INFO;
+
+    xdrmem_create(&xdrs, buf, sizeof(struct LSFHeader), XDR_ENCODE);
+
+    if (! xdr_LSFHeader(&xdrs, &hdr)) {
+        lsberrno = LSBE_XDR;
+        xdr_destroy(&xdrs);
+        return NULL;
+    }
+
+    reply = NULL;
+    cc = callmbd(NULL,
+                 buf,
+                 XDR_GETPOS(&xdrs),
+                 &reply,
+                 &hdr,
+                 NULL,
+                 NULL,
+                 NULL);
+    if (cc < 0) {
+        xdr_destroy(&xdrs);
+        lsberrno = LSBE_PROTOCOL;
+        return NULL;
+    }
+    xdr_destroy(&xdrs);
+
+    if (hdr.opCode != LSBE_NO_ERROR) {
+        FREEUP(reply);
+        lsberrno = hdr.opCode;
+        return NULL;
+    }
+
+    xdrmem_create(&xdrs, reply, XDR_DECODE_SIZE_(cc), XDR_DECODE);
+    if (! xdr_perfInfoReply(&xdrs, &perfReply, &hdr)) {
+        lsberrno = LSBE_XDR;
+        xdr_destroy(&xdrs);
+        FREEUP(reply);
+        return NULL;
+    }
+
+    xdr_destroy(&xdrs);
+    FREEUP(reply);
+
+    return perfReply.snapshot;
+}
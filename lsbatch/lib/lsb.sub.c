@@ -98,6 +98,28 @@ static int readOptFile(char *, char *);
 static const LSB_SPOOL_INFO_T * chUserCopySpoolFile(const char *,
                                                     spoolOptions_t);
 static int parse_num_slots(const char *, int *, int *);
+static int subInit(struct submit *, struct submitReq *,
+                   struct submitReply *, char *);
+static void rmSubSpoolFiles(LSB_SUB_SPOOL_FILE_T *);
+
+/* A pack of submissions being built, the submitReq
+ * of the jobs are encoded one after the other in buf.
+ */
+struct subPackReq {
+    int     num;
+    int     len;
+    char    *buf;
+    struct lenData *jf;
+    LSB_SUB_SPOOL_FILE_T *spool;
+};
+
+static int subPack(int, struct submit *, struct submitReply *,
+                   LS_LONG_INT *, int *, struct lsfAuth *);
+static int subPackJob(struct submit *, struct submitReply *,
+                      struct lsfAuth *, struct subPackReq *);
+static bool_t xdr_subPackReq(XDR *, struct subPackReq *,
+                             struct LSFHeader *);
+static int sndPackFiles(int, struct subPackReq *);
 
 LS_LONG_INT
 lsb_submit(struct submit  *jobSubReq, struct submitReply *submitRep)
@@ -106,14 +128,41 @@ lsb_submit(struct submit  *jobSubReq, struct submitReply *submitRep)
     LS_LONG_INT jobId = -1;
     struct lsfAuth auth;
     char cwd[MAXFILENAMELEN];
-    struct group *grpEntry;
-    int loop;
-    char * queue = NULL;
 
     if (logclass & (LC_TRACE | LC_EXEC))
         ls_syslog(LOG_DEBUG, "%s: Entering this routine...", __func__);
 
-    memset(&submitReq, 0, sizeof(struct submitReq));
+    if (subInit(jobSubReq, &submitReq, submitRep, cwd) < 0)
+        return -1;
+
+    if (authTicketTokens_(&auth, NULL) == -1) {
+        return -1;
+    }
+
+    if (submitReq.options & SUB_RESTART)
+        jobId = subRestart(jobSubReq, &submitReq, submitRep, &auth);
+    else
+        jobId = subJob(jobSubReq, &submitReq, submitRep, &auth);
+
+    return jobId;
+}
+
+/* subInit()
+ *
+ * Initialize submitReq from jobSubReq, run the user
+ * part of the submission and the esub.
+ */
+static int
+subInit(struct submit *jobSubReq,
+        struct submitReq *submitReq,
+        struct submitReply *submitRep,
+        char *cwd)
+{
+    struct group *grpEntry;
+    int loop;
+    char * queue = NULL;
+
+    memset(submitReq, 0, sizeof(struct submitReq));
     lsberrno = LSBE_BAD_ARG;
 
     subNewLine_(jobSubReq->resReq);
@@ -133,31 +182,31 @@ lsb_submit(struct submit  *jobSubReq, struct submitReply *submitRep)
         subNewLine_(jobSubReq->askedHosts[loop]);
     }
 
-    if (getCommonParams(jobSubReq, &submitReq, submitRep) < 0)
+    if (getCommonParams(jobSubReq, submitReq, submitRep) < 0)
         return -1;
 
     if (!(jobSubReq->options & SUB_QUEUE)) {
 
         if ((queue = getenv("LSB_DEFAULTQUEUE")) != NULL
             && queue[0] != '\0') {
-            submitReq.queue = queue;
-            submitReq.options |= SUB_QUEUE;
+            submitReq->queue = queue;
+            submitReq->options |= SUB_QUEUE;
         }
     }
 
     if (jobSubReq->cwd == NULL) {
         cwd[0] = '\0';
-        submitReq.cwd = cwd;
+        submitReq->cwd = cwd;
     }
     else
-        submitReq.cwd = jobSubReq->cwd;
+        submitReq->cwd = jobSubReq->cwd;
 
     if ((grpEntry = getgrgid(getgid())))
         putEnv("LSB_UNIXGROUP", grpEntry->gr_name);
 
     makeCleanToRunEsub();
 
-    if (getUserInfo(&submitReq, jobSubReq) < 0)
+    if (getUserInfo(submitReq, jobSubReq) < 0)
         return -1;
 
     if (!(jobSubReq->options & SUB_QUEUE)) {
@@ -167,9 +216,12 @@ lsb_submit(struct submit  *jobSubReq, struct submitReply *submitRep)
         }
     }
 
+    if (esubCall(jobSubReq) < 0)
+        return -1;
+
     modifyJobInformation(jobSubReq);
 
-    if (getCommonParams(jobSubReq, &submitReq, submitRep) < 0)
+    if (getCommonParams(jobSubReq, submitReq, submitRep) < 0)
         return -1;
 
     if ((lsbParams[LSB_INTERACTIVE_STDERR].paramValue != NULL)
@@ -178,16 +230,7 @@ lsb_submit(struct submit  *jobSubReq, struct submitReply *submitRep)
         putEnv("LSF_INTERACTIVE_STDERR", "y");
     }
 
-    if (authTicketTokens_(&auth, NULL) == -1) {
-        return -1;
-    }
-
-    if (submitReq.options & SUB_RESTART)
-        jobId = subRestart(jobSubReq, &submitReq, submitRep, &auth);
-    else
-        jobId = subJob(jobSubReq, &submitReq, submitRep, &auth);
-
-    return jobId;
+    return 0;
 }
 
 int
@@ -1387,33 +1430,375 @@ subJob(struct submit  *jobSubReq,
 
 cleanup:
 
-    if (jobId < 0) {
-        const char* spoolHost;
-        int err;
-
-        if (subSpoolFiles.inFileSpool[0]) {
-            spoolHost = getSpoolHostBySpoolFile(subSpoolFiles.inFileSpool);
-            err = chUserRemoveSpoolFile(spoolHost, subSpoolFiles.inFileSpool);
-            if (err) {
-                fprintf(stderr,
-                        (_i18n_msg_get(ls_catd,NL_SETN,442, "Submission failed, and the spooled file <%s> can not be removed on host <%s>, please manually remove it")), /* catgets 442 */
-                        subSpoolFiles.inFileSpool, spoolHost);
-            }
+    if (jobId < 0)
+        rmSubSpoolFiles(&subSpoolFiles);
+
+    return jobId;
+}
+
+/* rmSubSpoolFiles()
+ */
+static void
+rmSubSpoolFiles(LSB_SUB_SPOOL_FILE_T *subSpoolFiles)
+{
+    const char* spoolHost;
+    int err;
+
+    if (subSpoolFiles->inFileSpool[0]) {
+        spoolHost = getSpoolHostBySpoolFile(subSpoolFiles->inFileSpool);
+        err = chUserRemoveSpoolFile(spoolHost, subSpoolFiles->inFileSpool);
+        if (err) {
+            fprintf(stderr,
+                    (_i18n_msg_get(ls_catd,NL_SETN,442, "Submission failed, and the spooled file <%s> can not be removed on host <%s>, please manually remove it")), /* catgets 442 */
+                    subSpoolFiles->inFileSpool, spoolHost);
+        }
+    }
+
+
+    if (subSpoolFiles->commandSpool[0]) {
+        spoolHost = getSpoolHostBySpoolFile(subSpoolFiles->commandSpool);
+        err = chUserRemoveSpoolFile(spoolHost, subSpoolFiles->commandSpool);
+        if (err) {
+            fprintf(stderr,
+                    (_i18n_msg_get(ls_catd,NL_SETN,442, "Submission failed, and the spooled file <%s> can not be removed on host <%s>, please manually remove it")), /* catgets 442 */
+                    subSpoolFiles->commandSpool, spoolHost);
+        }
+    }
+}
+
+/* lsb_submit_batch()
+ *
+ * Submit num jobs sending them to mbatchd in packs of up to
+ * SUB_PACK_MAX jobs, each pack on one authenticated connection.
+ * The id of every submitted job is returned in jobId[] and the
+ * error of every failed job in err[] with jobId[] set to -1.
+ * The strings in submitRep[] are allocated and belong to the
+ * caller. Interactive, blocking and restarted jobs cannot be
+ * packed. Returns the number of jobs submitted or -1 if no pack
+ * could be sent.
+ */
+int
+lsb_submit_batch(int num,
+                 struct submit *jobSubReq,
+                 struct submitReply *submitRep,
+                 LS_LONG_INT *jobId,
+                 int *err)
+{
+    struct lsfAuth auth;
+    int i, n, cc;
+    int numSub;
+
+    if (num <= 0
+        || jobSubReq == NULL
+        || submitRep == NULL
+        || jobId == NULL
+        || err == NULL) {
+        lsberrno = LSBE_BAD_ARG;
+        return -1;
+    }
+
+    if (authTicketTokens_(&auth, NULL) == -1) {
+        for (i = 0; i < num; i++) {
+            jobId[i] = -1;
+            err[i] = lsberrno;
+            memset(&submitRep[i], 0, sizeof(struct submitReply));
         }
+        return -1;
+    }
 
+    numSub = 0;
+    cc = 0;
+    for (i = 0; i < num; i += n) {
 
-        if (subSpoolFiles.commandSpool[0]) {
-            spoolHost = getSpoolHostBySpoolFile(subSpoolFiles.commandSpool);
-            err = chUserRemoveSpoolFile(spoolHost, subSpoolFiles.commandSpool);
-            if (err) {
-                fprintf(stderr,
-                        (_i18n_msg_get(ls_catd,NL_SETN,442, "Submission failed, and the spooled file <%s> can not be removed on host <%s>, please manually remove it")), /* catgets 442 */
-                        subSpoolFiles.commandSpool, spoolHost);
+        n = num - i;
+        if (n > SUB_PACK_MAX)
+            n = SUB_PACK_MAX;
+
+        cc = subPack(n, jobSubReq + i, submitRep + i,
+                     jobId + i, err + i, &auth);
+        if (cc < 0) {
+            /* Nothing more will get through.
+             */
+            for (i += n; i < num; i++) {
+                jobId[i] = -1;
+                err[i] = lsberrno;
+                memset(&submitRep[i], 0, sizeof(struct submitReply));
             }
+            break;
         }
+        numSub += cc;
     }
 
-    return jobId;
+    if (numSub == 0 && cc < 0)
+        return -1;
+
+    return numSub;
+}
+
+/* subPack()
+ *
+ * Prepare each job exactly as lsb_submit() does, encode its
+ * submitReq into the pack, then send the pack followed by the
+ * job files and match the reply to the jobs.
+ */
+static int
+subPack(int num,
+        struct submit *jobSubReq,
+        struct submitReply *submitRep,
+        LS_LONG_INT *jobId,
+        int *err,
+        struct lsfAuth *auth)
+{
+    struct submitPackReply reply;
+    struct LSFHeader hdr;
+    struct subPackReq pack;
+    XDR xdrs;
+    char *request_buf;
+    char *reply_buf;
+    int *idx;
+    int size;
+    int i, j, cc;
+    int numSub;
+
+    memset(&pack, 0, sizeof(struct subPackReq));
+    pack.jf = calloc(num, sizeof(struct lenData));
+    pack.spool = calloc(num, sizeof(LSB_SUB_SPOOL_FILE_T));
+    idx = calloc(num, sizeof(int));
+    if (pack.jf == NULL
+        || pack.spool == NULL
+        || idx == NULL) {
+        lsberrno = LSBE_NO_MEM;
+        numSub = -1;
+        goto out;
+    }
+
+    for (i = 0; i < num; i++) {
+
+        jobId[i] = -1;
+        memset(&submitRep[i], 0, sizeof(struct submitReply));
+
+        if (subPackJob(&jobSubReq[i], &submitRep[i], auth, &pack) < 0) {
+            err[i] = lsberrno;
+            continue;
+        }
+        err[i] = LSBE_NO_ERROR;
+        idx[pack.num] = i;
+        pack.num++;
+    }
+
+    numSub = 0;
+    if (pack.num == 0)
+        goto out;
+
+    size = LSF_HEADER_LEN + xdr_lsfAuthSize(auth)
+        + NET_INTSIZE_ + pack.len;
+    if ((request_buf = malloc(size)) == NULL) {
+        lsberrno = LSBE_NO_MEM;
+        numSub = -1;
+        goto fail;
+    }
+
+    xdrmem_create(&xdrs, request_buf, size, XDR_ENCODE);
+    initLSFHeader_(&hdr);
+    hdr.opCode = BATCH_JOB_SUB_PACK;
+    if (!xdr_encodeMsg(&xdrs, (char *)&pack, &hdr,
+                       xdr_subPackReq, 0, auth)) {
+        xdr_destroy(&xdrs);
+        free(request_buf);
+        lsberrno = LSBE_XDR;
+        numSub = -1;
+        goto fail;
+    }
+
+    cc = callmbd(NULL, request_buf, XDR_GETPOS(&xdrs), &reply_buf,
+                 &hdr, NULL, sndPackFiles, (int *)&pack);
+    xdr_destroy(&xdrs);
+    free(request_buf);
+    if (cc < 0) {
+        numSub = -1;
+        goto fail;
+    }
+
+    lsberrno = hdr.opCode;
+    if (cc == 0 || lsberrno != LSBE_NO_ERROR) {
+        if (lsberrno == LSBE_NO_ERROR)
+            lsberrno = LSBE_PROTOCOL;
+        FREEUP(reply_buf);
+        numSub = -1;
+        goto fail;
+    }
+
+    xdrmem_create(&xdrs, reply_buf, XDR_DECODE_SIZE_(cc), XDR_DECODE);
+    if (!xdr_submitPackReply(&xdrs, &reply, &hdr)
+        || reply.numJobs != pack.num) {
+        if (reply.numJobs != pack.num)
+            freeSubmitPackReply(&reply);
+        xdr_destroy(&xdrs);
+        free(reply_buf);
+        lsberrno = LSBE_XDR;
+        numSub = -1;
+        goto fail;
+    }
+    xdr_destroy(&xdrs);
+    free(reply_buf);
+
+    for (j = 0; j < pack.num; j++) {
+
+        i = idx[j];
+        err[i] = reply.errs[j];
+        submitRep[i].badJobId = reply.replies[j].jobId;
+        submitRep[i].badReqIndx = reply.replies[j].badReqIndx;
+        submitRep[i].queue = reply.replies[j].queue;
+        submitRep[i].badJobName = reply.replies[j].badJobName;
+        reply.replies[j].queue = NULL;
+        reply.replies[j].badJobName = NULL;
+
+        if (err[i] != LSBE_NO_ERROR
+            || reply.replies[j].jobId <= 0) {
+            if (err[i] == LSBE_NO_ERROR)
+                err[i] = LSBE_PROTOCOL;
+            rmSubSpoolFiles(&pack.spool[j]);
+            continue;
+        }
+
+        jobId[i] = reply.replies[j].jobId;
+        ++numSub;
+        if (!getenv("BSUB_QUIET"))
+            postSubMsg(&jobSubReq[i], jobId[i], &submitRep[i]);
+    }
+    freeSubmitPackReply(&reply);
+    lsberrno = LSBE_NO_ERROR;
+
+    goto out;
+
+fail:
+    /* The pack did not make it, none of its
+     * jobs is submitted.
+     */
+    for (j = 0; j < pack.num; j++) {
+        err[idx[j]] = lsberrno;
+        rmSubSpoolFiles(&pack.spool[j]);
+    }
+
+out:
+    if (pack.jf) {
+        for (j = 0; j < pack.num; j++)
+            FREEUP(pack.jf[j].data);
+    }
+    FREEUP(pack.jf);
+    FREEUP(pack.spool);
+    FREEUP(pack.buf);
+    FREEUP(idx);
+
+    return numSub;
+}
+
+/* subPackJob()
+ *
+ * Prepare one job of a pack, its encoded submitReq is
+ * appended to the pack buffer.
+ */
+static int
+subPackJob(struct submit *jobSubReq,
+           struct submitReply *submitRep,
+           struct lsfAuth *auth,
+           struct subPackReq *pack)
+{
+    struct submitReq submitReq;
+    struct LSFHeader hdr;
+    LSB_SUB_SPOOL_FILE_T *subSpoolFiles;
+    struct lenData *jf;
+    char cwd[MAXFILENAMELEN];
+    char homeDir[MAXFILENAMELEN];
+    char resReq[MAXLINELEN];
+    char cmd[MAXLINELEN];
+    XDR xdrs;
+    char *p;
+    int size;
+
+    if ((jobSubReq->options & (SUB_INTERACTIVE | SUB_RESTART))
+        || (jobSubReq->options2 & SUB2_BSUB_BLOCK)) {
+        lsberrno = LSBE_BAD_ARG;
+        return -1;
+    }
+
+    if (subInit(jobSubReq, &submitReq, submitRep, cwd) < 0)
+        return -1;
+
+    /* The esub may have changed the job.
+     */
+    if ((submitReq.options & (SUB_INTERACTIVE | SUB_RESTART))
+        || (submitReq.options2 & SUB2_BSUB_BLOCK)) {
+        lsberrno = LSBE_BAD_ARG;
+        return -1;
+    }
+
+    subSpoolFiles = &pack->spool[pack->num];
+    jf = &pack->jf[pack->num];
+    subSpoolFiles->inFileSpool[0] = 0;
+    subSpoolFiles->commandSpool[0] = 0;
+
+    submitReq.subHomeDir = homeDir;
+    submitReq.resReq = resReq;
+    submitReq.command = cmd;
+
+    if (getOtherParams(jobSubReq, &submitReq, submitRep, auth,
+                       subSpoolFiles) < 0)
+        goto fail;
+
+    if (createJobInfoFile(jobSubReq, jf) == -1)
+        goto fail;
+
+    size = xdrSubReqSize(&submitReq);
+    if ((p = realloc(pack->buf, pack->len + size)) == NULL) {
+        lsberrno = LSBE_NO_MEM;
+        goto fail;
+    }
+    pack->buf = p;
+
+    initLSFHeader_(&hdr);
+    hdr.version = OPENLAVA_XDR_VERSION;
+    xdrmem_create(&xdrs, pack->buf + pack->len, size, XDR_ENCODE);
+    if (!xdr_submitReq(&xdrs, &submitReq, &hdr)) {
+        xdr_destroy(&xdrs);
+        lsberrno = LSBE_XDR;
+        goto fail;
+    }
+    pack->len += XDR_GETPOS(&xdrs);
+    xdr_destroy(&xdrs);
+
+    return 0;
+
+fail:
+    FREEUP(jf->data);
+    rmSubSpoolFiles(subSpoolFiles);
+    return -1;
+}
+
+/* xdr_subPackReq()
+ */
+static bool_t
+xdr_subPackReq(XDR *xdrs, struct subPackReq *pack, struct LSFHeader *hdr)
+{
+    if (!xdr_int(xdrs, &pack->num))
+        return false;
+
+    return XDR_PUTBYTES(xdrs, pack->buf, pack->len);
+}
+
+/* sndPackFiles()
+ */
+static int
+sndPackFiles(int s, struct subPackReq *pack)
+{
+    int i;
+
+    for (i = 0; i < pack->num; i++) {
+        if (sndJobFile_(s, &pack->jf[i]) < 0)
+            return -1;
+    }
+
+    return 0;
 }
 
 
@@ -2714,6 +3099,8 @@ bsub_usage(int options)
 	    fprintf(stderr, "\t    [-u mail_user] [-w ’dependency_expression’]\n");
 	    fprintf(stderr, "\t    [-W [hours:]minutes[/host_name | /host_model]]\n");
 	    fprintf(stderr, "\t    [-Zs]\n");
+	    fprintf(stderr, "\t    command [argument]\n");
+	    fprintf(stderr, "       bsub -pack job_file\n");
 	    break;
     }
 
@@ -3999,6 +4386,81 @@ checkLimit(int limit, int factor)
 
 int
 runBatchEsub(struct lenData *ed, struct submit *jobSubReq)
+{
+    int cc;
+    char parmFile[MAXFILENAMELEN], esub[MAXFILENAMELEN];
+    FILE *parmfp;
+    struct stat sbuf;
+
+    /* The esub runs in the submitting process,
+     * see esubCall().
+     */
+    if (esubInProcess()) {
+        ed->len = 0;
+        ed->data = NULL;
+        return 0;
+    }
+
+    sprintf (esub, "%s/%s", lsbParams[LSB_SERVERDIR].paramValue, "esub");
+    if (stat(esub, &sbuf) < 0)
+        return 0;
+
+
+    sprintf(parmFile, "%s/.lsbsubparm.%d", LSTMPDIR, (int)getpid());
+
+    if ((parmfp = fopen(parmFile, "w")) == NULL) {
+        lsberrno = LSBE_SYS_CALL;
+        return -1;
+    }
+
+    chmod(parmFile, 0666);
+
+    writeEsubParms(parmfp, jobSubReq);
+    fclose(parmfp);
+
+    putEnv("LSB_SUB_ABORT_VALUE", "97");
+    putEnv("LSB_SUB_PARM_FILE", parmFile);
+
+    if ((cc = runEsub_(ed, NULL)) < 0) {
+        if (logclass & LC_TRACE)
+            ls_syslog(LOG_DEBUG, "%s: runEsub_() failed %d: %M", __func__, cc);
+        if (cc == -2) {
+            char *deltaFileName=NULL;
+            struct stat stbuf;
+
+            lsberrno = LSBE_ESUB_ABORT;
+            unlink(parmFile);
+
+
+            if( (deltaFileName=getenv("LSB_SUB_MODIFY_FILE")) != NULL )
+            {
+                if(stat(deltaFileName, &stbuf)!=ENOENT)
+                    unlink(deltaFileName);
+            }
+
+            deltaFileName=NULL;
+            if( (deltaFileName=getenv("LSB_SUB_MODIFY_ENVFILE")) != NULL )
+            {
+                if(stat(deltaFileName, &stbuf)!=ENOENT)
+                    unlink(deltaFileName);
+            }
+            return -1;
+        }
+    }
+
+    unlink(parmFile);
+
+    return 0;
+
+}
+
+/* writeEsubParms()
+ *
+ * Write the job parameters in the format of the
+ * esub parameter file LSB_SUB_PARM_FILE.
+ */
+void
+writeEsubParms(FILE *parmfp, struct submit *jobSubReq)
 {
     char *subRLimitName[LSF_RLIM_NLIMITS] = {"LSB_SUB_RLIMIT_CPU",
                                              "LSB_SUB_RLIMIT_FSIZE",
@@ -4011,10 +4473,7 @@ runBatchEsub(struct lenData *ed, struct submit *jobSubReq)
                                              "LSB_SUB_RLIMIT_SWAP",
                                              "LSB_SUB_RLIMIT_RUN",
                                              "LSB_SUB_RLIMIT_PROCESS"};
-    int cc, i;
-    char parmFile[MAXFILENAMELEN], esub[MAXFILENAMELEN];
-    FILE *parmfp;
-    struct stat sbuf;
+    int i;
 #define LSB_SUB_COMMANDNAME 0
     struct config_param myParams[] = { {"LSB_SUB_COMMANDNAME", NULL},
                                        {NULL, NULL} };
@@ -4122,21 +4581,6 @@ runBatchEsub(struct lenData *ed, struct submit *jobSubReq)
         }                                                       \
     }
 
-
-    sprintf (esub, "%s/%s", lsbParams[LSB_SERVERDIR].paramValue, "esub");
-    if (stat(esub, &sbuf) < 0)
-        return 0;
-
-
-    sprintf(parmFile, "%s/.lsbsubparm.%d", LSTMPDIR, (int)getpid());
-
-    if ((parmfp = fopen(parmFile, "w")) == NULL) {
-        lsberrno = LSBE_SYS_CALL;
-        return -1;
-    }
-
-    chmod(parmFile, 0666);
-
     SET_PARM_STR(SUB_JOB_NAME, "LSB_SUB_JOB_NAME", jobSubReq, jobName);
     SET_PARM_STR(SUB_QUEUE, "LSB_SUB_QUEUE", jobSubReq, queue);
     SET_PARM_STR(SUB_IN_FILE, "LSB_SUB_IN_FILE", jobSubReq, inFile);
@@ -4326,43 +4770,6 @@ runBatchEsub(struct lenData *ed, struct submit *jobSubReq)
     if(additionEsubInfo!=NULL) {
         fprintf(parmfp,"LSB_SUB_ADDITIONAL=\"%s\"\n",additionEsubInfo);
     }
-
-    fclose(parmfp);
-
-    putEnv("LSB_SUB_ABORT_VALUE", "97");
-    putEnv("LSB_SUB_PARM_FILE", parmFile);
-
-    if ((cc = runEsub_(ed, NULL)) < 0) {
-        if (logclass & LC_TRACE)
-            ls_syslog(LOG_DEBUG, "%s: runEsub_() failed %d: %M", __func__, cc);
-        if (cc == -2) {
-            char *deltaFileName=NULL;
-            struct stat stbuf;
-
-            lsberrno = LSBE_ESUB_ABORT;
-            unlink(parmFile);
-
-
-            if( (deltaFileName=getenv("LSB_SUB_MODIFY_FILE")) != NULL )
-            {
-                if(stat(deltaFileName, &stbuf)!=ENOENT)
-                    unlink(deltaFileName);
-            }
-
-            deltaFileName=NULL;
-            if( (deltaFileName=getenv("LSB_SUB_MODIFY_ENVFILE")) != NULL )
-            {
-                if(stat(deltaFileName, &stbuf)!=ENOENT)
-                    unlink(deltaFileName);
-            }
-            return -1;
-        }
-    }
-
-    unlink(parmFile);
-
-    return 0;
-
 }
 
 static int
@@ -4488,10 +4895,14 @@ void makeCleanToRunEsub()
     putEnv("LSB_SUB_MODIFY_ENVFILE",envDeltaFile);
 }
 
-void modifyJobInformation(struct submit *jobSubReq)
+/* readEsubParms()
+ *
+ * Apply to the job the parameters changed by the esub
+ * in the format of the LSB_SUB_MODIFY_FILE.
+ */
+void
+readEsubParms(FILE *fp, struct submit *jobSubReq)
 {
-    char parmDeltaFile[MAXPATHLEN];
-    char envDeltaFile[MAXPATHLEN];
     int validKey,v;
     char *sValue;
 
@@ -4508,7 +4919,6 @@ void modifyJobInformation(struct submit *jobSubReq)
 #define FIELD_OFFSET(type,field) (long)(&(((struct type *)0)->field))
 #define FIELD_PTR_PTR(base,offset) (((char *)base)+offset)
 
-    FILE *fp;
     int  lineNum;
     char *line=NULL,*key;
     static struct {
@@ -4599,272 +5009,305 @@ void modifyJobInformation(struct submit *jobSubReq)
               {NULL,0,0,0}
           };
 
-    sprintf(parmDeltaFile, "%s/.lsbsubdeltaparm.%d.%d",
-            LSTMPDIR, (int)getpid(), (int)getuid());
-    sprintf(envDeltaFile, "%s/.lsbsubdeltaenv.%d.%d",
-            LSTMPDIR, (int)getpid(), (int)getuid());
-
-    if(access(parmDeltaFile,R_OK)==F_OK) {
-        fp=fopen(parmDeltaFile,"r");
-        lineNum=0;
+    lineNum=0;
+    while((line=getNextLineC_(fp,&lineNum,TRUE))!=NULL) {
+        int i,j;
 
-        while((line=getNextLineC_(fp,&lineNum,TRUE))!=NULL) {
-            int i,j;
+        key=getNextWordSet(&line," \t=!@#$%^&*()");
 
-            key=getNextWordSet(&line," \t=!@#$%^&*()");
+        while(*line!='=') line++;
+        line++;
+        while(isspace((int)*line)) line++;
 
-            while(*line!='=') line++;
-            line++;
-            while(isspace((int)*line)) line++;
+        validKey=0;
 
-            validKey=0;
-
-
-            if (strncmp(key,"LSB_SUB_OTHER_FILES",
-                        strlen("LSB_SUB_OTHER_FILES"))==0) {
-                processXFReq(key,line,jobSubReq);
-                continue;
-            }
 
-            for(i=0;jobSubReqParams[i].parmName;i++) {
-                if(strcmp(key,jobSubReqParams[i].parmName)==0) {
-                    validKey=1;
-
-                    switch (jobSubReqParams[i].parmType) {
-                        case STRPARM:
-                            if(checkEmptyString(line)) {
-                                ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
-                                          __func__,key);
-                                break;
-                            }
-
-                            if ((strcmp(key,"LSB_SUB_COMMAND_LINE")==0) &&
-                                (jobSubReq->options & SUB_RESTART)) {
-
-                                break;
-                            }
+        if (strncmp(key,"LSB_SUB_OTHER_FILES",
+                    strlen("LSB_SUB_OTHER_FILES"))==0) {
+            processXFReq(key,line,jobSubReq);
+            continue;
+        }
 
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                jobSubReq->options &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions |= jobSubReqParams[i].subOption;
-                            }
-                            else {
+        for(i=0;jobSubReqParams[i].parmName;i++) {
+            if(strcmp(key,jobSubReqParams[i].parmName)==0) {
+                validKey=1;
 
-                                sValue=extractStringValue(line);
-                                if(sValue==NULL) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
-                                              __func__,line,key);
-                                    break;
-                                }
+                switch (jobSubReqParams[i].parmType) {
+                    case STRPARM:
+                        if(checkEmptyString(line)) {
+                            ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
+                                      __func__,key);
+                            break;
+                        }
 
-                                if(strcmp(key,"LSB_SUB_COMMAND_LINE")!=0) {
-                                    *(char **)(FIELD_PTR_PTR(
-                                                   jobSubReq,
-                                                   jobSubReqParams[i].fieldOffset))
-                                        =putstr_(sValue);
-                                }
-                                else {
-                                    *(char **)(FIELD_PTR_PTR(
-                                                   jobSubReq,
-                                                   jobSubReqParams[i].fieldOffset))
-                                        =wrapCommandLine(sValue);
-                                    if(jobSubReq->options & SUB_MODIFY) {
-                                        jobSubReq->newCommand=jobSubReq->command;
-                                        jobSubReq->options2 |= SUB2_MODIFY_CMD;
-                                        jobSubReq->delOptions2 &= ~SUB2_MODIFY_CMD;
-                                    }
-                                }
+                        if ((strcmp(key,"LSB_SUB_COMMAND_LINE")==0) &&
+                            (jobSubReq->options & SUB_RESTART)) {
 
-                                jobSubReq->options |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
-                            }
                             break;
-                        case INTPARM:
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                jobSubReq->options &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions |= jobSubReqParams[i].subOption;
-                            }
-                            else {
-                                if (!stringIsDigitNumber(line)) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
-                                              __func__,line,key);
-                                    break;
-                                }
+                        }
 
-                                v=atoi(line);
-                                *(int *)(FIELD_PTR_PTR(
-                                             jobSubReq,
-                                             jobSubReqParams[i].fieldOffset))
-                                    =v;
-                                jobSubReq->options |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
-                            }
-                            break;
-                        case BOOLPARM:
-                            if(stringIsToken(line,"Y")) {
-                                jobSubReq->options |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
-                            }
-                            else if (stringIsToken(line,"SUB_RESET")){
-                                jobSubReq->options &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions |= jobSubReqParams[i].subOption;
-                            }
-                            else {
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            jobSubReq->options &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions |= jobSubReqParams[i].subOption;
+                        }
+                        else {
 
-                                ls_syslog(LOG_WARNING,MSG_BAD_BOOLVAL3s,
+                            sValue=extractStringValue(line);
+                            if(sValue==NULL) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
                                           __func__,line,key);
-                            }
-                            break;
-                        case STR2PARM:
-                            if(checkEmptyString(line)) {
-                                ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
-                                          __func__,key);
                                 break;
                             }
 
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
-                            }
-                            else {
-
-                                sValue=extractStringValue(line);
-                                if(sValue==NULL) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
-                                              __func__,line,key);
-                                    break;
-                                }
-
+                            if(strcmp(key,"LSB_SUB_COMMAND_LINE")!=0) {
                                 *(char **)(FIELD_PTR_PTR(
                                                jobSubReq,
                                                jobSubReqParams[i].fieldOffset))
                                     =putstr_(sValue);
-
-                                jobSubReq->options2 |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
-                            }
-                            break;
-                        case INT2PARM:
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
                             }
                             else {
-                                if (!stringIsDigitNumber(line)) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
-                                              __func__,line,key);
-                                    break;
+                                *(char **)(FIELD_PTR_PTR(
+                                               jobSubReq,
+                                               jobSubReqParams[i].fieldOffset))
+                                    =wrapCommandLine(sValue);
+                                if(jobSubReq->options & SUB_MODIFY) {
+                                    jobSubReq->newCommand=jobSubReq->command;
+                                    jobSubReq->options2 |= SUB2_MODIFY_CMD;
+                                    jobSubReq->delOptions2 &= ~SUB2_MODIFY_CMD;
                                 }
-
-                                v=atoi(line);
-                                *(int *)(FIELD_PTR_PTR(
-                                             jobSubReq,
-                                             jobSubReqParams[i].fieldOffset))
-                                    =v;
-                                jobSubReq->options2 |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
                             }
-                            break;
-                        case BOOL2PARM:
-                            if(stringIsToken(line,"Y")) {
-                                jobSubReq->options2 |= jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
-                            }
-                            else if (stringIsToken(line,"SUB_RESET")){
-                                jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
-                                jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
-                            }
-                            else {
 
-                                ls_syslog(LOG_WARNING,MSG_BAD_BOOLVAL3s,
+                            jobSubReq->options |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
+                        }
+                        break;
+                    case INTPARM:
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            jobSubReq->options &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions |= jobSubReqParams[i].subOption;
+                        }
+                        else {
+                            if (!stringIsDigitNumber(line)) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
                                           __func__,line,key);
+                                break;
                             }
+
+                            v=atoi(line);
+                            *(int *)(FIELD_PTR_PTR(
+                                         jobSubReq,
+                                         jobSubReqParams[i].fieldOffset))
+                                =v;
+                            jobSubReq->options |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
+                        }
+                        break;
+                    case BOOLPARM:
+                        if(stringIsToken(line,"Y")) {
+                            jobSubReq->options |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions &= ~jobSubReqParams[i].subOption;
+                        }
+                        else if (stringIsToken(line,"SUB_RESET")){
+                            jobSubReq->options &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions |= jobSubReqParams[i].subOption;
+                        }
+                        else {
+
+                            ls_syslog(LOG_WARNING,MSG_BAD_BOOLVAL3s,
+                                      __func__,line,key);
+                        }
+                        break;
+                    case STR2PARM:
+                        if(checkEmptyString(line)) {
+                            ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
+                                      __func__,key);
                             break;
-                        case NUMPARM:
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                *(int *)(FIELD_PTR_PTR(
-                                             jobSubReq,
-                                             jobSubReqParams[i].fieldOffset))=
-                                    jobSubReqParams[i].subOption;
-                            }
-                            else {
-                                if (!stringIsDigitNumber(line)) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
-                                              __func__,line,key);
-                                    break;
-                                }
+                        }
 
-                                v=atoi(line);
-                                *(int *)(FIELD_PTR_PTR(
-                                             jobSubReq,
-                                             jobSubReqParams[i].fieldOffset))
-                                    =v;
-                            }
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
+                        }
+                        else {
 
-                            if (jobSubReq->maxNumProcessors<jobSubReq->numProcessors) {
-                                jobSubReq->maxNumProcessors=jobSubReq->numProcessors;
+                            sValue=extractStringValue(line);
+                            if(sValue==NULL) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
+                                          __func__,line,key);
+                                break;
                             }
 
-                            break;
-                        case RLIMPARM:
-                            j=jobSubReqParams[i].fieldOffset;
-                            if(stringIsToken(line,"SUB_RESET")) {
-                                jobSubReq->rLimits[j]=DELETE_NUMBER;
-                            }
-                            else {
-                                if (!stringIsDigitNumber(line)) {
-                                    ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
-                                              __func__,line,key);
-                                    break;
-                                }
+                            *(char **)(FIELD_PTR_PTR(
+                                           jobSubReq,
+                                           jobSubReqParams[i].fieldOffset))
+                                =putstr_(sValue);
 
-                                v=atoi(line);
-                                jobSubReq->rLimits[j]=v;
-                            }
-                            break;
-                        case STRSPARM:
-                            if(checkEmptyString(line)) {
-                                ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
-                                          __func__,key);
+                            jobSubReq->options2 |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
+                        }
+                        break;
+                    case INT2PARM:
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
+                        }
+                        else {
+                            if (!stringIsDigitNumber(line)) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
+                                          __func__,line,key);
                                 break;
                             }
 
-                            sValue=extractStringValue(line);
-                            if(sValue==NULL) {
-                                ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
+                            v=atoi(line);
+                            *(int *)(FIELD_PTR_PTR(
+                                         jobSubReq,
+                                         jobSubReqParams[i].fieldOffset))
+                                =v;
+                            jobSubReq->options2 |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
+                        }
+                        break;
+                    case BOOL2PARM:
+                        if(stringIsToken(line,"Y")) {
+                            jobSubReq->options2 |= jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 &= ~jobSubReqParams[i].subOption;
+                        }
+                        else if (stringIsToken(line,"SUB_RESET")){
+                            jobSubReq->options2 &= ~jobSubReqParams[i].subOption;
+                            jobSubReq->delOptions2 |= jobSubReqParams[i].subOption;
+                        }
+                        else {
+
+                            ls_syslog(LOG_WARNING,MSG_BAD_BOOLVAL3s,
+                                      __func__,line,key);
+                        }
+                        break;
+                    case NUMPARM:
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            *(int *)(FIELD_PTR_PTR(
+                                         jobSubReq,
+                                         jobSubReqParams[i].fieldOffset))=
+                                jobSubReqParams[i].subOption;
+                        }
+                        else {
+                            if (!stringIsDigitNumber(line)) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
                                           __func__,line,key);
                                 break;
                             }
 
-                            if (strcmp(key,"LSB_SUB_HOSTS")==0) {
-                                int badIdx;
+                            v=atoi(line);
+                            *(int *)(FIELD_PTR_PTR(
+                                         jobSubReq,
+                                         jobSubReqParams[i].fieldOffset))
+                                =v;
+                        }
 
-                                if(getAskedHosts_(sValue,
-                                                  &jobSubReq->askedHosts,
-                                                  &jobSubReq->numAskedHosts,
-                                                  &badIdx,FALSE)<0) {
-                                    jobSubReq->options &= ~SUB_HOST;
-                                    ls_syslog(LOG_WARNING,ls_sysmsg());
-                                }
-                                else {
-                                    jobSubReq->options |= SUB_HOST;
-                                }
+                        if (jobSubReq->maxNumProcessors<jobSubReq->numProcessors) {
+                            jobSubReq->maxNumProcessors=jobSubReq->numProcessors;
+                        }
+
+                        break;
+                    case RLIMPARM:
+                        j=jobSubReqParams[i].fieldOffset;
+                        if(stringIsToken(line,"SUB_RESET")) {
+                            jobSubReq->rLimits[j]=DELETE_NUMBER;
+                        }
+                        else {
+                            if (!stringIsDigitNumber(line)) {
+                                ls_syslog(LOG_WARNING,MSG_BAD_INTVAL3s,
+                                          __func__,line,key);
+                                break;
                             }
-                            break;
-                        default:
-                            ls_syslog(LOG_WARNING,MSG_BAD_ENVAR2s,
+
+                            v=atoi(line);
+                            jobSubReq->rLimits[j]=v;
+                        }
+                        break;
+                    case STRSPARM:
+                        if(checkEmptyString(line)) {
+                            ls_syslog(LOG_WARNING,MSG_WARN_NULLVAL2s,
                                       __func__,key);
                             break;
-                    }
-                    break;
+                        }
+
+                        sValue=extractStringValue(line);
+                        if(sValue==NULL) {
+                            ls_syslog(LOG_WARNING,MSG_BAD_ENVAL3s,
+                                      __func__,line,key);
+                            break;
+                        }
+
+                        if (strcmp(key,"LSB_SUB_HOSTS")==0) {
+                            int badIdx;
+
+                            if(getAskedHosts_(sValue,
+                                              &jobSubReq->askedHosts,
+                                              &jobSubReq->numAskedHosts,
+                                              &badIdx,FALSE)<0) {
+                                jobSubReq->options &= ~SUB_HOST;
+                                ls_syslog(LOG_WARNING,ls_sysmsg());
+                            }
+                            else {
+                                jobSubReq->options |= SUB_HOST;
+                            }
+                        }
+                        break;
+                    default:
+                        ls_syslog(LOG_WARNING,MSG_BAD_ENVAR2s,
+                                  __func__,key);
+                        break;
                 }
+                break;
             }
+        }
 
-            if (!validKey) {
-                ls_syslog(LOG_WARNING,MSG_BAD_ENVAR2s,
-                          __func__,key);
-            }
+        if (!validKey) {
+            ls_syslog(LOG_WARNING,MSG_BAD_ENVAR2s,
+                      __func__,key);
         }
+    }
+}
+
+/* readEsubEnv()
+ *
+ * Set the environment variables changed by the esub
+ * in the format of the LSB_SUB_MODIFY_ENVFILE.
+ */
+void
+readEsubEnv(FILE *fp)
+{
+    int lineNum;
+    char *line;
+    char *key;
+
+    lineNum=0;
+
+    while((line=getNextLineC_(fp,&lineNum,TRUE))!=NULL) {
+
+        key=getNextWordSet(&line," \t =!@#$%^&*()");
+        while(*line!='=') line++;
+
+        line++;
+
+        putEnv(key,getNextValueQ_(&line,'"','"'));
+    }
+}
+
+void modifyJobInformation(struct submit *jobSubReq)
+{
+    char parmDeltaFile[MAXPATHLEN];
+    char envDeltaFile[MAXPATHLEN];
+    FILE *fp;
+
+    sprintf(parmDeltaFile, "%s/.lsbsubdeltaparm.%d.%d",
+            LSTMPDIR, (int)getpid(), (int)getuid());
+    sprintf(envDeltaFile, "%s/.lsbsubdeltaenv.%d.%d",
+            LSTMPDIR, (int)getpid(), (int)getuid());
+
+    if(access(parmDeltaFile,R_OK)==F_OK) {
+        fp=fopen(parmDeltaFile,"r");
+        readEsubParms(fp, jobSubReq);
         fclose(fp);
 
         unlink(parmDeltaFile);
@@ -4874,17 +5317,7 @@ void modifyJobInformation(struct submit *jobSubReq)
 
     if(access(envDeltaFile,R_OK)==F_OK) {
         fp=fopen(envDeltaFile,"r");
-        lineNum=0;
-
-        while((line=getNextLineC_(fp,&lineNum,TRUE))!=NULL) {
-
-            key=getNextWordSet(&line," \t =!@#$%^&*()");
-            while(*line!='=') line++;
-
-            line++;
-
-            putEnv(key,getNextValueQ_(&line,'"','"'));
-        }
+        readEsubEnv(fp);
         fclose(fp);
         unlink(envDeltaFile);
     }
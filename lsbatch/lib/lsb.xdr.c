@@ -403,6 +403,81 @@ xdr_submitMbdReply(XDR *xdrs,
     return true;
 }
 
+/* xdr_submitPackReply()
+ *
+ * The reply to a pack of submissions, the error code and the
+ * submitMbdReply of every job in the order they were sent.
+ * The decode allocates the arrays and the strings.
+ */
+bool_t
+xdr_submitPackReply(XDR *xdrs,
+                    struct submitPackReply *reply,
+                    struct LSFHeader *hdr)
+{
+    struct submitMbdReply *r;
+    int i;
+
+    if (!xdr_int(xdrs, &reply->numJobs))
+        return false;
+
+    if (xdrs->x_op == XDR_DECODE) {
+        reply->errs = NULL;
+        reply->replies = NULL;
+        if (reply->numJobs <= 0)
+            return true;
+        reply->errs = calloc(reply->numJobs, sizeof(int));
+        reply->replies = calloc(reply->numJobs,
+                                sizeof(struct submitMbdReply));
+        if (reply->errs == NULL
+            || reply->replies == NULL) {
+            FREEUP(reply->errs);
+            FREEUP(reply->replies);
+            lsberrno = LSBE_NO_MEM;
+            return false;
+        }
+    }
+
+    for (i = 0; i < reply->numJobs; i++) {
+
+        r = &reply->replies[i];
+        if (!xdr_int(xdrs, &reply->errs[i])
+            || !xdr_submitMbdReply(xdrs, r, hdr))
+            break;
+
+        if (xdrs->x_op == XDR_DECODE) {
+            r->queue = strdup(r->queue);
+            r->badJobName = strdup(r->badJobName);
+        }
+    }
+
+    if (i < reply->numJobs) {
+        if (xdrs->x_op == XDR_DECODE) {
+            reply->replies[i].queue = NULL;
+            reply->replies[i].badJobName = NULL;
+            freeSubmitPackReply(reply);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void
+freeSubmitPackReply(struct submitPackReply *reply)
+{
+    int i;
+
+    if (reply->replies) {
+        for (i = 0; i < reply->numJobs; i++) {
+            FREEUP(reply->replies[i].queue);
+            FREEUP(reply->replies[i].badJobName);
+        }
+    }
+    FREEUP(reply->errs);
+    FREEUP(reply->replies);
+    reply->numJobs = 0;
+}
+
 bool_t
 xdr_parameterInfo(XDR *xdrs,
                   struct parameterInfo *paramInfo,
@@ -2076,6 +2151,142 @@ xdr_jobdep(XDR *xdrs, struct job_dep *jobdep, struct LSFHeader *hdr)
     return true;
 }
 
+/* xdr_jobWatchReq()
+ */
+bool_t
+xdr_jobWatchReq(XDR *xdrs, struct jobWatchReq *req, struct LSFHeader *hdr)
+{
+    int i;
+
+    if (xdrs->x_op == XDR_DECODE)
+        req->jobIds = NULL;
+
+    if (! xdr_int(xdrs, &req->numJobs)
+        || req->numJobs <= 0
+        || req->numJobs > MAX_WATCH_JOBS)
+        return false;
+
+    if (xdrs->x_op == XDR_DECODE) {
+        req->jobIds = calloc(req->numJobs, sizeof(LS_LONG_INT));
+        if (req->jobIds == NULL)
+            return false;
+    }
+
+    for (i = 0; i < req->numJobs; i++) {
+        if (! xdr_jobID(xdrs, &req->jobIds[i], hdr)) {
+            if (xdrs->x_op == XDR_DECODE)
+                FREEUP(req->jobIds);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* xdr_jobWatchEnt()
+ */
+bool_t
+xdr_jobWatchEnt(XDR *xdrs, struct jobWatchEnt *ent, struct LSFHeader *hdr)
+{
+    if (! xdr_jobID(xdrs, &ent->jobId, hdr)
+        || ! xdr_int(xdrs, &ent->status)
+        || ! xdr_int(xdrs, &ent->reasons)
+        || ! xdr_int(xdrs, &ent->subreasons)
+        || ! xdr_int(xdrs, &ent->exitStatus))
+        return false;
+
+    return true;
+}
+
+/* xdr_seq()
+ * Event stream sequence numbers
+ * are sent as two 32 bits words.
+ */
+static bool_t
+xdr_seq(XDR *xdrs, LS_LONG_INT *seq)
+{
+    u_int hi;
+    u_int lo;
+
+    if (xdrs->x_op == XDR_ENCODE) {
+        hi = (u_int)(*seq >> 32);
+        lo = (u_int)(*seq & 0xffffffff);
+    }
+
+    if (! xdr_u_int(xdrs, &hi)
+        || ! xdr_u_int(xdrs, &lo))
+        return false;
+
+    if (xdrs->x_op == XDR_DECODE)
+        *seq = ((LS_LONG_INT)hi << 32) | lo;
+
+    return true;
+}
+
+/* xdr_eventStreamReq()
+ */
+bool_t
+xdr_eventStreamReq(XDR *xdrs,
+                   struct eventStreamReq *req,
+                   struct LSFHeader *hdr)
+{
+    if (! xdr_time_t(xdrs, &req->epoch)
+        || ! xdr_seq(xdrs, &req->seq)
+        || ! xdr_int(xdrs, &req->mask[0])
+        || ! xdr_int(xdrs, &req->mask[1]))
+        return false;
+
+    return true;
+}
+
+/* xdr_eventStreamReply()
+ */
+bool_t
+xdr_eventStreamReply(XDR *xdrs,
+                     struct eventStreamReply *reply,
+                     struct LSFHeader *hdr)
+{
+    if (! xdr_time_t(xdrs, &reply->epoch)
+        || ! xdr_seq(xdrs, &reply->first)
+        || ! xdr_seq(xdrs, &reply->seq))
+        return false;
+
+    return true;
+}
+
+/* xdr_eventStreamRec()
+ */
+bool_t
+xdr_eventStreamRec(XDR *xdrs,
+                   struct eventStreamRec *rec,
+                   struct LSFHeader *hdr)
+{
+    if (xdrs->x_op == XDR_DECODE)
+        rec->line = NULL;
+
+    if (! xdr_seq(xdrs, &rec->seq)
+        || ! xdr_wrapstring(xdrs, &rec->line))
+        return false;
+
+    return true;
+}
+
+/* xdr_perfInfoReply()
+ */
+bool_t
+xdr_perfInfoReply(XDR *xdrs,
+                  struct perfInfoReply *reply,
+                  struct LSFHeader *hdr)
+{
+    if (xdrs->x_op == XDR_DECODE)
+        reply->snapshot = NULL;
+
+    if (! xdr_wrapstring(xdrs, &reply->snapshot))
+        return false;
+
+    return true;
+}
+
 bool_t
 xdr_jobgroup(XDR *xdrs, struct job_group *jgPtr, struct LSFHeader *hdr)
 {
@@ -32,6 +32,11 @@ extern bool_t xdr_submitMbdReply(XDR *,
 				 struct submitMbdReply *,
 				 struct LSFHeader *);
 
+extern bool_t xdr_submitPackReply(XDR *,
+                                  struct submitPackReply *,
+                                  struct LSFHeader *);
+extern void freeSubmitPackReply(struct submitPackReply *);
+
 extern bool_t xdr_signalReq(XDR *,
 			    struct signalReq *,
 			    struct LSFHeader *);
@@ -160,6 +165,24 @@ extern bool_t xdr_jobID(XDR *,
                         LS_LONG_INT *,
                         struct LSFHeader *);
 extern bool_t xdr_jobdep(XDR *, struct job_dep *, struct LSFHeader *);
+extern bool_t xdr_jobWatchReq(XDR *,
+                              struct jobWatchReq *,
+                              struct LSFHeader *);
+extern bool_t xdr_jobWatchEnt(XDR *,
+                              struct jobWatchEnt *,
+                              struct LSFHeader *);
+extern bool_t xdr_eventStreamReq(XDR *,
+                                 struct eventStreamReq *,
+                                 struct LSFHeader *);
+extern bool_t xdr_eventStreamReply(XDR *,
+                                   struct eventStreamReply *,
+                                   struct LSFHeader *);
+extern bool_t xdr_eventStreamRec(XDR *,
+                                 struct eventStreamRec *,
+                                 struct LSFHeader *);
+extern bool_t xdr_perfInfoReply(XDR *,
+                                struct perfInfoReply *,
+                                struct LSFHeader *);
 extern bool_t xdr_jobgroup(XDR *, struct job_group *, struct LSFHeader *);
 extern bool_t xdr_resLimitReply(XDR *,
                     struct resLimitReply *,
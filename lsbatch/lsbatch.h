@@ -479,7 +479,8 @@
 #define    LSBE_NODEP_COND          133
 #define    LSBE_JGRP_NOTEMPTY       134  /* jgrp is not empty */
 #define    LSBE_JGRP_LIMIT          135  /* jgrp limit violated */
-#define    LSBE_NUM_ERR             136
+#define    LSBE_NO_STREAM           136  /* no event stream */
+#define    LSBE_NUM_ERR             137
 
 
 #define  SUB_JOB_NAME       0x01
@@ -629,6 +630,15 @@ struct submig {
 #define JGRP_ARRAY_INFO 0x1000
 #define JOBID_ONLY_ALL  0x02000
 #define ZOMBIE_JOB      0x04000
+/* Options to reduce the size of the job information
+ * stream, several jobs are sent in one message and the
+ * load thresholds or the file and directory names are
+ * left out. They are not a field projection, the rest of
+ * the submission request is still sent for every job.
+ */
+#define JOBINFO_PACK      0x08000
+#define JOBINFO_NO_LOAD   0x10000
+#define JOBINFO_NO_PATHS  0x20000
 
 #define    JGRP_NODE_JOB        1
 #define    JGRP_NODE_GROUP      2
@@ -930,6 +940,27 @@ struct job_dep {
     int depstatus;        /* dependency status */
 };
 
+/* Job state pushed by mbatchd to the
+ * lsb_watchjobs() connection, status is
+ * JOB_STAT_NULL for a job mbatchd does not know.
+ */
+struct jobWatchEnt {
+    LS_LONG_INT jobId;
+    int status;
+    int reasons;
+    int subreasons;
+    int exitStatus;
+};
+
+/* Position in the mbatchd event stream, epoch is
+ * the start time of mbatchd and seq numbers the
+ * records it logged since then.
+ */
+struct eventStreamPos {
+    time_t epoch;
+    LS_LONG_INT seq;
+};
+
 /* structure for lsb_addjgrp()/lsb_deljgrp()/lsb_modjgrp() call
  */
 struct job_group {
@@ -1645,6 +1676,8 @@ extern struct jobInfoHead *lsb_openjobinfo_a(LS_LONG_INT, char *,char *,
                                              char *, char *, int);
 extern struct jobInfoEnt *lsb_readjobinfo(int *);
 extern LS_LONG_INT lsb_submit(struct submit  *, struct submitReply *);
+extern int lsb_submit_batch(int, struct submit *, struct submitReply *,
+                            LS_LONG_INT *, int *);
 
 
 extern void lsb_closejobinfo(void);
@@ -1735,5 +1768,12 @@ extern struct resLimitReply *lsb_getlimits();
 extern void free_resLimits(struct resLimitReply *);
 extern void freeWeek (windows_t **);
 extern int lsb_launch(char **, char **, int, char **);
+extern int lsb_watchjobs(int, LS_LONG_INT *);
+extern int lsb_readwatch(int, struct jobWatchEnt *, int);
+extern void lsb_closewatch(int);
+extern int lsb_openstream(struct eventStreamPos *, int *, int);
+extern struct eventRec *lsb_readstream(int, LS_LONG_INT *, int);
+extern void lsb_closestream(int);
+extern char *lsb_perfinfo(void);
 
 #endif
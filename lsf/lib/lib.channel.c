@@ -47,6 +47,7 @@ static void doread(int , struct Masks *);
 static void dowrite(int, struct Masks *);
 static void doread2(int);
 static void dowrite2(int);
+static int connDone(int);
 
 static struct Buffer *newBuf(void);
 static void enqueueTail_(struct Buffer *, struct Buffer *);
@@ -254,6 +255,35 @@ chanConnect_(int chfd, struct sockaddr_in *peer, int timeout, int options)
         return 0;
     }
 
+    /* Do not wait for the connection, the channel stays
+     * in CH_PRECONN until the socket becomes writable and
+     * messages can be queued on it meanwhile.
+     */
+    if (options & CHAN_OP_NONBLOCK) {
+        if (io_nonblock_(channels[chfd].handle) < 0) {
+            lserrno = LSE_SOCK_SYS;
+            return -1;
+        }
+        channels[chfd].send = newBuf();
+        channels[chfd].recv = newBuf();
+        if (!channels[chfd].send || !channels[chfd].recv) {
+            lserrno = LSE_MALLOC;
+            return -1;
+        }
+        cc = connect(channels[chfd].handle, (struct sockaddr *) peer,
+                     sizeof(struct sockaddr_in));
+        if (SOCK_CALL_FAIL(cc)) {
+            if (errno != EINPROGRESS) {
+                lserrno = LSE_CONN_SYS;
+                return -1;
+            }
+            channels[chfd].state = CH_PRECONN;
+            return 0;
+        }
+        channels[chfd].state = CH_CONN;
+        return 0;
+    }
+
     if (timeout >= 0) {
         if (b_connect_(channels[chfd].handle, (struct sockaddr *) peer,
                        sizeof(struct sockaddr_in), timeout/1000) < 0) {
@@ -662,10 +692,13 @@ chanSelect_(struct Masks *sockmask,
         if (channels[i].state == CH_PRECONN) {
 
             if (FD_ISSET(channels[i].handle, &(sockmask->wmask))) {
-                channels[i].state = CH_CONN;
-                channels[i].send  = newBuf();
-                channels[i].recv  = newBuf();
-                FD_SET(i, &(chanmask->wmask));
+                if (connDone(i) < 0) {
+                    FD_SET(i, &(chanmask->emask));
+                } else {
+                    if (channels[i].send->forw != channels[i].send)
+                        dowrite(i, chanmask);
+                    FD_SET(i, &(chanmask->wmask));
+                }
             }
 
         } else {
@@ -705,8 +738,9 @@ chanEnqueue_(int chfd, struct Buffer *msg)
         return -1;
     }
 
-    if (channels[chfd].handle == INVALID_HANDLE ||
-        channels[chfd].state == CH_PRECONN) {
+    if (channels[chfd].handle == INVALID_HANDLE
+        || (channels[chfd].state == CH_PRECONN
+            && channels[chfd].send == NULL)) {
         cherrno = CHANE_NOTCONN;
         return -1;
     }
@@ -877,6 +911,23 @@ chanSock_(int chfd)
     return(channels[chfd].handle);
 }
 
+/* chanSendQueued_()
+ * Does the channel still have messages to send.
+ */
+int
+chanSendQueued_(int chfd)
+{
+    if (chfd < 0 || chfd > chanMaxSize) {
+        lserrno = LSE_BAD_CHAN;
+        return -1;
+    }
+
+    if (channels[chfd].send == NULL)
+        return 0;
+
+    return channels[chfd].send->forw != channels[chfd].send;
+}
+
 int
 chanSetMode_(int chfd, int mode)
 {
@@ -1037,6 +1088,51 @@ dowrite(int chfd, struct Masks *chanmask)
     return;
 }
 
+/* connDone()
+ *
+ * A connection in progress became writable,
+ * check how the connect() went.
+ */
+static int
+connDone(int chfd)
+{
+    socklen_t len;
+    int err;
+
+    len = sizeof(err);
+    if (getsockopt(channels[chfd].handle,
+                   SOL_SOCKET, SO_ERROR, &err, &len) < 0
+        || err != 0) {
+        channels[chfd].chanerr = LSE_CONN_SYS;
+        return -1;
+    }
+
+    channels[chfd].state = CH_CONN;
+    if (!channels[chfd].send)
+        channels[chfd].send = newBuf();
+    if (!channels[chfd].recv)
+        channels[chfd].recv = newBuf();
+    if (!channels[chfd].send || !channels[chfd].recv) {
+        channels[chfd].chanerr = LSE_MALLOC;
+        return -1;
+    }
+
+    return 0;
+}
+
+/* chanPreconn_()
+ *
+ * Is the channel still connecting.
+ */
+int
+chanPreconn_(int chfd)
+{
+    if (chfd < 0 || chfd >= chanMaxSize)
+        return FALSE;
+
+    return channels[chfd].state == CH_PRECONN;
+}
+
 static struct Buffer *
 newBuf(void)
 {
@@ -1255,9 +1351,12 @@ chanPoll_(struct chanData **chans,
         if (channels[i].state == CH_PRECONN) {
 
 	    if (poll_array[j].revents & POLLOUT) {
-                channels[i].state = CH_CONN;
-                channels[i].send  = newBuf();
-                channels[i].recv  = newBuf();
+                if (connDone(i) < 0) {
+                    channels[i].revents = POLLERR;
+                    continue;
+                }
+                if (channels[i].send->forw != channels[i].send)
+                    dowrite2(i);
 		channels[i].revents |= POLLOUT;
             }
 
@@ -109,6 +109,7 @@ int chanAccept_(int, struct sockaddr_in *);
 
 int chanClientSocket_(int, int, int);
 int chanConnect_(int, struct sockaddr_in *, int , int);
+int chanPreconn_(int);
 
 int chanSendDgram_(int, char *, int , struct sockaddr_in *);
 int chanRcvDgram_(int , char *, int, struct sockaddr_in *, int);
@@ -125,6 +126,7 @@ int chanFreeBuf_(struct Buffer *);
 int chanFreeStashedBuf_(struct Buffer *);
 int chanOpenSock_(int , int);
 int chanSetMode_(int, int);
+int chanSendQueued_(int);
 extern int chanPoll_(struct chanData **,
 		     struct timeval *);
 
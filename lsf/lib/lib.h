@@ -115,7 +115,9 @@ typedef enum {
     NO_HOSTS_FILE,
     LSB_SHAREDIR,
     OL_CGROUP_ROOT,
-    NIOS_RWAIT_SELECT
+    NIOS_RWAIT_SELECT,
+    LSF_HOST_CACHE_TTL,
+    LSF_HOST_CACHE_NTTL
 } genparams_t;
 
 typedef struct lsRequest LS_REQUEST_T;
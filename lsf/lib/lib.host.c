@@ -30,14 +30,42 @@
 #define MAX_HOSTALIAS 64
 #define MAX_HOSTIPS   32
 
+/* Seconds a failed lookup is remembered
+ * unless LSF_HOST_CACHE_NTTL says otherwise.
+ */
+#define DEF_HOST_CACHE_NTTL 60
+
+/* A cached host. The hosts of the hosts file never
+ * expire, the ones learnt from the resolver expire
+ * after LSF_HOST_CACHE_TTL seconds, 0 meaning never.
+ * A negative entry has no h_name, it remembers for
+ * LSF_HOST_CACHE_NTTL seconds a name or an address
+ * the resolver does not know. When the resolver cannot
+ * answer an expired entry is kept for another period,
+ * so a DNS outage does not stall the daemons.
+ */
+struct hostCacheEnt {
+    struct hostent host;
+    time_t expire;
+    int conf;
+};
+
 static hTab *nameTab;
 static hTab *addrTab;
+static time_t hostTTL;
+static time_t hostNTTL = DEF_HOST_CACHE_NTTL;
 
 static int mkHostTab(void);
 static void stripDomain(char *);
-static void addHost2Tab(const char *,
-                        in_addr_t **,
-                        char **);
+static struct hostCacheEnt *addHost2Tab(const char *,
+                                        in_addr_t **,
+                                        char **,
+                                        int);
+static time_t cacheParam(genparams_t, time_t);
+static int cacheExpired(struct hostCacheEnt *);
+static struct hostent *cacheHost(struct hostCacheEnt *);
+static struct hostCacheEnt *cacheMiss(hTab *, const char *, hEnt *);
+static void cacheSet(hTab *, const char *, struct hostCacheEnt *, int);
 /* ls_getmyhostname()
  */
 char *
@@ -66,9 +94,9 @@ ls_getmyhostname(void)
 struct hostent *
 Gethostbyname_(char *hname)
 {
-    int cc;
     hEnt *e;
     struct hostent *hp;
+    struct hostCacheEnt *ce;
     char lsfHname[MAXHOSTNAMELEN];
 
     if (strlen(hname) >= MAXHOSTNAMELEN) {
@@ -91,40 +119,26 @@ Gethostbyname_(char *hname)
         mkHostTab();
 
     e = h_getEnt_(nameTab, lsfHname);
-    if (e) {
-        hp = e->hData;
-        return hp;
-    }
+    if (e && ! cacheExpired(e->hData))
+        return cacheHost(e->hData);
 
     hp = gethostbyname(lsfHname);
-    if (hp == NULL) {
-        lserrno = LSE_BAD_HOST;
-        return NULL;
-    }
+    if (hp == NULL)
+        return cacheHost(cacheMiss(nameTab, lsfHname, e));
     stripDomain(hp->h_name);
 
-    /* add the new host to the host hash table
+    /* add the new host to the host hash table,
+     * the name we were asked for may be an alias
+     * so hash the host by it as well.
      */
-    addHost2Tab(hp->h_name,
-                (in_addr_t **)hp->h_addr_list,
-                hp->h_aliases);
-
-    if (0) {
-        /* dybag should we write a command
-         * to dump the cache sooner or later.
-         */
-        cc = 0;
-        while (hp->h_addr_list[cc]) {
-            char *p;
-            struct in_addr a;
-            memcpy(&a, hp->h_addr_list[cc], sizeof(a));
-            p = inet_ntoa(a);
-            fprintf(stderr, "%s\n", p); /* could be closed */
-            ++cc;
-        }
-    }
-
-    return hp;
+    ce = addHost2Tab(hp->h_name,
+                     (in_addr_t **)hp->h_addr_list,
+                     hp->h_aliases,
+                     FALSE);
+    if (strcmp(lsfHname, ce->host.h_name) != 0)
+        cacheSet(nameTab, lsfHname, ce, TRUE);
+
+    return &ce->host;
 }
 
 /* Gethostbyaddr_()
@@ -133,6 +147,7 @@ struct hostent *
 Gethostbyaddr_(in_addr_t *addr, socklen_t len, int type)
 {
     struct hostent *hp;
+    struct hostCacheEnt *ce;
     static char ipbuf[32];
     hEnt *e;
 
@@ -145,22 +160,21 @@ Gethostbyaddr_(in_addr_t *addr, socklen_t len, int type)
     sprintf(ipbuf, "%u", *addr);
 
     e = h_getEnt_(addrTab, ipbuf);
-    if (e) {
-        hp = e->hData;
-        return hp;
-    }
+    if (e && ! cacheExpired(e->hData))
+        return cacheHost(e->hData);
 
     hp = gethostbyaddr(addr, len, type);
-    if (hp == NULL) {
-        lserrno = LSE_BAD_HOST;
-        return NULL;
-    }
+    if (hp == NULL)
+        return cacheHost(cacheMiss(addrTab, ipbuf, e));
     stripDomain(hp->h_name);
 
-    addHost2Tab(hp->h_name,
-                (in_addr_t **)hp->h_addr_list,
-                hp->h_aliases);
-    return hp;
+    ce = addHost2Tab(hp->h_name,
+                     (in_addr_t **)hp->h_addr_list,
+                     hp->h_aliases,
+                     FALSE);
+    cacheSet(addrTab, ipbuf, ce, TRUE);
+
+    return &ce->host;
 }
 
 #define ISBOUNDARY(h1, h2, len)  ( (h1[len]=='.' || h1[len]=='\0') && \
@@ -229,6 +243,9 @@ mkHostTab(void)
     if (initenv_(NULL, NULL) < 0)
         return -1;
 
+    hostTTL = cacheParam(LSF_HOST_CACHE_TTL, 0);
+    hostNTTL = cacheParam(LSF_HOST_CACHE_NTTL, DEF_HOST_CACHE_NTTL);
+
     if (genParams_[NO_HOSTS_FILE].paramValue)
         return -1;
 
@@ -276,7 +293,7 @@ mkHostTab(void)
          * 192.168.7.4 jumbo
          *     ...
          */
-        addHost2Tab(name, addr, alias);
+        addHost2Tab(name, addr, alias, TRUE);
 
         cc = 0;
         while (alias[cc]) {
@@ -292,34 +309,61 @@ mkHostTab(void)
 }
 
 /* addHost2Tab()
+ * Add or refresh the host, conf is TRUE for
+ * the hosts file whose entries the resolver
+ * does not override.
  */
-static void
+static struct hostCacheEnt *
 addHost2Tab(const char *hname,
             in_addr_t **addrs,
-            char **aliases)
+            char **aliases,
+            int conf)
 {
+    struct hostCacheEnt *ce;
     struct hostent *hp;
     char ipbuf[32];
     hEnt *e;
-    hEnt *e2;
     int new;
     int cc;
 
     /* add the host to the table by its name
      * if it exists already we must be processing
-     * another ipaddr for it.
+     * another ipaddr for it or refreshing it.
      */
     e = h_addEnt_(nameTab, hname, &new);
+    if (! new) {
+        ce = e->hData;
+        if (ce->conf && ! conf)
+            return ce;
+        if (ce->host.h_name == NULL) {
+            free(ce);
+            new = TRUE;
+        }
+    }
+
     if (new) {
-        hp = calloc(1, sizeof(struct hostent));
+        ce = calloc(1, sizeof(struct hostCacheEnt));
+        hp = &ce->host;
         hp->h_name = strdup(hname);
         hp->h_addrtype = AF_INET;
         hp->h_length = 4;
-        e->hData = hp;
+        ce->conf = conf;
+        e->hData = ce;
     } else {
-        hp = (struct hostent *)e->hData;
+        hp = &ce->host;
+        for (cc = 0; hp->h_aliases[cc]; cc++)
+            FREEUP(hp->h_aliases[cc]);
+        FREEUP(hp->h_aliases);
+        for (cc = 0; hp->h_addr_list[cc]; cc++)
+            FREEUP(hp->h_addr_list[cc]);
+        FREEUP(hp->h_addr_list);
     }
 
+    if (conf || hostTTL == 0)
+        ce->expire = 0;
+    else
+        ce->expire = time(NULL) + hostTTL;
+
     cc = 0;
     while (aliases[cc])
         ++cc;
@@ -343,23 +387,133 @@ addHost2Tab(const char *hname,
          * must be unique...
          */
         sprintf(ipbuf, "%u", *(addrs[cc]));
-        e2 = h_addEnt_(addrTab, ipbuf, &new);
-        /* If new is false it means this IP
-         * is configured for another host already,
-         * confusion is waiting down the road as
-         * Gethostbyadrr_() will always return the
+        /* If the IP is configured for another host
+         * already confusion is waiting down the road
+         * as Gethostbyadrr_() will always return the
          * first configured host.
          * 192.168.1.4 joe
          * 192.168.1.4 banana
          * when banana will call the library will
          * always tell you joe called.
          */
-        if (new)
-            e2->hData = hp;
+        cacheSet(addrTab, ipbuf, ce, FALSE);
 
         ++cc; /* nexte */
     }
+
+    return ce;
+}
+
+/* cacheParam()
+ */
+static time_t
+cacheParam(genparams_t param, time_t def)
+{
+    char *p;
+
+    p = genParams_[param].paramValue;
+    if (p == NULL)
+        return def;
+
+    if (! isint_(p)
+        || atoi(p) < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: invalid %s %s, using %d", __func__,
+                  genParams_[param].paramName, p, (int)def);
+        return def;
+    }
+
+    return atoi(p);
+}
+
+/* cacheExpired()
+ */
+static int
+cacheExpired(struct hostCacheEnt *ce)
+{
+    if (ce->expire == 0)
+        return FALSE;
+
+    return ce->expire <= time(NULL);
+}
+
+/* cacheHost()
+ */
+static struct hostent *
+cacheHost(struct hostCacheEnt *ce)
+{
+    if (ce == NULL
+        || ce->host.h_name == NULL) {
+        lserrno = LSE_BAD_HOST;
+        return NULL;
+    }
+
+    return &ce->host;
+}
+
+/* cacheMiss()
+ * The resolver failed to look up key. If it could
+ * not answer keep what we knew of it, e is its
+ * expired entry if any, else remember the failure.
+ */
+static struct hostCacheEnt *
+cacheMiss(hTab *tab, const char *key, hEnt *e)
+{
+    struct hostCacheEnt *ce;
+
+    if (e && h_errno == TRY_AGAIN) {
+        ce = e->hData;
+        if (ce->host.h_name)
+            ce->expire = time(NULL) + hostTTL;
+        else
+            ce->expire = time(NULL) + hostNTTL;
+        return ce;
+    }
+
+    if (hostNTTL == 0)
+        return NULL;
+
+    ce = calloc(1, sizeof(struct hostCacheEnt));
+    if (ce == NULL)
+        return NULL;
+    ce->expire = time(NULL) + hostNTTL;
+
+    cacheSet(tab, key, ce, TRUE);
+
+    return ce;
+}
+
+/* cacheSet()
+ * Hash ce by key. A valid entry of another host
+ * is replaced only if force is TRUE, a negative
+ * one is always replaced. The hosts are shared
+ * by their keys so only negative entries are freed.
+ */
+static void
+cacheSet(hTab *tab, const char *key, struct hostCacheEnt *ce, int force)
+{
+    struct hostCacheEnt *old;
+    hEnt *e;
+    int new;
+
+    e = h_addEnt_(tab, key, &new);
+    if (! new) {
+
+        old = e->hData;
+        if (old == ce)
+            return;
+
+        if (old->host.h_name) {
+            if (! force && ! cacheExpired(old))
+                return;
+        } else {
+            free(old);
+        }
+    }
+
+    e->hData = ce;
 }
+
 /* getAskedHosts_()
  */
 int
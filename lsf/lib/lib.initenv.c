@@ -46,6 +46,8 @@ struct config_param genParams_[] =
     {"LSB_SHAREDIR", NULL},
     {"OL_CGROUP_ROOT", NULL},
     {"NIOS_RWAIT_SELECT", NULL},
+    {"LSF_HOST_CACHE_TTL", NULL},
+    {"LSF_HOST_CACHE_NTTL", NULL},
     {NULL, NULL}
 };
 
@@ -27,6 +27,7 @@ extern char mustSendLoad;
 
 static int isUserOk(uid_t);
 static void doReopen(void);
+static int saveLimState(void);
 
 void
 reconfigReq(XDR *xdrs, struct sockaddr_in *from, struct LSFHeader *reqHdr)
@@ -83,11 +84,19 @@ reconfig(void)
     char *myargv[5];
     int i;
     int sdesc;
+    int stateFd;
     sigset_t newmask;
     pid_t pid;
 
     ls_syslog(LOG_INFO, "%s: Restarting LIM", __func__);
 
+    /* Save the load state of the cluster so that the
+     * new LIM does not have to learn all hosts again.
+     */
+    stateFd = -1;
+    if (masterMe)
+        stateFd = saveLimState();
+
     sigemptyset(&newmask);
     sigprocmask(SIG_SETMASK, &newmask, NULL);
 
@@ -125,8 +134,21 @@ reconfig(void)
             else
                 sdesc = 0;
 
-            for (i = sdesc; i < sysconf(_SC_OPEN_MAX); i++)
+            for (i = sdesc; i < sysconf(_SC_OPEN_MAX); i++) {
+                if (i == stateFd)
+                    continue;
                 close(i);
+            }
+
+            if (stateFd >= 0) {
+                /* putenv() keeps the string, it must outlive
+                 * this block until execvp().
+                 */
+                static char lsfLimState[MAXLINELEN];
+
+                sprintf(lsfLimState, "LSF_LIM_STATE=%d", stateFd);
+                putenv(lsfLimState);
+            }
 
             if (limLock.on) {
                 char lsfLimLock[MAXLINELEN];
@@ -542,3 +564,180 @@ doReopen(void)
 
     return;
 }
+
+/* saveLimState()
+ * Dump the load and status of the hosts known to the
+ * master into an unlinked temporary file whose descriptor
+ * is inherited by the re-exec'ed LIM.
+ */
+static int
+saveLimState(void)
+{
+    FILE *fp;
+    struct hostNode *hPtr;
+    int fd;
+    int i;
+
+    fp = tmpfile();
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "%s: tmpfile() failed %m", __func__);
+        return -1;
+    }
+
+    fprintf(fp, "%d\n", allInfo.numIndx);
+    for (i = 0; i < allInfo.numIndx; i++)
+        fprintf(fp, "%s\n", allInfo.resTable[i].name);
+
+    for (hPtr = myClusterPtr->hostList; hPtr; hPtr = hPtr->nextPtr) {
+
+        if (hPtr == myHostPtr
+            || hPtr->infoValid != TRUE
+            || LS_ISUNAVAIL(hPtr->status))
+            continue;
+
+        fprintf(fp, "%s %d %d %d %d %d %hu",
+                hPtr->hostName,
+                hPtr->statInfo.maxCpus,
+                hPtr->statInfo.maxMem,
+                hPtr->statInfo.maxSwap,
+                hPtr->statInfo.maxTmp,
+                hPtr->statInfo.nDisks,
+                hPtr->statInfo.portno);
+        for (i = 0; i < GET_INTNUM(allInfo.numIndx) + 1; i++)
+            fprintf(fp, " %d", hPtr->status[i]);
+        for (i = 0; i < allInfo.numIndx; i++)
+            fprintf(fp, " %g %g", hPtr->loadIndex[i], hPtr->uloadIndex[i]);
+        fprintf(fp, "\n");
+    }
+
+    if (fflush(fp) != 0) {
+        ls_syslog(LOG_ERR, "%s: fflush() failed %m", __func__);
+        fclose(fp);
+        return -1;
+    }
+    rewind(fp);
+
+    /* daemonize_() in the new LIM closes the
+     * standard descriptors, keep the state above them.
+     */
+    fd = fileno(fp);
+    if (fd < 3) {
+        fd = fcntl(fd, F_DUPFD, 3);
+        if (fd < 0)
+            ls_syslog(LOG_ERR, "%s: fcntl() failed %m", __func__);
+        fclose(fp);
+    }
+
+    return fd;
+}
+
+/* restoreLimState()
+ * Restore the host load saved by the LIM we were re-exec'ed
+ * from. Hosts removed from the configuration are skipped and
+ * if the load indices have changed nothing is restored,
+ * the master then learns the hosts as usual.
+ */
+void
+restoreLimState(void)
+{
+    char *sp;
+    FILE *fp;
+    struct hostNode *hPtr;
+    struct statInfo sinfo;
+    char name[MAXLINELEN];
+    int numIndx;
+    int num;
+    int fd;
+    int i;
+
+    sp = getenv("LSF_LIM_STATE");
+    if (sp == NULL || sp[0] == 0)
+        return;
+
+    fd = atoi(sp);
+    putenv("LSF_LIM_STATE=");
+
+    fp = fdopen(fd, "r");
+    if (fp == NULL) {
+        ls_syslog(LOG_ERR, "%s: fdopen(%d) failed %m", __func__, fd);
+        close(fd);
+        return;
+    }
+
+    if (! masterMe)
+        goto out;
+
+    if (fscanf(fp, "%d", &numIndx) != 1
+        || numIndx != allInfo.numIndx) {
+        ls_syslog(LOG_INFO, "\
+%s: load indices changed, not restoring host load", __func__);
+        goto out;
+    }
+
+    for (i = 0; i < numIndx; i++) {
+        if (fscanf(fp, "%s", name) != 1
+            || strcmp(name, allInfo.resTable[i].name) != 0) {
+            ls_syslog(LOG_INFO, "\
+%s: load indices changed, not restoring host load", __func__);
+            goto out;
+        }
+    }
+
+    num = 0;
+    while (fscanf(fp, "%s %d %d %d %d %d %hu",
+                  name,
+                  &sinfo.maxCpus,
+                  &sinfo.maxMem,
+                  &sinfo.maxSwap,
+                  &sinfo.maxTmp,
+                  &sinfo.nDisks,
+                  &sinfo.portno) == 7) {
+
+        hPtr = findHostbyList(myClusterPtr->hostList, name);
+        if (hPtr == myHostPtr)
+            hPtr = NULL;
+
+        /* Consume the rest of the line even if the host
+         * is gone from the configuration.
+         */
+        for (i = 0; i < GET_INTNUM(numIndx) + 1; i++) {
+            int status;
+
+            if (fscanf(fp, "%d", &status) != 1)
+                goto out;
+            if (hPtr)
+                hPtr->status[i] = status;
+        }
+        for (i = 0; i < numIndx; i++) {
+            float load;
+            float uload;
+
+            if (fscanf(fp, "%f %f", &load, &uload) != 2)
+                goto out;
+            if (hPtr) {
+                hPtr->loadIndex[i] = load;
+                hPtr->uloadIndex[i] = uload;
+            }
+        }
+
+        if (hPtr == NULL)
+            continue;
+
+        hPtr->statInfo.maxCpus = sinfo.maxCpus;
+        hPtr->statInfo.maxMem = sinfo.maxMem;
+        hPtr->statInfo.maxSwap = sinfo.maxSwap;
+        hPtr->statInfo.maxTmp = sinfo.maxTmp;
+        hPtr->statInfo.nDisks = sinfo.nDisks;
+        hPtr->statInfo.portno = sinfo.portno;
+        hPtr->infoValid = TRUE;
+        hPtr->hostInactivityCount = 0;
+        hPtr->lastSeqNo = 0;
+        ++num;
+    }
+
+    ls_syslog(LOG_INFO, "\
+%s: restored load of %d hosts", __func__, num);
+
+out:
+    fclose(fp);
+}
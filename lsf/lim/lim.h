@@ -41,6 +41,7 @@
 #define KEEPTIME   2
 #define MAXCANDHOSTS  10
 #define MAXCLIENTS   1024
+#define LIM_UDP_QUEUE  64
 #define WARNING_ERR   EXIT_WARNING_ERROR
 #define MIN_FLOAT16  2.328306E-10
 #define LIM_EVENT_MAXSIZE  (1024 * 1024)
@@ -508,6 +509,7 @@ extern void chkResReq(XDR *, struct sockaddr_in *, struct LSFHeader *);
 extern void getTclHostData (struct tclHostData *, struct hostNode *,
                             struct hostNode *, int);
 extern void reconfig(void);
+extern void restoreLimState(void);
 extern void shutdownLim(void);
 extern int xdr_loadvector(XDR *, struct loadVectorStruct *,
                           struct LSFHeader *);
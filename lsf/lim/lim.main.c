@@ -88,6 +88,9 @@ static int initAndConfig(int, int *);
 static void term_handler(int);
 static void child_handler(int);
 static int  processUDPMsg(void);
+static void drainUDPMsg(void);
+static int  udpOpCode(char *);
+static int  dispatchUDPMsg(char *, struct sockaddr_in *);
 static void doAcceptConn(void);
 static void initSignals(void);
 static void periodic(int);
@@ -103,6 +106,18 @@ extern char *getExtResourcesVal(char *);
  */
 static char reqBuf[MSGSIZE];
 
+/* Queue of client requests received on the
+ * datagram socket waiting to be served.
+ */
+struct udpMsg {
+    struct sockaddr_in from;
+    char buf[MSGSIZE];
+};
+static struct udpMsg *udpQueue;
+static int udpHead;
+static int udpCount;
+static int udpDropped;
+
 static void
 usage(void)
 {
@@ -119,9 +134,11 @@ main(int argc, char **argv)
     struct Masks sockmask;
     struct Masks chanmask;
     struct timeval timer;
+    struct timeval nowait;
     struct timeval t0;
     struct timeval t1;
     int    maxfd;
+    int    stateFd;
     char   *sp;
     int    showTypeModel;
     int    cc;
@@ -222,8 +239,19 @@ Reading configuration from %s/lsf.conf\n", env_dir);
     maxfd = sysconf(_SC_OPEN_MAX);
     if (lim_debug != 2) {
 
-        for (cc = maxfd; cc >= 0; cc--)
+        /* Keep the load state inherited from the LIM
+         * we were re-exec'ed from, see reconfig().
+         */
+        stateFd = -1;
+        sp = getenv("LSF_LIM_STATE");
+        if (sp != NULL && sp[0] != 0)
+            stateFd = atoi(sp);
+
+        for (cc = maxfd; cc >= 0; cc--) {
+            if (cc == stateFd)
+                continue;
             close(cc);
+        }
 
         daemonize_();
         nice(NICE_LEAST);
@@ -289,6 +317,10 @@ Reading configuration from %s/lsf.conf\n", env_dir);
     if (masterMe)
         initNewMaster();
 
+    /* Pick up the host load saved across reconfig.
+     */
+    restoreLimState();
+
     if (lim_debug < 2)
         chdir("/tmp");
 
@@ -314,7 +346,16 @@ Reading configuration from %s/lsf.conf\n", env_dir);
         ls_syslog(LOG_DEBUG2, "\
 %s: Before select: timer %dsec", __func__, timer.tv_sec);
 
-        nReady = chanSelect_(&sockmask, &chanmask, &timer);
+        /* Client requests left in the queue by processUDPMsg()
+         * are served once select() has polled the other sockets.
+         */
+        if (udpCount > 0) {
+            nowait.tv_sec = 0;
+            nowait.tv_usec = 0;
+            nReady = chanSelect_(&sockmask, &chanmask, &nowait);
+        } else {
+            nReady = chanSelect_(&sockmask, &chanmask, &timer);
+        }
         if (nReady < 0) {
             if (errno != EINTR)
                 ls_syslog(LOG_ERR, "\
@@ -355,11 +396,14 @@ Reading configuration from %s/lsf.conf\n", env_dir);
         }
 
         if (nReady <= 0) {
+            if (udpCount > 0)
+                processUDPMsg();
             sigprocmask(SIG_SETMASK, &oldMask, NULL);
             continue;
         }
 
-        if (FD_ISSET(limSock, &chanmask.rmask)) {
+        if (FD_ISSET(limSock, &chanmask.rmask)
+            || udpCount > 0) {
             processUDPMsg();
         }
 
@@ -376,30 +420,136 @@ Reading configuration from %s/lsf.conf\n", env_dir);
 } /* main() */
 
 /* processUDPMsg()
+ * Drain the datagram socket and serve the client requests
+ * queued so far. Before serving each request the socket is
+ * drained again so that load updates and master announcements
+ * from other LIMs are never stuck behind placement and load
+ * queries, the client requests read meanwhile are only queued
+ * and wait for the next round after select().
  */
 static int
 processUDPMsg(void)
+{
+    struct udpMsg *msg;
+    int num;
+
+    if (udpQueue == NULL) {
+        udpQueue = calloc(LIM_UDP_QUEUE, sizeof(struct udpMsg));
+        if (udpQueue == NULL) {
+            ls_syslog(LOG_ERR, "%s: calloc() failed %m", __func__);
+            lim_Exit(__func__);
+        }
+    }
+
+    drainUDPMsg();
+
+    for (num = udpCount; num > 0; num--) {
+
+        msg = &udpQueue[udpHead];
+        dispatchUDPMsg(msg->buf, &msg->from);
+
+        udpHead = (udpHead + 1) % LIM_UDP_QUEUE;
+        --udpCount;
+
+        drainUDPMsg();
+    }
+
+    return 0;
+}
+
+/* drainUDPMsg()
+ * Read all the datagrams pending on the LIM socket. Messages
+ * from other LIMs are dispatched right away, client requests
+ * are queued. If the queue is full the client request is
+ * dropped, the client library will retry it.
+ */
+static void
+drainUDPMsg(void)
+{
+    struct sockaddr_in from;
+    socklen_t fromLen;
+    char *buf;
+    int opCode;
+    int num;
+    int cc;
+
+    for (num = 0; num < 2 * LIM_UDP_QUEUE; num++) {
+
+        if (udpCount < LIM_UDP_QUEUE)
+            buf = udpQueue[(udpHead + udpCount) % LIM_UDP_QUEUE].buf;
+        else
+            buf = reqBuf;
+
+        memset(&from, 0, sizeof(from));
+        fromLen = sizeof(from);
+        cc = recvfrom(chanSock_(limSock),
+                      buf,
+                      MSGSIZE,
+                      MSG_DONTWAIT,
+                      (struct sockaddr *)&from,
+                      &fromLen);
+        if (cc < 0) {
+            if (errno != EAGAIN
+                && errno != EWOULDBLOCK
+                && errno != EINTR)
+                ls_syslog(LOG_ERR, "\
+%s: recvfrom() failed limSock %d: %m", __func__, limSock);
+            return;
+        }
+
+        opCode = udpOpCode(buf);
+        if ((opCode >= FIRST_LIM_LIM && opCode < FIRST_INTER_CLUS)
+            || opCode == LIM_SERV_AVAIL) {
+            dispatchUDPMsg(buf, &from);
+            continue;
+        }
+
+        if (buf == reqBuf) {
+            ++udpDropped;
+            ls_syslog(LOG_DEBUG, "\
+%s: request queue full, dropped request %d from %s, %d dropped so far",
+                      __func__, opCode, sockAdd2Str_(&from), udpDropped);
+            continue;
+        }
+
+        udpQueue[(udpHead + udpCount) % LIM_UDP_QUEUE].from = from;
+        ++udpCount;
+    }
+}
+
+/* udpOpCode()
+ */
+static int
+udpOpCode(char *buf)
+{
+    struct LSFHeader hdr;
+    XDR xdrs;
+
+    xdrmem_create(&xdrs, buf, MSGSIZE, XDR_DECODE);
+    if (!xdr_LSFHeader(&xdrs, &hdr)) {
+        xdr_destroy(&xdrs);
+        return -1;
+    }
+    xdr_destroy(&xdrs);
+
+    return hdr.opCode & 0xFFFF;
+}
+
+/* dispatchUDPMsg()
+ */
+static int
+dispatchUDPMsg(char *buf, struct sockaddr_in *fromPtr)
 {
     struct hostNode *fromHost;
     struct hostent *hp;
     struct LSFHeader reqHdr;
     struct sockaddr_in from;
     enum limReqCode limReqCode;
-    int cc;
     XDR xdrs;
 
-    memset(&from, 0, sizeof(from));
-
-    cc = chanRcvDgram_(limSock, reqBuf, MSGSIZE, &from, -1);
-    if (cc < 0) {
-        ls_syslog(LOG_ERR, "\
-%s: chanRcvDgram() failed limSock %d: %m",
-                  __func__, limSock);
-        return -1;
-    }
+    from = *fromPtr;
 
-    xdrmem_create(&xdrs, reqBuf, MSGSIZE, XDR_DECODE);
-    cc = XDR_GETPOS(&xdrs);
+    xdrmem_create(&xdrs, buf, MSGSIZE, XDR_DECODE);
 
     if (!xdr_LSFHeader(&xdrs, &reqHdr)) {
         ls_syslog(LOG_ERR, "\
@@ -408,7 +558,6 @@ processUDPMsg(void)
         return -1;
     }
 
-    cc = XDR_GETPOS(&xdrs);
     limReqCode = reqHdr.opCode;
     limReqCode &= 0xFFFF;
 
@@ -38,11 +38,29 @@ int defaultRunElim = FALSE;
 static void getusr(void);
 static char * getElimRes (void);
 static int saveSBValue (char *, char *);
+static int saveSBInstance(int, char *);
+static int elimRegister(FILE *);
+static int elimUpdate(FILE *);
+static void freeElimSlots(void);
 static int callElim(void);
 static int startElim(void);
 static void termElim(void);
 static int isResourceSharedInAllHosts(char *resName);
 
+/* Protocol version 2 elims register the names of
+ * their indices once, then send the updates by slot
+ * number which is mapped to the load index or to the
+ * shared resource instance at registration time.
+ */
+struct elimSlot {
+    char *name;
+    int resNo;
+    int indx;
+    int instance;
+};
+static struct elimSlot *elimSlots;
+static int numElimSlots;
+
 int ELIMrestarts = -1;
 int ELIMdebug = 0;
 int ELIMblocktime = -1;
@@ -509,6 +527,11 @@ getusr(void)
             else
                 putEnv("LSF_MASTER", "N");
 
+            /* A new elim has to register its indices again.
+             */
+            freeElimSlots();
+            putEnv("LSF_ELIM_PROTOCOL", "2");
+
 	    /* Avoid overflow...
 	     */
 	    resbuf[0] = 0;
@@ -593,7 +616,7 @@ getusr(void)
 %s: Signal mask has been changed, all are signals blocked now", __func__);
         }
 
-        cc = fscanf(fp, "%d", &numIndx);
+        cc = fscanf(fp, "%s", name);
         if (cc != 1) {
             ls_syslog(LOG_ERR, "\
 %s: Protocol error numIndx not read (cc=%d): %m", __func__, cc);
@@ -602,6 +625,34 @@ getusr(void)
             unblockSigs_(&oldMask);
             return;
         }
+
+        if (strcmp(name, "R") == 0
+            || strcmp(name, "U") == 0) {
+
+            if (name[0] == 'R')
+                cc = elimRegister(fp);
+            else
+                cc = elimUpdate(fp);
+
+            if (cc < 0) {
+                setUnkwnValues();
+                lim_pclose(fp);
+                fp = NULL;
+            }
+            unblockSigs_(&oldMask);
+            return;
+        }
+
+        if (! isint_(name)) {
+            ls_syslog(LOG_ERR, "\
+%s: Protocol error unknown record %s", __func__, name);
+            lim_pclose(fp);
+            fp = NULL;
+            unblockSigs_(&oldMask);
+            return;
+        }
+        numIndx = atoi(name);
+
         if (numIndx < 0) {
             ls_syslog(LOG_ERR, "%\
 s: Protocol error numIndx %d", __func__, numIndx);
@@ -679,9 +730,6 @@ saveSBValue(char *name, char *value)
 {
     int i;
     int indx;
-    int j;
-    int myHostNo = -1;
-    int updHostNo = -1;
 
     if ((indx = getResEntry(name)) < 0)
         return -1;
@@ -703,49 +751,193 @@ saveSBValue(char *name, char *value)
         if (strcmp(myHostPtr->instances[i]->resName, name))
             continue;
 
-        if (masterMe) {
+        return saveSBInstance(i, value);
+    }
+    return -1;
+}
+
+/* saveSBInstance()
+ * Save the value of the i-th shared resource instance
+ * of the local host.
+ */
+static int
+saveSBInstance(int i, char *value)
+{
+    int j;
+    int myHostNo = -1;
+    int updHostNo = -1;
+
+    if (masterMe) {
+
+        for (j = 0; j < myHostPtr->instances[i]->nHosts; j++) {
+
+            if (myHostPtr->instances[i]->updHost
+                && (myHostPtr->instances[i]->updHost
+                    == myHostPtr->instances[i]->hosts[j]))
+                updHostNo = j;
+
+            if (myHostPtr->instances[i]->hosts[j] == myHostPtr)
+                myHostNo = j;
 
-            for (j = 0; j < myHostPtr->instances[i]->nHosts; j++) {
+            if (myHostNo >= 0
+                && (updHostNo >= 0
+                    || myHostPtr->instances[i]->updHost == NULL))
+                break;
+        }
+        if (updHostNo >= 0
+            && (myHostNo < 0
+                || ((updHostNo < myHostNo)
+                    && strcmp(myHostPtr->instances[i]->value, "-"))))
+            return 0;
+    }
 
-                if (myHostPtr->instances[i]->updHost
-                    && (myHostPtr->instances[i]->updHost
-                        == myHostPtr->instances[i]->hosts[j]))
-                    updHostNo = j;
+    FREEUP(myHostPtr->instances[i]->value);
+    myHostPtr->instances[i]->value = strdup(value);
+    if (myHostPtr->instances[i]->value == NULL) {
+        ls_syslog(LOG_ERR, "\
+%s: strdup() %d bytes for %s failed, %m.", __func__,
+                  strlen(value), value);
+        return -1;
+    }
+    myHostPtr->instances[i]->updateTime = time(NULL);
+    myHostPtr->instances[i]->updHost = myHostPtr;
 
-                if (myHostPtr->instances[i]->hosts[j] == myHostPtr)
-                    myHostNo = j;
+    ls_syslog(LOG_DEBUG, "\
+%s: i %d resName %s value %s updHost %s",
+              __func__, i, myHostPtr->instances[i]->resName,
+              myHostPtr->instances[i]->value,
+              myHostPtr->instances[i]->updHost->hostName);
+    return 0;
+}
 
-                if (myHostNo >= 0
-                    && (updHostNo >= 0
-                        || myHostPtr->instances[i]->updHost == NULL))
+/* elimRegister()
+ * Read the registration record of a protocol 2 elim:
+ * "R numIndx name1 name2 ... nameN", the names are
+ * assigned the slots 0 ... N-1 and resolved once here.
+ */
+static int
+elimRegister(FILE *fp)
+{
+    static char name[MAXLSFNAMELEN];
+    struct elimSlot *slot;
+    int num;
+    int i;
+
+    if (fscanf(fp, "%d", &num) != 1
+        || num < 0
+        || num > allInfo.nRes) {
+        ls_syslog(LOG_ERR, "\
+%s: Protocol error invalid number of slots", __func__);
+        return -1;
+    }
+
+    freeElimSlots();
+    elimSlots = calloc(num + 1, sizeof(struct elimSlot));
+    if (elimSlots == NULL) {
+        ls_syslog(LOG_ERR, "%s: calloc() failed %m", __func__);
+        return -1;
+    }
+
+    for (i = 0; i < num; i++) {
+
+        if (fscanf(fp, "%s", name) != 1) {
+            ls_syslog(LOG_ERR, "\
+%s: Protocol error on slot %d: %m", __func__, i);
+            freeElimSlots();
+            return -1;
+        }
+
+        slot = &elimSlots[i];
+        slot->name = putstr_(name);
+        slot->resNo = getResEntry(name);
+        slot->indx = -1;
+        slot->instance = -1;
+        ++numElimSlots;
+
+        if (slot->resNo < 0) {
+            ls_syslog(LOG_ERR, "\
+%s: Unknown index name %s from ELIM", __func__, name);
+            continue;
+        }
+
+        if (allInfo.resTable[slot->resNo].flags & RESF_DYNAMIC) {
+            int j;
+
+            for (j = 0; j < myHostPtr->numInstances; j++) {
+                if (strcmp(myHostPtr->instances[j]->resName, name) == 0) {
+                    slot->instance = j;
                     break;
+                }
             }
-            if (updHostNo >= 0
-                && (myHostNo < 0
-                    || ((updHostNo < myHostNo)
-                        && strcmp(myHostPtr->instances[i]->value, "-"))))
-                return 0;
         }
 
-        FREEUP(myHostPtr->instances[i]->value);
-        myHostPtr->instances[i]->value = strdup(value);
-        if (myHostPtr->instances[i]->value == NULL) {
+        if (slot->resNo < allInfo.numIndx
+            && allInfo.resTable[slot->resNo].valueType == LS_NUMERIC)
+            slot->indx = slot->resNo;
+
+        ls_syslog(LOG_DEBUG, "\
+%s: slot %d name %s indx %d instance %d", __func__, i, name,
+                  slot->indx, slot->instance);
+    }
+
+    return 0;
+}
+
+/* elimUpdate()
+ * Read the update record of a protocol 2 elim:
+ * "U numValues slot1 value1 ... slotN valueN".
+ */
+static int
+elimUpdate(FILE *fp)
+{
+    static char svalue[MAXLSFNAMELEN];
+    struct elimSlot *slot;
+    int num;
+    int n;
+    int i;
+
+    if (fscanf(fp, "%d", &num) != 1
+        || num < 0) {
+        ls_syslog(LOG_ERR, "\
+%s: Protocol error invalid number of values", __func__);
+        return -1;
+    }
+
+    for (i = 0; i < num; i++) {
+
+        if (fscanf(fp, "%d %s", &n, svalue) != 2
+            || n < 0
+            || n >= numElimSlots) {
             ls_syslog(LOG_ERR, "\
-%s: strdup() %d bytes for %s failed, %m.", __func__,
-                      strlen(value), value);
+%s: Protocol error on value %d, %d slots registered",
+                      __func__, i, numElimSlots);
             return -1;
         }
-        myHostPtr->instances[i]->updateTime = time(NULL);
-        myHostPtr->instances[i]->updHost = myHostPtr;
 
-        ls_syslog(LOG_DEBUG, "\
-%s: i %d resName %s value %s updHost %s",
-                  __func__, i, myHostPtr->instances[i]->resName,
-                  myHostPtr->instances[i]->value,
-                  myHostPtr->instances[i]->updHost->hostName);
-        return 0;
+        slot = &elimSlots[n];
+
+        if (slot->instance >= 0
+            && (allInfo.resTable[slot->resNo].valueType != LS_NUMERIC
+                || isanumber_(svalue))
+            && saveSBInstance(slot->instance, svalue) == 0)
+            continue;
+
+        if (slot->indx >= 0)
+            myHostPtr->loadIndex[slot->indx] = atof(svalue);
     }
-    return -1;
+
+    return 0;
+}
+
+static void
+freeElimSlots(void)
+{
+    int i;
+
+    for (i = 0; i < numElimSlots; i++)
+        FREEUP(elimSlots[i].name);
+    FREEUP(elimSlots);
+    numElimSlots = 0;
 }
 
 void
@@ -50,7 +50,9 @@ int requeued = 0;
 static int do_newconnect(int);
 static int get_connect(int, struct LSFHeader *);
 static int get_status(int, struct LSFHeader *, LS_WAIT_T *);
-static void setMask(fd_set *);
+static void setMask(void);
+static void pollSet(int, short);
+static int pollIsSet(int, short);
 static int bury_task(LS_WAIT_T, struct rusage *, int);
 static int do_setstdin(int, int);
 static int flush_buffer(void);
@@ -69,6 +71,8 @@ JOB_STATUS  getJobStatus(LS_LONG_INT jid, struct jobInfoEnt **job,
                          struct jobInfoHead **jobHead);
 
 int  JobStateInfo(LS_LONG_INT jid);
+static int watchJob(void);
+static int watchEvent(int);
 
 #define MAXLOOP 10000
 
@@ -76,8 +80,25 @@ int  JobStateInfo(LS_LONG_INT jid);
 
 static Dead_rpid *dead_rpid;
 
-static fd_set socks_bit;
-static fd_set ncon_bit;
+/* Bitmaps of connection indexes. They are sized to maxfds
+ * by ls_nioinit() as the number of connections is no longer
+ * bound by FD_SETSIZE, NIOS waits for them with poll().
+ */
+#define CONN_SET(i, s)    ((s)[(i) >> 3] |= 1 << ((i) & 7))
+#define CONN_CLR(i, s)    ((s)[(i) >> 3] &= ~(1 << ((i) & 7)))
+#define CONN_ISSET(i, s)  ((s)[(i) >> 3] & (1 << ((i) & 7)))
+#define CONN_ZERO(s)      memset((s), 0, connSetSize)
+
+static unsigned char *socks_bit;
+static unsigned char *ncon_bit;
+static unsigned char *stderrFlag;
+static int connSetSize;
+
+/* Connections NIOS keeps at most, a RES sends all the
+ * tasks of a host on one connection tagged with their
+ * task ids.
+ */
+#define NIOS_MAXCONN   16384
 
 
 #define C_CONNECTED(cent)                                               \
@@ -88,7 +109,7 @@ static fd_set ncon_bit;
         closesocket(conn[id].sock.fd);                  \
         conn[id].sock.fd = -1;                          \
         conn[id].rpid = 0;                              \
-        FD_CLR(id, &socks_bit);}
+        CONN_CLR(id, socks_bit);}
 LIST_T *notifyList;
 
 typedef struct taskNotice {
@@ -143,7 +164,7 @@ static struct nioInfo abortedTasks;
 static struct {
     int empty;
     int length;
-    fd_set socks;
+    unsigned char *socks;
     char buf[BUFSIZ + LSF_HEADER_LEN  ];
 } writeBuf;
 
@@ -157,6 +178,10 @@ static int lastConn = 0;
 
 static int maxfds;
 static int maxtasks;
+static struct pollfd *pollFds;
+static int numPollFds;
+static int *pollIndex;
+static int sizePollIndex;
 static int *connIndexTable;
 static int count_unconn = 0;
 static int acceptSock;
@@ -205,9 +230,12 @@ ls_nioinit(int sock)
     }
 
 
+    if (maxfds > NIOS_MAXCONN)
+        maxfds = NIOS_MAXCONN;
     if (maxfds > 1024)
-        maxfds = 1024;
-    maxtasks = maxfds*maxfds;
+        maxtasks = 1024 * 1024;
+    else
+        maxtasks = maxfds*maxfds;
     connIndexTable = (int *) malloc(maxtasks*sizeof(int));
     if (connIndexTable == NULL) {
         lserrno = LSE_MALLOC;
@@ -222,11 +250,24 @@ ls_nioinit(int sock)
     conn = (struct connInfo *) calloc(maxfds, sizeof(struct connInfo));
     ioTable = (struct nioEvent *) calloc(maxfds, sizeof(struct nioEvent));
     ioTable1 = (struct nioEvent *) calloc(maxfds, sizeof(struct nioEvent));
-    if (conn == NULL || ioTable == NULL || ioTable1 == NULL) {
+    pollFds = calloc(maxfds + FD_SETSIZE + 1, sizeof(struct pollfd));
+    connSetSize = (maxfds + 7) / 8;
+    socks_bit = calloc(connSetSize, 1);
+    ncon_bit = calloc(connSetSize, 1);
+    stderrFlag = calloc(connSetSize, 1);
+    writeBuf.socks = calloc(connSetSize, 1);
+    if (conn == NULL || ioTable == NULL || ioTable1 == NULL
+        || pollFds == NULL || socks_bit == NULL || ncon_bit == NULL
+        || stderrFlag == NULL || writeBuf.socks == NULL) {
         lserrno = LSE_MALLOC;
         FREEUP(conn);
         FREEUP(ioTable);
         FREEUP(ioTable1);
+        FREEUP(pollFds);
+        FREEUP(socks_bit);
+        FREEUP(ncon_bit);
+        FREEUP(stderrFlag);
+        FREEUP(writeBuf.socks);
         return -1;
     }
 
@@ -288,7 +329,6 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
     static int brokenSelectFlag = 0;
     static int checkedBrokenSelect = 0;
     static dev_t devNullDeviceNumber = 0;
-    static fd_set stderrFlag;
 
     if (conn == NULL) {
         lserrno = LSE_NIO_INIT;
@@ -367,13 +407,12 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
             emask = *exceptfds;
         else
             FD_ZERO(&emask);
-        setMask(&rmask);
 
 
         if (brokenSelectFlag && devNullDeviceNumber) {
             struct stat sbuf;
             FD_ZERO(&devNullMask);
-            for (i = 0; i < nfds; i++) {
+            for (i = 0; i < nfds && i < FD_SETSIZE; i++) {
                 if (FD_ISSET(i, &rmask)) {
                     memset(&sbuf, 0, sizeof(sbuf));
                     if (!fstat(i, &sbuf)) {
@@ -408,12 +447,38 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
 
 
 
+        /* The caller descriptors and the connections
+         */
+        numPollFds = 0;
+        for (i = 0; i < nfds && i < FD_SETSIZE; i++) {
+            if (FD_ISSET(i, &rmask))
+                pollSet(i, POLLIN);
+            if (FD_ISSET(i, &wmask))
+                pollSet(i, POLLOUT);
+            if (FD_ISSET(i, &emask))
+                pollSet(i, POLLPRI);
+        }
+        setMask();
+
         tv1.tv_sec = tvp->tv_sec;
         tv1.tv_usec = tvp->tv_usec;
-        nready = select(maxfds, &rmask, &wmask, &emask, &tv1);
+        nready = poll(pollFds, numPollFds,
+                      tv1.tv_sec * 1000 + tv1.tv_usec / 1000);
+
+        FD_ZERO(&rmask);
+        FD_ZERO(&wmask);
+        FD_ZERO(&emask);
+        for (i = 0; nready > 0 && i < nfds && i < FD_SETSIZE; i++) {
+            if (pollIsSet(i, POLLIN))
+                FD_SET(i, &rmask);
+            if (pollIsSet(i, POLLOUT))
+                FD_SET(i, &wmask);
+            if (pollIsSet(i, POLLPRI))
+                FD_SET(i, &emask);
+        }
 
         if (brokenSelectFlag && devNullDeviceNumber) {
-            for (i = 0; i < nfds; i++) {
+            for (i = 0; i < nfds && i < FD_SETSIZE; i++) {
                 if (FD_ISSET(i, &devNullMask)) {
                     FD_SET(i, &rmask);
                     nready++;
@@ -447,7 +512,7 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
         }
 
 
-        if (acceptSock && FD_ISSET(acceptSock, &rmask)) {
+        if (acceptSock && pollIsSet(acceptSock, POLLIN)) {
 
             if (do_newconnect(acceptSock) < 0)
                 return -1;
@@ -468,7 +533,7 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
             if (!C_CONNECTED(conn[i]))
                 continue;
 
-            if (FD_ISSET(conn[i].sock.fd, &rmask)) {
+            if (pollIsSet(conn[i].sock.fd, POLLIN)) {
                 if (conn[i].sock.rcount == 0) {
                     struct LSFHeader msgHdr, bufHdr;
                     XDR xdrs;
@@ -531,14 +596,14 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
                             conn[i].rbuf->bp = conn[i].rbuf->buf;
                             if (conn[i].rtag <= 0)
                                 conn[i].rtag = conn[i].rpid;
-                            FD_CLR(i, &stderrFlag);
+                            CONN_CLR(i, stderrFlag);
                             break;
                         case RES2NIOS_STDERR:
                             conn[i].sock.rcount = msgHdr.length;
                             conn[i].rbuf->bp = conn[i].rbuf->buf;
                             if (conn[i].rtag <= 0)
                                 conn[i].rtag = conn[i].rpid;
-                            FD_SET(i, &stderrFlag);
+                            CONN_SET(i, stderrFlag);
                             break;
                         case RES2NIOS_NEWTASK:
 
@@ -632,7 +697,7 @@ ls_nioselect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
                     }
                     if (conn[i].sock.rcount == 0) {
 
-                        if (FD_ISSET(i, &stderrFlag)) {
+                        if (CONN_ISSET(i, stderrFlag)) {
                             add_list(&readyTaskList, conn[i].rpid,
                                      NIO_STDERR, NULL);
                         } else {
@@ -697,7 +762,7 @@ check_timeout_task()
                 }
                 add_list(&abortedTasks, conn[i].rpid, NIO_IOERR, NULL);
                 add_list(&abortedTasks, conn[i].rpid, NIO_EOF, NULL);
-                FD_CLR(i, &ncon_bit);
+                CONN_CLR(i, ncon_bit);
                 count_unconn--;
             }
             continue;
@@ -724,7 +789,7 @@ check_timeout_task()
             }
         }
         if (timeout_cnt == conn[i].taskList->numEnts)
-            FD_CLR(i, &ncon_bit);
+            CONN_CLR(i, ncon_bit);
     }
     return 0;
 }
@@ -752,7 +817,7 @@ ls_nioremovetask(int tid)
         if (conn[i].rpid > 0 && conn[i].sock.fd != -1) {
             if ((task = getTask(conn[i].taskList, tid)) != NULL) {
                 if (task->rtime != 0) {
-                    FD_CLR(i, &ncon_bit);
+                    CONN_CLR(i, ncon_bit);
                     count_unconn--;
                 }
                 addNotifyList(notifyList, tid, STATUS_TIMEOUT);
@@ -764,7 +829,7 @@ ls_nioremovetask(int tid)
         }
         else if (conn[i].rpid > 0 && conn[i].rpid == tid) {
 
-            FD_CLR(i, &ncon_bit);
+            CONN_CLR(i, ncon_bit);
             conn[i].rpid = 0;
             connIndexTable[tid-1] = -1;
             count_unconn--;
@@ -846,7 +911,7 @@ ls_niowrite(char *buf, int len)
 
 
         for (i = 0 ; i < lastConn ; i++) {
-            if (C_CONNECTED(conn[i]) && FD_ISSET(i, &socks_bit))
+            if (C_CONNECTED(conn[i]) && CONN_ISSET(i, socks_bit))
                 break;
         }
         if (i < lastConn) {
@@ -865,7 +930,7 @@ ls_niowrite(char *buf, int len)
         writeBuf.length = cc + XDR_GETPOS(&xdrs);
         xdr_destroy(&xdrs);
 
-        writeBuf.socks = socks_bit;
+        memcpy(writeBuf.socks, socks_bit, connSetSize);
         writeBuf.empty = FALSE;
         flush_buffer();
         return cc;
@@ -897,7 +962,7 @@ flush_databuf()
     if (!writeBuf.empty) {
         empty = TRUE;
         for (i = 0 ; i < lastConn ; i++) {
-            if (C_CONNECTED(conn[i]) && FD_ISSET(i, &writeBuf.socks)
+            if (C_CONNECTED(conn[i]) && CONN_ISSET(i, writeBuf.socks)
                 && (conn[i].bytesWritten != writeBuf.length)) {
 
 
@@ -927,7 +992,7 @@ flush_databuf()
 
         if (writeBuf.empty) {
             for (i = 0 ; i < lastConn ; i++)
-                if (C_CONNECTED(conn[i]) && FD_ISSET(i, &writeBuf.socks))
+                if (C_CONNECTED(conn[i]) && CONN_ISSET(i, writeBuf.socks))
                     conn[i].bytesWritten = 0;
         }
     }
@@ -1133,11 +1198,11 @@ ls_nionewtask(int tid, int sock)
 
         task->rtime = 0;
         if (conn[i].rtime != 0) {
-            if (FD_ISSET(i, &ncon_bit))
-                FD_SET(i, &socks_bit);
+            if (CONN_ISSET(i, ncon_bit))
+                CONN_SET(i, socks_bit);
             else
-                FD_CLR(i, &socks_bit);
-            FD_CLR(i, &ncon_bit);
+                CONN_CLR(i, socks_bit);
+            CONN_CLR(i, ncon_bit);
             io_nonblock_(conn[i].sock.fd);
         }
         conn[i].rtime = 0;
@@ -1157,7 +1222,7 @@ ls_nionewtask(int tid, int sock)
             conn[i].sock.fd = -1;
             conn[i].rtime = time(0);
 
-            FD_SET(i, &ncon_bit);
+            CONN_SET(i, ncon_bit);
             count_unconn++;
             if (nioDebug)
                 ls_syslog(LOG_DEBUG, "%s: new task <%d> is registered",
@@ -1188,7 +1253,7 @@ ls_nionewtask(int tid, int sock)
             conn[i].sock.wcount = 0;
             conn[i].rtag = -1;
             conn[i].wtag = 0;
-            FD_SET(i, &socks_bit);
+            CONN_SET(i, socks_bit);
             io_nonblock_(conn[i].sock.fd);
             if (nioDebug)
                 ls_syslog(LOG_DEBUG, "\
@@ -1232,9 +1297,9 @@ do_setstdin(int tid, int stdinOn)
                 if (conn[i].rpid == 0)
                     continue;
                 if (conn[i].sock.fd == -1 || conn[i].rtime != 0)
-                    FD_SET(i, &ncon_bit);
+                    CONN_SET(i, ncon_bit);
                 else
-                    FD_SET(i, &socks_bit);
+                    CONN_SET(i, socks_bit);
                 conn[i].wtag = 0;
             }
             i = 0;
@@ -1243,23 +1308,23 @@ do_setstdin(int tid, int stdinOn)
             if ((i = connIndexTable[tid-1]) >=0 && i < lastConn) {
                 if (getTask(conn[i].taskList, tid) != NULL) {
                     if (conn[i].rtime != 0) {
-                        FD_ZERO(&ncon_bit);
-                        FD_SET(i, &ncon_bit);
+                        CONN_ZERO(ncon_bit);
+                        CONN_SET(i, ncon_bit);
                     }
                     else {
-                        FD_ZERO(&socks_bit);
-                        FD_SET(i, &socks_bit);
+                        CONN_ZERO(socks_bit);
+                        CONN_SET(i, socks_bit);
                     }
                     conn[i].wtag = tid;
                 }
                 else if (conn[i].rpid == tid) {
                     if (conn[i].sock.fd == -1 || conn[i].rtime != 0) {
-                        FD_ZERO(&ncon_bit);
-                        FD_SET(i, &ncon_bit);
+                        CONN_ZERO(ncon_bit);
+                        CONN_SET(i, ncon_bit);
                     }
                     else {
-                        FD_ZERO(&socks_bit);
-                        FD_SET(i, &socks_bit);
+                        CONN_ZERO(socks_bit);
+                        CONN_SET(i, socks_bit);
                     }
                     conn[i].wtag = tid;
                 }
@@ -1274,9 +1339,9 @@ do_setstdin(int tid, int stdinOn)
                 if (conn[i].rpid == 0)
                     continue;
                 if (conn[i].sock.fd == -1 || conn[i].rtime != 0)
-                    FD_CLR(i, &ncon_bit);
+                    CONN_CLR(i, ncon_bit);
                 else
-                    FD_CLR(i, &socks_bit);
+                    CONN_CLR(i, socks_bit);
                 conn[i].wtag = -1;
             }
             i = 0;
@@ -1286,17 +1351,17 @@ do_setstdin(int tid, int stdinOn)
                 if (getTask(conn[i].taskList, tid) != NULL) {
                     if (conn[i].wtag == tid || conn[i].wtag == -1) {
                         if (conn[i].rtime != 0)
-                            FD_CLR(i, &ncon_bit);
+                            CONN_CLR(i, ncon_bit);
                         else
-                            FD_CLR(i, &socks_bit);
+                            CONN_CLR(i, socks_bit);
                         conn[i].wtag = -1;
                     }
                 }
                 else if (conn[i].rpid == tid) {
                     if (conn[i].sock.fd == -1 || conn[i].rtime != 0)
-                        FD_CLR(i, &ncon_bit);
+                        CONN_CLR(i, ncon_bit);
                     else
-                        FD_CLR(i, &socks_bit);
+                        CONN_CLR(i, socks_bit);
                     conn[i].wtag = -1;
                 }
             }
@@ -1329,14 +1394,14 @@ ls_niotasks(int options, int *tidList, int len)
 
                     tidList[listLen++] = task->tid;
                 } else if (options == NIO_TASK_STDINON) {
-                    if (FD_ISSET(i, &socks_bit) || FD_ISSET(i, &ncon_bit)) {
+                    if (CONN_ISSET(i, socks_bit) || CONN_ISSET(i, ncon_bit)) {
                         if (conn[i].wtag == 0)
                             tidList[listLen++] = task->tid;
                         else if (conn[i].wtag == task->tid)
                             tidList[listLen++] = task->tid;
                     }
                 } else if (options == NIO_TASK_STDINOFF) {
-                    if (FD_ISSET(i, &socks_bit) || FD_ISSET(i, &ncon_bit)) {
+                    if (CONN_ISSET(i, socks_bit) || CONN_ISSET(i, ncon_bit)) {
                         if (conn[i].wtag > 0 && conn[i].wtag != task->tid)
                             tidList[listLen++] = task->tid;
                     } else {
@@ -1356,10 +1421,10 @@ ls_niotasks(int options, int *tidList, int len)
 
                 tidList[listLen++] = conn[i].rpid;
             } else if (options == NIO_TASK_STDINON) {
-                if (FD_ISSET(i, &socks_bit) || FD_ISSET(i, &ncon_bit))
+                if (CONN_ISSET(i, socks_bit) || CONN_ISSET(i, ncon_bit))
                     tidList[listLen++] = conn[i].rpid;
             } else if (options == NIO_TASK_STDINOFF) {
-                if (!FD_ISSET(i, &socks_bit) && !FD_ISSET(i, &ncon_bit))
+                if (!CONN_ISSET(i, socks_bit) && !CONN_ISSET(i, ncon_bit))
                     tidList[listLen++] = conn[i].rpid;
             } else if (options == NIO_TASK_CONNECTED) {
                 if (C_CONNECTED(conn[i]))
@@ -1559,11 +1624,11 @@ do_newconnect(int s)
     conn[i].dead = FALSE;
     connIndexTable[connReq.rpid-1] = i;
     if (rtime == 0) {
-        if (FD_ISSET(i, &ncon_bit))
-            FD_SET(i, &socks_bit);
+        if (CONN_ISSET(i, ncon_bit))
+            CONN_SET(i, socks_bit);
         else
-            FD_CLR(i, &socks_bit);
-        FD_CLR(i, &ncon_bit);
+            CONN_CLR(i, socks_bit);
+        CONN_CLR(i, ncon_bit);
         if (io_nonblock_(newsock) < 0) {
             lserrno = LSE_SOCK_SYS;
             return -1;
@@ -1576,7 +1641,7 @@ do_newconnect(int s)
     }
     else {
 
-        FD_SET(i, &ncon_bit);
+        CONN_SET(i, ncon_bit);
         count_unconn++;
         if (i == lastConn)
             lastConn++;
@@ -1641,21 +1706,85 @@ doAcceptResCallback_(int s, struct niosConnect *connReq)
 }
 
 static void
-setMask(fd_set *rmask)
+setMask(void)
 {
     int i;
 
 
     if (acceptSock)
-        FD_SET(acceptSock, rmask);
+        pollSet(acceptSock, POLLIN);
 
     for (i = 0; i < lastConn ; i++) {
         if (C_CONNECTED(conn[i])) {
-            FD_SET(conn[i].sock.fd, rmask);
+            pollSet(conn[i].sock.fd, POLLIN);
         }
     }
 }
 
+/* pollSet()
+ *
+ * Add the events of fd to the next poll(), pollIndex
+ * maps the descriptors to their pollFds slot.
+ */
+static void
+pollSet(int fd, short events)
+{
+    int i;
+
+    if (fd >= sizePollIndex) {
+        int *p;
+        int size;
+
+        size = sizePollIndex ? sizePollIndex : 64;
+        while (size <= fd)
+            size = 2 * size;
+        p = realloc(pollIndex, size * sizeof(int));
+        if (p == NULL)
+            return;
+        for (i = sizePollIndex; i < size; i++)
+            p[i] = -1;
+        pollIndex = p;
+        sizePollIndex = size;
+    }
+
+    i = pollIndex[fd];
+    if (i >= 0
+        && i < numPollFds
+        && pollFds[i].fd == fd) {
+        pollFds[i].events |= events;
+        return;
+    }
+
+    i = numPollFds++;
+    pollFds[i].fd = fd;
+    pollFds[i].events = events;
+    pollFds[i].revents = 0;
+    pollIndex[fd] = i;
+}
+
+/* pollIsSet()
+ *
+ * Was fd ready for the events in the last poll(),
+ * an error or a hangup makes fd ready as in select().
+ */
+static int
+pollIsSet(int fd, short events)
+{
+    int i;
+
+    if (fd < 0
+        || fd >= sizePollIndex
+        || (i = pollIndex[fd]) < 0
+        || i >= numPollFds
+        || pollFds[i].fd != fd)
+        return FALSE;
+
+    if (pollFds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+        return (pollFds[i].events & events) != 0;
+
+    return (pollFds[i].revents & events) != 0;
+}
+
 
 static int
 get_connect(int indx, struct LSFHeader *msgHdr)
@@ -2342,7 +2471,7 @@ addTaskList(int tid, int connIndex)
         conn[i].sock.fd = -1;
         conn[i].rpid = 0;
         conn[i].rtime = 0;
-        FD_CLR(i, &ncon_bit);
+        CONN_CLR(i, ncon_bit);
         count_unconn--;
         rtime = 0;
         connIndexTable[tid-1] = -1;
@@ -2699,6 +2828,7 @@ void checkPendingJobStatus(int s)
     int       ready;
     int       lastPendJobCheck;
     int       lastMsgCheck;
+    int       watch;
 
     if (nioDebug) {
         ls_syslog(LOG_DEBUG, "\
@@ -2709,16 +2839,36 @@ void checkPendingJobStatus(int s)
 
     lastMsgCheck = lastPendJobCheck = lastCheckTime = time(NULL);
 
+    /* Have mbatchd push the job state changes instead
+     * of polling it, poll only if the watch is lost.
+     */
+    watch = watchJob();
 
     ready = 0;
     while (ready == 0) {
-        struct timeval      selectTimeout;
-
-        selectTimeout.tv_sec =  60;
-        selectTimeout.tv_usec = 0;
+        struct pollfd pfd[2];
+
+        pfd[0].fd = s;
+        pfd[0].events = POLLIN;
+        pfd[0].revents = 0;
+        pfd[1].fd = (watch >= 0) ? chanSock_(watch) : -1;
+        pfd[1].events = POLLIN;
+        pfd[1].revents = 0;
+
+        ready = poll(pfd, 2, 60 * 1000);
+        if (ready < 0) {
+            if (errno != EINTR)
+                break;
+            ready = 0;
+            continue;
+        }
 
+        if (pfd[1].revents) {
+            watch = watchEvent(watch);
+            ready = (pfd[0].revents != 0);
+            continue;
+        }
 
-        ready = rd_select_(s, &selectTimeout);
         if ( (ready == 0)
              && (jobId > 0) ) {
             time_t              now;
@@ -2744,23 +2894,87 @@ void checkPendingJobStatus(int s)
             }
 
 
-            if (jobStatusInterval> 0
+            if (watch < 0
+                && jobStatusInterval> 0
                 && (now - lastCheckTime) >= jobStatusInterval) {
                 checkJobStatus(1);
                 lastCheckTime = now;
             }
 
 
-            if (msgInterval > 0
+            if (watch < 0
+                && msgInterval > 0
                 && (now - lastMsgCheck) >= msgInterval) {
                 JobStateInfo(jobId);
                 lastMsgCheck = now;
             }
         }
     }
+
+    if (watch >= 0)
+        lsb_closewatch(watch);
+
     return;
 }
 
+/* watchJob()
+ * Ask mbatchd to push the state changes of the job,
+ * only needed if we report them.
+ */
+static int
+watchJob(void)
+{
+    int ch;
+
+    if (jobId <= 0
+        || (jobStatusInterval <= 0 && msgInterval <= 0))
+        return -1;
+
+    if (lsb_init("nios") != 0)
+        return -1;
+
+    ch = lsb_watchjobs(1, &jobId);
+    if (ch < 0)
+        ls_syslog(LOG_INFO, "\
+%s: lsb_watchjobs() failed for job %s: %s, polling mbatchd",
+                  __func__, lsb_jobid2str(jobId), lsb_sysmsg());
+
+    return ch;
+}
+
+/* watchEvent()
+ * Report the job state pushed by mbatchd as the
+ * polling would have done, a lost watch is
+ * replaced by polling.
+ */
+static int
+watchEvent(int ch)
+{
+    struct jobWatchEnt jw;
+
+    if (lsb_readwatch(ch, &jw, 60) < 0) {
+        ls_syslog(LOG_INFO, "\
+%s: lost the mbatchd watch of job %s, polling mbatchd",
+                  __func__, lsb_jobid2str(jobId));
+        return -1;
+    }
+
+    if (nioDebug) {
+        ls_syslog(LOG_DEBUG, "%s: Nios job<%s> status<0x%x>",
+                  __func__, lsb_jobid2str(jw.jobId), jw.status);
+    }
+
+    if (jobStatusInterval > 0
+        && (jw.status == JOB_STAT_NULL
+            || IS_FINISH(jw.status)))
+        checkJobStatus(1);
+
+    if (msgInterval > 0)
+        JobStateInfo(jobId);
+
+    return ch;
+}
+
 JOB_STATUS
 getJobStatus(LS_LONG_INT jid, struct jobInfoEnt **job, struct jobInfoHead **jobHead)
 {
@@ -62,7 +62,17 @@ struct sockaddr_in ctrlAddr;
 
 int child_res_port  = INVALID_FD;
 int parent_res_port = INVALID_FD;
-fd_set readmask, writemask, exceptmask;
+
+/* The descriptors the main loop waits on, rebuilt by
+ * getMaskReady() at every pass. pollIndex maps a descriptor
+ * to its slot in pollFds, poll() unlike select() has no
+ * FD_SETSIZE ceiling on the descriptor numbers.
+ */
+static struct pollfd *pollFds;
+static int numPollFds;
+static int sizePollFds;
+static int *pollIndex;
+static int sizePollIndex;
 
 int on  = 1;
 int off = 0;
@@ -117,7 +127,6 @@ struct config_param resConfParams[] = {
     {NULL, NULL}
 };
 
-static void put_mask(char *, fd_set *);
 static void periodic(void);
 static void usage(char *);
 static void initSignals(void);
@@ -139,19 +148,16 @@ main(int argc, char **argv)
     static char fname[] = "res/main";
     int cc;
     int nready;
-    int maxfd;
     int i;
     char *sp;
     char *pathname = NULL;
     int didSomething = 0;
     char exbuf;
-    fd_set rm, wm, em;
     int sbdPty = FALSE;
     char *sbdClHost = NULL;
     ushort sbdClPort = 0;
     char **sbdArgv = NULL;
-    int selectError = 0;
-    struct timeval tv;
+    int pollError = 0;
 
     saveDaemonDir_(argv[0]);
 
@@ -291,8 +297,6 @@ main(int argc, char **argv)
         lsbJobStart(sbdArgv, sbdClPort, sbdClHost, sbdPty);
     }
 
-    maxfd = FD_SETSIZE;
-
     /*
      * Following loop is completely event driven.  Sleep on various
      * file descriptors until some of them is ready for i/o: either
@@ -355,33 +359,23 @@ main(int argc, char **argv)
         }
 
         houseKeeping();
-        getMaskReady(&readmask, &writemask, &exceptmask);
+        getMaskReady();
         if (debug > 1) {
             printf("Masks Set: ");
-            display_masks(&readmask, &writemask, &exceptmask);
+            display_masks();
             fflush(stdout);
         }
 
         unblock_sig_chld();
 
-        FD_ZERO(&rm);
-        FD_ZERO(&wm);
-        FD_ZERO(&em);
-        memcpy(&rm, &readmask, sizeof(fd_set));
-        memcpy(&wm, &writemask, sizeof(fd_set));
-        memcpy(&em, &exceptmask, sizeof(fd_set));
-
         if (res_interrupted > 0) {
             block_sig_chld();
             res_interrupted = 0;
             continue;
         }
 
-        tv.tv_sec = RES_SLEEP_TIME;
-        tv.tv_usec = 0;
-
-        nready = select(maxfd, &readmask, &writemask, &exceptmask, &tv);
-        selectError = errno;
+        nready = poll(pollFds, numPollFds, RES_SLEEP_TIME * 1000);
+        pollError = errno;
         block_sig_chld();
 
         if (nready == 0) {
@@ -390,25 +384,35 @@ main(int argc, char **argv)
         }
 
         if (nready < 0) {
-            errno = selectError;
-            if (selectError == EBADF) {
-                ls_syslog(LOG_ERR, "%s: select() failed %m", __func__);
-                if (child_res) {
-                    resExit_(-1);
-                }
-            } else if (selectError != EINTR) {
-                ls_syslog(LOG_ERR, "%s: select() failed %m", __func__);
+            errno = pollError;
+            if (pollError != EINTR) {
+                ls_syslog(LOG_ERR, "%s: poll() failed %m", __func__);
             }
             continue;
         }
 
         if (debug > 1) {
             printf("Masks Get:  ");
-            display_masks(&readmask, &writemask, &exceptmask);
+            display_masks();
+        }
+
+        /* select() used to fail with EBADF here
+         */
+        for (i = 0; i < numPollFds; i++) {
+            if (pollFds[i].revents & POLLNVAL) {
+                ls_syslog(LOG_ERR, "\
+%s: poll() invalid descriptor %d", __func__, pollFds[i].fd);
+                if (child_res) {
+                    resExit_(-1);
+                }
+                break;
+            }
         }
+        if (i < numPollFds)
+            continue;
 
         if (FD_IS_VALID(parent_res_port)
-            && FD_ISSET(parent_res_port, &readmask))
+            && resPollIsSet(parent_res_port, POLLIN))
         {
 
             if (! allow_accept){
@@ -429,19 +433,19 @@ main(int argc, char **argv)
         }
 
         if (FD_IS_VALID(conn2NIOS.sock.fd)
-            && FD_ISSET(conn2NIOS.sock.fd, &readmask)) {
+            && resPollIsSet(conn2NIOS.sock.fd, POLLIN)) {
             donios_sock(children, DOREAD);
             goto loop;
         }
         if (FD_IS_VALID(conn2NIOS.sock.fd)
-            && FD_ISSET(conn2NIOS.sock.fd, &writemask)) {
+            && resPollIsSet(conn2NIOS.sock.fd, POLLOUT)) {
             donios_sock(children, DOWRITE);
             goto loop;
         }
 
         for (i = 0; i < child_cnt; i++) {
             if (  FD_IS_VALID(children[i]->info)
-                  && FD_ISSET(children[i]->info, &readmask))
+                  && resPollIsSet(children[i]->info, POLLIN))
             {
                 if (logclass & LC_TRACE) {
                     dumpChild(children[i], DOREAD, "child info in readmask");
@@ -455,7 +459,7 @@ main(int argc, char **argv)
 
         for (i = 0; i < client_cnt; i++) {
             if (  FD_IS_VALID(clients[i]->client_sock)
-                  && FD_ISSET(clients[i]->client_sock, &readmask))
+                  && resPollIsSet(clients[i]->client_sock, POLLIN))
             {
                 if (logclass & LC_TRACE) {
                     dumpClient(clients[i], "client_sock in readmask");
@@ -467,7 +471,7 @@ main(int argc, char **argv)
 
         for (i = 0; i < child_cnt; i++)  {
             if (  FD_IS_VALID(children[i]->std_out.fd)
-                  && FD_ISSET(children[i]->std_out.fd, &readmask))
+                  && resPollIsSet(children[i]->std_out.fd, POLLIN))
             {
                 if (logclass & LC_TRACE) {
                     dumpChild(children[i], DOREAD,
@@ -477,7 +481,7 @@ main(int argc, char **argv)
                 didSomething = 1;
             }
             if (  FD_IS_VALID(children[i]->std_err.fd)
-                  && FD_ISSET(children[i]->std_err.fd, &readmask))
+                  && resPollIsSet(children[i]->std_err.fd, POLLIN))
             {
                 if (logclass & LC_TRACE) {
                     dumpChild(children[i], DOSTDERR,
@@ -492,7 +496,7 @@ main(int argc, char **argv)
 
         for (i = 0; i < child_cnt; i++) {
             if (  FD_IS_VALID(children[i]->stdio)
-                  && FD_ISSET(children[i]->stdio, &writemask))
+                  && resPollIsSet(children[i]->stdio, POLLOUT))
             {
                 if (logclass & LC_TRACE) {
                     dumpChild(children[i], DOWRITE,
@@ -506,12 +510,12 @@ main(int argc, char **argv)
             goto loop;
 
         if (FD_IS_VALID(accept_sock) &&
-            FD_ISSET(accept_sock, &readmask)) {
+            resPollIsSet(accept_sock, POLLIN)) {
             doacceptconn();
         }
 
         if (FD_IS_VALID(ctrlSock) &&
-            FD_ISSET(ctrlSock, &readmask)) {
+            resPollIsSet(ctrlSock, POLLIN)) {
             doResParentCtrl();
         }
     } /* for (;;) */
@@ -565,30 +569,30 @@ initSignals(void)
 }
 
 void
-getMaskReady(fd_set *rm, fd_set *wm, fd_set *em)
+getMaskReady(void)
 {
     int     i;
 
-    FD_ZERO(rm);
-    FD_ZERO(wm);
-    FD_ZERO(em);
+    for (i = 0; i < numPollFds; i++)
+        pollIndex[pollFds[i].fd] = -1;
+    numPollFds = 0;
 
     if (allow_accept && FD_IS_VALID(accept_sock)) {
-        FD_SET(accept_sock, rm);
+        resPollSet(accept_sock, POLLIN);
     }
 
     if (allow_accept && FD_IS_VALID(ctrlSock)) {
-        FD_SET(ctrlSock, rm);
+        resPollSet(ctrlSock, POLLIN);
     }
 
     if (child_res && !child_go && FD_IS_VALID(parent_res_port)) {
-        FD_SET(parent_res_port, rm);
+        resPollSet(parent_res_port, POLLIN);
     }
 
 
     for (i = 0; i < client_cnt; i++) {
         if (FD_IS_VALID(clients[i]->client_sock)) {
-            FD_SET(clients[i]->client_sock, rm);
+            resPollSet(clients[i]->client_sock, POLLIN);
 
             if (debug > 2)
                 fprintf(stderr, "RM: client_sock for client <%d>: %d\n",
@@ -623,30 +627,32 @@ getMaskReady(fd_set *rm, fd_set *wm, fd_set *em)
         if ((children[i]->rexflag & REXF_USEPTY) &&
             FD_IS_VALID(children[i]->std_out.fd)) {
             if (children[i]->std_out.buffer.bcount == 0)
-                FD_SET(children[i]->std_out.fd, em);
+                resPollSet(children[i]->std_out.fd, POLLPRI);
         }
 
 
         if (FD_IS_VALID(children[i]->stdio)) {
 
             if (children[i]->i_buf.bcount > 0 || children[i]->endstdin)
-                FD_SET(children[i]->stdio, wm);
+                resPollSet(children[i]->stdio, POLLOUT);
         }
 
 
         if (FD_IS_VALID(children[i]->std_out.fd)
-            && (children[i]->std_out.buffer.bcount < LINE_BUFSIZ) ) {
-            FD_SET(children[i]->std_out.fd, rm);
+            && (children[i]->std_out.buffer.bcount
+                < children[i]->std_out.buffer.size) ) {
+            resPollSet(children[i]->std_out.fd, POLLIN);
         }
 
 
         if (FD_IS_VALID(children[i]->std_err.fd)
-            && (children[i]->std_err.buffer.bcount < LINE_BUFSIZ) ) {
-            FD_SET(children[i]->std_err.fd, rm);
+            && (children[i]->std_err.buffer.bcount
+                < children[i]->std_err.buffer.size) ) {
+            resPollSet(children[i]->std_err.fd, POLLIN);
         }
 
         if (FD_IS_VALID(children[i]->info)) {
-            FD_SET(children[i]->info, rm);
+            resPollSet(children[i]->info, POLLIN);
         }
 
     }
@@ -654,34 +660,113 @@ getMaskReady(fd_set *rm, fd_set *wm, fd_set *em)
 
     if (FD_IS_VALID(conn2NIOS.sock.fd)) {
         if (conn2NIOS.sock.rbuf->bcount == 0)
-            FD_SET(conn2NIOS.sock.fd, rm);
+            resPollSet(conn2NIOS.sock.fd, POLLIN);
 
         if (conn2NIOS.sock.wcount != 0)
-            FD_SET(conn2NIOS.sock.fd, wm);
+            resPollSet(conn2NIOS.sock.fd, POLLOUT);
         else if (conn2NIOS.sock.wbuf->bcount != 0)
-            FD_SET(conn2NIOS.sock.fd, wm);
+            resPollSet(conn2NIOS.sock.fd, POLLOUT);
     }
 
 }
 
 void
-display_masks(fd_set *rm, fd_set *wm, fd_set *em)
+display_masks(void)
 {
-    put_mask("RM", rm);
-    put_mask("WM", wm);
-    put_mask("EM", em);
+    int i;
+
+    for (i = 0; i < numPollFds; i++) {
+        printf("%d:%s%s%s/0x%x ", pollFds[i].fd,
+               (pollFds[i].events & POLLIN) ? "R" : "",
+               (pollFds[i].events & POLLOUT) ? "W" : "",
+               (pollFds[i].events & POLLPRI) ? "E" : "",
+               pollFds[i].revents);
+    }
     fputs("\n", stdout);
 }
 
-static void
-put_mask(char *name, fd_set *mask)
+/* resPollSet()
+ *
+ * Wait for events on fd in the next poll().
+ */
+void
+resPollSet(int fd, short events)
 {
-    fputs(name, stdout);
-    putchar(':');
-#if !defined(__CYGWIN__) && !defined(__sun__)
-    printf("0x%8.8x ", (int) mask->__fds_bits[0]);
-#endif
-    fputs("  ", stdout);
+    int i;
+
+    if (fd >= sizePollIndex) {
+        int size;
+
+        size = sizePollIndex ? sizePollIndex : 64;
+        while (size <= fd)
+            size = 2 * size;
+        pollIndex = realloc(pollIndex, size * sizeof(int));
+        if (pollIndex == NULL) {
+            ls_syslog(LOG_ERR, I18N_FUNC_FAIL_M, __func__, "realloc");
+            resExit_(-1);
+        }
+        for (i = sizePollIndex; i < size; i++)
+            pollIndex[i] = -1;
+        sizePollIndex = size;
+    }
+
+    if ((i = pollIndex[fd]) >= 0) {
+        pollFds[i].events |= events;
+        return;
+    }
+
+    if (numPollFds == sizePollFds) {
+        sizePollFds = sizePollFds ? 2 * sizePollFds : 64;
+        pollFds = realloc(pollFds, sizePollFds * sizeof(struct pollfd));
+        if (pollFds == NULL) {
+            ls_syslog(LOG_ERR, I18N_FUNC_FAIL_M, __func__, "realloc");
+            resExit_(-1);
+        }
+    }
+
+    i = numPollFds++;
+    pollFds[i].fd = fd;
+    pollFds[i].events = events;
+    pollFds[i].revents = 0;
+    pollIndex[fd] = i;
+}
+
+/* resPollIsSet()
+ *
+ * Did the last poll() report fd ready for the events,
+ * as select() an error or a hangup makes fd ready.
+ */
+int
+resPollIsSet(int fd, short events)
+{
+    int i;
+
+    if (fd < 0
+        || fd >= sizePollIndex
+        || (i = pollIndex[fd]) < 0)
+        return FALSE;
+
+    if (pollFds[i].revents & (POLLERR | POLLHUP))
+        return (pollFds[i].events & events) != 0;
+
+    return (pollFds[i].revents & events) != 0;
+}
+
+/* resPollClr()
+ *
+ * Forget the events of fd, it is being closed.
+ */
+void
+resPollClr(int fd)
+{
+    int i;
+
+    if (fd < 0
+        || fd >= sizePollIndex
+        || (i = pollIndex[fd]) < 0)
+        return;
+
+    pollFds[i].revents = 0;
 }
 
 static void
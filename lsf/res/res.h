@@ -56,7 +56,6 @@ extern char allow_accept;
 extern char magic_str[];
 extern int child_res_port;
 extern int parent_res_port;
-extern fd_set readmask, writemask, exceptmask;
 
 extern int ctrlSock;
 extern struct sockaddr_in ctrlAddr;
@@ -243,8 +242,11 @@ extern void term_handler(int);
 extern void sigHandler(int);
 extern void child_handler(void);
 extern void child_handler_ext(void);
-extern void getMaskReady(fd_set *rm, fd_set *wm, fd_set *em);
-extern void display_masks(fd_set *, fd_set *, fd_set *);
+extern void getMaskReady(void);
+extern void display_masks(void);
+extern void resPollSet(int, short);
+extern int resPollIsSet(int, short);
+extern void resPollClr(int);
 
 extern int b_read_fix(int, char *, int);
 extern int b_write_fix(int, char *, int);
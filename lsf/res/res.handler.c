@@ -59,6 +59,9 @@ static void eof_to_nios(struct child *);
 static void eof_to_client(struct child *);
 static void setptymode(ttyStruct *, int);
 static void freeblk(char **);
+static int initOutBuf(ResOutBuf *);
+static void growOutBuf(ResOutBuf *);
+static int packNiosOut(char *, int);
 static char **copyArray(char **);
 
 static int notify_sigchild(struct child *);
@@ -890,7 +893,7 @@ dochild_info(struct child *chld, int op)
                         &msgHdr);
     if (cc < 0) {
         if (lserrno == LSE_MSG_SYS) {
-            FD_CLR(chld->info, &readmask);
+            resPollClr(chld->info);
             ls_syslog(LOG_DEBUG, "%s: task <%d> closed info <%d>:%M",
                       fname, chld->rpid, chld->info);
             CLOSE_IT(chld->info);
@@ -1931,7 +1934,9 @@ doRexec(struct client *cli_ptr,
 
     sigStatRu = calloc(1, sizeof(struct sigStatusUsage));
     if (child_ptr == (struct child *) NULL ||
-        sigStatRu == (struct sigStatusUsage *) NULL) {
+        sigStatRu == (struct sigStatusUsage *) NULL ||
+        initOutBuf(&child_ptr->std_out.buffer) < 0 ||
+        initOutBuf(&child_ptr->std_err.buffer) < 0) {
         ls_syslog(LOG_ERR, "%s: calloc() failed %m", __func__);
         if (cmdmsg->options & REXF_USEPTY) {
             close(pty[0]);
@@ -2991,9 +2996,7 @@ delete_client(struct client *cli_ptr)
     closesocket(cli_ptr->client_sock);
 
     if (FD_IS_VALID(cli_ptr->client_sock)) {
-        FD_CLR(cli_ptr->client_sock, &readmask);
-        FD_CLR(cli_ptr->client_sock, &writemask);
-        FD_CLR(cli_ptr->client_sock, &exceptmask);
+        resPollClr(cli_ptr->client_sock);
     }
 
     free(cli_ptr->username);
@@ -3041,9 +3044,7 @@ delete_child(struct child *cp)
     child_cnt--;
 
     if (FD_IS_VALID(cp->stdio)) {
-        FD_CLR(cp->stdio, &readmask);
-        FD_CLR(cp->stdio, &writemask);
-        FD_CLR(cp->stdio, &exceptmask);
+        resPollClr(cp->stdio);
 
         CLOSE_IT(cp->stdio);
         cp->std_out.fd = INVALID_FD;
@@ -3057,7 +3058,7 @@ delete_child(struct child *cp)
     }
 
     if (FD_IS_VALID(cp->std_err.fd)) {
-        FD_CLR(cp->std_err.fd, &readmask);
+        resPollClr(cp->std_err.fd);
         CLOSE_IT(cp->std_err.fd);
     }
 
@@ -3070,6 +3071,9 @@ delete_child(struct child *cp)
     if (cp->sigStatRu)
         free(cp->sigStatRu);
 
+    FREEUP(cp->std_out.buffer.buf);
+    FREEUP(cp->std_err.buffer.buf);
+
     if (logclass & LC_TRACE) {
         ls_syslog(LOG_DEBUG,"\
 %s: Res has destroyed the child=<%x> current number of child is=<%d>",
@@ -4073,13 +4077,103 @@ sendReturnCode(int s, int code)
     return 0;
 }
 
+/* initOutBuf()
+ */
+static int
+initOutBuf(ResOutBuf *buffer)
+{
+    buffer->buf = malloc(LINE_BUFSIZ + sizeof(struct LSFHeader));
+    if (buffer->buf == NULL)
+        return -1;
+
+    buffer->bp = BUFSTART(buffer);
+    buffer->bcount = 0;
+    buffer->size = LINE_BUFSIZ;
+
+    return 0;
+}
+
+/* growOutBuf()
+ *
+ * Double the output buffer of a child, keep the
+ * old one if there is no memory.
+ */
+static void
+growOutBuf(ResOutBuf *buffer)
+{
+    char *buf;
+    int off;
+    int size;
+
+    size = 2 * buffer->size;
+    if (size > RES_BUFMAX)
+        size = RES_BUFMAX;
+
+    off = buffer->bp - buffer->buf;
+    buf = realloc(buffer->buf, size + sizeof(struct LSFHeader));
+    if (buf == NULL)
+        return;
+
+    buffer->buf = buf;
+    buffer->bp = buf + off;
+    buffer->size = size;
+}
+
+/* packNiosOut()
+ *
+ * Pack the output of the conn2NIOS.wtag task in the NIOS
+ * write buffer as messages of at most LINE_BUFSIZ bytes,
+ * they are written out together.
+ */
+static int
+packNiosOut(char *data, int len)
+{
+    struct LSFHeader hdr;
+    ResOutBuf *wbuf;
+    char *p;
+    int cc;
+
+    wbuf = conn2NIOS.sock.wbuf;
+    wbuf->bcount = len;
+
+    p = wbuf->buf;
+    while (len > 0) {
+
+        cc = len;
+        if (cc > LINE_BUFSIZ)
+            cc = LINE_BUFSIZ;
+
+        initLSFHeader_(&hdr);
+        hdr.opCode = conn2NIOS.sock.opCode;
+        hdr.version = OPENLAVA_XDR_VERSION;
+        hdr.length = cc;
+        hdr.reserved = conn2NIOS.wtag;
+
+        if (!xdr_packLSFHeader(p, &hdr)) {
+            wbuf->bcount = 0;
+            return -1;
+        }
+        p += LSF_HEADER_LEN;
+
+        memcpy(p, data, cc);
+        p += cc;
+        data += cc;
+        len -= cc;
+    }
+
+    wbuf->bp = wbuf->buf;
+    conn2NIOS.sock.wcount = p - wbuf->buf;
+
+    return 0;
+}
+
 void
 child_channel_clear(struct child *chld, outputChannel *channel)
 {
     static char fname[] = "child_channel_clear";
     int cc, len;
     char cvalue;
-    RelayLineBuf *buffer = &(channel->buffer);
+    ResOutBuf *buffer = &(channel->buffer);
 
     if (debug > 1) {
         printf("%s: buffer->bcount=%d\n", fname, buffer->bcount);
@@ -4087,12 +4181,10 @@ child_channel_clear(struct child *chld, outputChannel *channel)
     }
 
 
-    if (buffer->bcount >= LINE_BUFSIZ)
+    if (buffer->bcount >= buffer->size)
         return;
 
-    len = LINE_BUFSIZ - buffer->bcount;
-    if (len > LINE_BUFSIZ)
-        len = LINE_BUFSIZ;
+    len = buffer->size - buffer->bcount;
 
     buffer->bp = BUFSTART(buffer) + buffer->bcount;
 
@@ -4224,6 +4316,13 @@ child_channel_clear(struct child *chld, outputChannel *channel)
 
     channel->bytes += cc;
 
+    /* The child writes faster than we drain it,
+     * read more at once from now on.
+     */
+    if (cc == len
+        && buffer->size < RES_BUFMAX)
+        growOutBuf(buffer);
+
     if (logclass & LC_TRACE) {
         ls_syslog(LOG_DEBUG,"\
 %s: Res read=<%d> bytes from child=<%x> bytes=<%d> buffer->bcount=<%d>",
@@ -5077,7 +5176,6 @@ dochild_buffer(struct child *chld, int op)
                     char *p;
                     int bcount;
                     p = channel->buffer.bp = BUFSTART(&(channel->buffer));
-                    conn2NIOS.sock.wbuf->bp = BUFSTART(conn2NIOS.sock.wbuf);
                     bcount = channel->buffer.bcount;
                     if ( linebuf == -1 ) {
 
@@ -5111,30 +5209,32 @@ dochild_buffer(struct child *chld, int op)
                                 printf("\"\n");
                                 fflush(stdout);
                             }
-                            if (bcount < LINE_BUFSIZ && !channel->endFlag)
+                            if (bcount < channel->buffer.size
+                                && !channel->endFlag)
                                 return;
                         }
                     }
 
-                    memcpy((char *) conn2NIOS.sock.wbuf->bp,
-                           (char *) channel->buffer.bp,
-                           bcount);
-                    conn2NIOS.sock.wbuf->bcount = bcount;
-                    channel->buffer.bcount -= bcount;
                     conn2NIOS.wtag = chld->rpid;
-                    if (channel->buffer.bcount > 0) {
-
-                        for (i=0; i < channel->buffer.bcount; i++)
-                            channel->buffer.bp[i] = p[i];
-                    }
-
-
                     if (op == DOSTDERR) {
                         conn2NIOS.sock.opCode = RES2NIOS_STDERR;
                     } else {
                         conn2NIOS.sock.opCode = RES2NIOS_STDOUT;
                     }
 
+                    if (packNiosOut(channel->buffer.bp, bcount) < 0) {
+                        ls_syslog(LOG_ERR, I18N_FUNC_FAIL, fname,
+                                  "xdr_packLSFHeader");
+                        unlink_child(chld);
+                        return;
+                    }
+                    channel->buffer.bcount -= bcount;
+                    if (channel->buffer.bcount > 0) {
+
+                        for (i=0; i < channel->buffer.bcount; i++)
+                            channel->buffer.bp[i] = p[i];
+                    }
+
                     if (debug > 1) {
                         printf("%d bytes moved to wbuf, %d bytes left\n",
                                bcount, channel->buffer.bcount);
@@ -5422,31 +5522,10 @@ donios_sock(struct child **children, int op)
             }
 
         case DOWRITE:
-            if (conn2NIOS.sock.wcount == 0) {
-                struct LSFHeader reqHdr;
-
-                if (conn2NIOS.sock.wbuf->bcount == 0)
-                    return;
-
-                initLSFHeader_(&reqHdr);
-                reqHdr.opCode = conn2NIOS.sock.opCode;
-                reqHdr.version = OPENLAVA_XDR_VERSION;
-                reqHdr.length = conn2NIOS.sock.wbuf->bcount;
-                reqHdr.reserved = conn2NIOS.wtag;
-                conn2NIOS.sock.wbuf->bp -= LSF_HEADER_LEN;
-
-                if (!xdr_packLSFHeader(conn2NIOS.sock.wbuf->bp, &reqHdr)) {
-                    ls_syslog(LOG_ERR, I18N_FUNC_FAIL, fname, "xdr_packLSFHeader");
-                    for (i = 0; i < child_cnt; i++)
-                        if (children[i]->rpid == conn2NIOS.wtag) {
-                            unlink_child(children[i]);
-                            break;
-                        }
-                    return;
-                }
-                conn2NIOS.sock.wcount = conn2NIOS.sock.wbuf->bcount
-                    + LSF_HEADER_LEN;
-            }
+            /* The messages were packed by packNiosOut()
+             */
+            if (conn2NIOS.sock.wcount == 0)
+                return;
 
             if ((cc = write(conn2NIOS.sock.fd, conn2NIOS.sock.wbuf->bp,
                             conn2NIOS.sock.wcount)) <= 0) {
@@ -60,11 +60,19 @@ initConn2NIOS(void)
         ls_syslog(LOG_ERR, I18N_FUNC_FAIL_M, fname, "calloc");
         resExit_(-1);
     }
-    conn2NIOS.sock.wbuf = (RelayLineBuf *) malloc(sizeof(RelayLineBuf));
+    conn2NIOS.sock.wbuf = (ResOutBuf *) malloc(sizeof(ResOutBuf));
     if (!conn2NIOS.sock.wbuf) {
         ls_syslog(LOG_ERR, I18N_FUNC_FAIL_M, fname, "calloc");
         resExit_(-1);
     }
+    conn2NIOS.sock.wbuf->size = RES_BUFMAX;
+    conn2NIOS.sock.wbuf->buf = malloc(RES_BUFMAX
+                                      + (RES_BUFMAX / LINE_BUFSIZ + 1)
+                                      * sizeof(struct LSFHeader));
+    if (!conn2NIOS.sock.wbuf->buf) {
+        ls_syslog(LOG_ERR, I18N_FUNC_FAIL_M, fname, "malloc");
+        resExit_(-1);
+    }
     conn2NIOS.sock.fd = -1;
     conn2NIOS.wtag = conn2NIOS.rtag = -1;
     conn2NIOS.num_duped = 0;
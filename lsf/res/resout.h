@@ -159,6 +159,21 @@ typedef struct relaylinebuf {
     int        bcount;
 } RelayLineBuf;
 
+/* The output buffers of the RES children start at LINE_BUFSIZ
+ * and double up to RES_BUFMAX while the child keeps filling
+ * them. The NIOS write buffer holds the RES_BUFMAX bytes cut
+ * in messages of at most LINE_BUFSIZ bytes, the size of the
+ * NIOS read buffer.
+ */
+#define RES_BUFMAX (16 * LINE_BUFSIZ)
+
+typedef struct resoutbuf {
+    char       *buf;
+    char       *bp;
+    int        bcount;
+    int        size;
+} ResOutBuf;
+
 typedef struct channel {
     int        fd;
     RelayBuf   *rbuf;
@@ -171,7 +186,7 @@ typedef struct nioschannel {
     int            fd;
     RelayBuf       *rbuf;
     int            rcount;
-    RelayLineBuf   *wbuf;
+    ResOutBuf      *wbuf;
     int            wcount;
     int            opCode;
 } niosChannel;
@@ -182,7 +197,7 @@ typedef struct outputchannel {
     int             endFlag;
     int             retry;
     int             bytes;
-    RelayLineBuf    buffer;
+    ResOutBuf       buffer;
 } outputChannel;
 
 
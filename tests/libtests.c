@@ -581,9 +581,59 @@ test14(int n)
     failed(__func__);
     return -1;
 }
+
+/* test15
+ *
+ * Test the host groups are still known to mbd
+ * after reconfig, run it on a cluster having a
+ * queue with HOSTS_SHARES naming a host group.
+ *
+ */
 int
 test15(int n)
 {
+    struct groupInfoEnt *grp;
+    struct hostInfoEnt *hosts;
+    char *name;
+    int num;
+    int numHosts;
+    int cc;
+    int i;
+
+    printf("I am %s number %d\n", __func__, n);
+
+    for (cc = 0; cc < 2; cc++) {
+
+        num = 0;
+        grp = lsb_hostgrpinfo(NULL, &num, 0);
+        if (grp == NULL) {
+            lsb_perror("lsb_hostgrpinfo()");
+            failed(__func__);
+            return -1;
+        }
+
+        for (i = 0; i < num; i++) {
+            name = grp[i].group;
+            numHosts = 1;
+            hosts = lsb_hostinfo(&name, &numHosts);
+            if (hosts == NULL) {
+                lsb_perror(name);
+                failed(__func__);
+                return -1;
+            }
+            printf("Host group %s has %d hosts\n", name, numHosts);
+        }
+
+        if (cc > 0)
+            break;
+
+        sprintf(buf, "badmin reconfig");
+        system(buf);
+
+        ssleep(15);
+    }
+
+    done(__func__);
     return 0;
 }
 int
@@ -0,0 +1,1579 @@
+/*
+ * Copyright (C) 2016 David Bigagli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ */
+
+#include "tests.h"
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <poll.h>
+#include "../lsbatch/daemons/daemons.h"
+#include "../lsf/lim/limout.h"
+#include "../lsf/lib/lib.xdr.h"
+
+/* Stress the daemons of a running cluster with concurrent
+ * clients. Every client is a process running the selected
+ * operations in turn for the given time, at the given rate
+ * or as fast as it can, and timing each of them. At the end
+ * the latencies of all clients are merged and printed per
+ * operation with the throughput. With -p the resident memory
+ * of a local daemon is sampled before and after the run.
+ *
+ * The operations are the requests the commands send:
+ *
+ *   jobs    bjobs -u all, mbatchd
+ *   hosts   bhosts, mbatchd
+ *   queues  bqueues, mbatchd
+ *   submit  bsub -o /dev/null true, mbatchd
+ *   load    lsload, LIM
+ *   place   lsplace, LIM
+ *
+ * submit creates jobs so it is run only when asked for.
+ *
+ * With -e the program also emulates the given number of
+ * slave hosts, each on its own loopback address counting
+ * from -a, 127.1.0.1 by default. An emulated LIM sends its
+ * configuration and load to the master LIM, an emulated
+ * sbatchd accepts the jobs mbatchd starts on it and reports
+ * them running, then done after -j seconds. The status
+ * requests are timed as the operation status. The daemons
+ * know a host by its address so the hosts must be in the
+ * hosts file and in lsf.cluster, -g prints their lines.
+ * The loopback addresses are local, the emulation runs on
+ * the master host with its sbatchd stopped since the
+ * emulated ones listen on the sbatchd port.
+ */
+
+struct sample {
+    int op;
+    int ok;
+    int usec;
+};
+
+struct stressOp {
+    char *name;
+    int (*func)(void);
+};
+
+static int opJobs(void);
+static int opHosts(void);
+static int opQueues(void);
+static int opSubmit(void);
+static int opLoad(void);
+static int opPlace(void);
+
+static struct stressOp ops[] = {
+    {"jobs", opJobs},
+    {"hosts", opHosts},
+    {"queues", opQueues},
+    {"submit", opSubmit},
+    {"load", opLoad},
+    {"place", opPlace},
+    {"status", NULL},
+    {NULL, NULL}
+};
+
+#define DEF_OPS "jobs,hosts,queues,load,place"
+
+static char *queue;
+static int selected[sizeof(ops)/sizeof(ops[0])];
+static int numSelected;
+
+static void usage(void);
+static int selectOps(char *);
+static void client(int, int, int);
+static int readSamples(int, struct sample **, int *, int *);
+static void report(struct sample *, int, int);
+static long rssOf(pid_t);
+static int cmpUsec(const void *, const void *);
+static int addSample(struct sample **, int *, int *, int, int, long);
+static int writeSamples(int, struct sample *, int);
+
+/* An emulated slave host, its LIM datagram socket,
+ * its sbatchd listening socket and the channel its
+ * sbatchd reports the job status on.
+ */
+struct emuHost {
+    char name[MAXHOSTNAMELEN];
+    struct sockaddr_in addr;
+    int lim;
+    int sbd;
+    int mbd;
+    int seq;
+    u_int loadSeq;
+    int numJobs;
+};
+
+struct emuJob {
+    struct emuJob *next;
+    LS_LONG_INT jobId;
+    struct emuHost *host;
+    int pid;
+    int userId;
+    char *userName;
+    char *cwd;
+    int reported;
+    int newStatus;
+    time_t done;
+};
+
+/* A channel mbatchd keeps after a job start until
+ * it acknowledges the reply.
+ */
+struct emuConn {
+    int fd;
+    time_t time;
+};
+
+#define EMU_LOAD_INTVL  5
+#define EMU_CONF_EVERY  12
+#define EMU_TIMEOUT     30
+#define EMU_CPUS        8
+#define EMU_MEM         8192
+#define EMU_SWAP        4096
+#define EMU_TMP         10240
+
+static struct emuHost *emuHosts;
+static int numEmuHosts;
+static struct emuJob *emuJobs;
+static struct emuConn *emuConns;
+static int numEmuConns;
+static int maxEmuConns;
+static struct sample *emuSamples;
+static int numEmuSamples;
+static int maxEmuSamples;
+static in_addr_t emuBase;
+static struct sockaddr_in limAddr;
+static struct sockaddr_in mbdAddr;
+static u_short sbdPort;
+static char *emuType;
+static float *emuLoad;
+static int numIndx;
+static int numUsrIndx;
+static int emuRunTime;
+static int emuOp;
+static int emuPid;
+static int emuStarted;
+static int emuFinished;
+
+static int genConfig(int);
+static int emuInit(int);
+static void emuClose(void);
+static void emulate(int, int);
+static void emuHostName(int, char *);
+static in_addr_t emuAddr(int);
+static u_short emuPort(char *, char *, char *);
+static void emuSendConf(struct emuHost *);
+static void emuSendLoad(struct emuHost *);
+static u_short emuFloat16(float);
+static void emuAccept(struct emuHost *);
+static int emuRead(int, struct LSFHeader *, char **);
+static int emuReply(int, int, struct jobReply *);
+static int emuReplyJob(int, struct emuJob *);
+static int emuNewJob(struct emuHost *, int, XDR *, struct LSFHeader *);
+static void emuSigJob(int, XDR *, struct LSFHeader *);
+static void emuModJob(int, XDR *, struct LSFHeader *);
+static struct emuJob *emuFind(LS_LONG_INT);
+static void emuKeep(int);
+static void emuReport(time_t);
+static int emuStatus(struct emuJob *, int);
+static int emuConnect(struct emuHost *);
+static void emuFree(struct emuJob *);
+
+int
+main(int argc, char **argv)
+{
+    struct sample *samples;
+    int numSamples;
+    int maxSamples;
+    int numClients;
+    int numHosts;
+    int numFds;
+    int duration;
+    int rate;
+    int genConf;
+    char *mix;
+    char *base;
+    pid_t pid;
+    long rss0;
+    long rss1;
+    int *fds;
+    int pfd[2];
+    int cc;
+    int i;
+
+    numClients = 1;
+    duration = 10;
+    rate = 0;
+    mix = DEF_OPS;
+    pid = 0;
+    numHosts = 0;
+    base = "127.1.0.1";
+    emuRunTime = 10;
+    genConf = FALSE;
+
+    while ((cc = getopt(argc, argv, "hc:t:r:o:q:p:e:a:j:g")) != EOF) {
+        switch (cc) {
+            case 'c':
+                numClients = atoi(optarg);
+                break;
+            case 't':
+                duration = atoi(optarg);
+                break;
+            case 'r':
+                rate = atoi(optarg);
+                break;
+            case 'o':
+                mix = optarg;
+                break;
+            case 'q':
+                queue = optarg;
+                break;
+            case 'p':
+                pid = atoi(optarg);
+                break;
+            case 'e':
+                numHosts = atoi(optarg);
+                break;
+            case 'a':
+                base = optarg;
+                break;
+            case 'j':
+                emuRunTime = atoi(optarg);
+                break;
+            case 'g':
+                genConf = TRUE;
+                break;
+            case 'h':
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    if (numClients < 0
+        || numHosts < 0
+        || (numClients == 0 && numHosts == 0)
+        || (genConf && numHosts == 0)
+        || duration <= 0
+        || rate < 0
+        || emuRunTime < 0
+        || (emuBase = inet_addr(base)) == INADDR_NONE
+        || selectOps(mix) < 0) {
+        usage();
+        return -1;
+    }
+
+    if (lsb_init(NULL) < 0) {
+        lsb_perror("lsb_init()");
+        return -1;
+    }
+
+    if (genConf)
+        return genConfig(numHosts);
+
+    if (numHosts > 0 && emuInit(numHosts) < 0) {
+        emuClose();
+        return -1;
+    }
+
+    rss0 = pid ? rssOf(pid) : -1;
+
+    setbuf(stdout, NULL);
+    fds = calloc(numClients + 1, sizeof(int));
+    numFds = 0;
+
+    if (numHosts > 0) {
+
+        printf("Emulate %d hosts from %s jobs run %d seconds\n",
+               numHosts, base, emuRunTime);
+
+        if (pipe(pfd) < 0) {
+            perror("pipe()");
+            return -1;
+        }
+
+        switch (fork()) {
+            case -1:
+                perror("fork()");
+                return -1;
+            case 0:
+                close(pfd[0]);
+                emulate(pfd[1], duration);
+                _exit(0);
+            default:
+                close(pfd[1]);
+                fds[numFds] = pfd[0];
+                ++numFds;
+        }
+        emuClose();
+    }
+
+    printf("Start %d clients for %d seconds rate %d ops %s\n",
+           numClients, duration, rate, mix);
+
+    for (i = 0; i < numClients; i++) {
+
+        if (pipe(pfd) < 0) {
+            perror("pipe()");
+            return -1;
+        }
+
+        switch (fork()) {
+            case -1:
+                perror("fork()");
+                return -1;
+            case 0:
+                close(pfd[0]);
+                client(pfd[1], duration, rate);
+                _exit(0);
+            default:
+                close(pfd[1]);
+                fds[numFds] = pfd[0];
+                ++numFds;
+        }
+    }
+
+    samples = NULL;
+    numSamples = maxSamples = 0;
+    for (i = 0; i < numFds; i++) {
+        if (readSamples(fds[i], &samples, &numSamples, &maxSamples) < 0)
+            fprintf(stderr, "Lost the samples of client %d\n", i);
+        close(fds[i]);
+    }
+
+    while (wait(NULL) > 0)
+        ;
+
+    report(samples, numSamples, duration);
+
+    if (pid) {
+        rss1 = rssOf(pid);
+        printf("rss pid %d start %ldkB end %ldkB growth %ldkB\n",
+               (int)pid, rss0, rss1, rss1 - rss0);
+    }
+
+    free(samples);
+    free(fds);
+
+    return 0;
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr, "\
+usage: stress [-c clients] [-t seconds] [-r rate] [-o op,...] [-q queue] \
+[-p pid]\n              [-e hosts [-a addr] [-j seconds] [-g]]\n\
+  ops: jobs hosts queues submit load place, default %s\n",
+            DEF_OPS);
+}
+
+/* selectOps()
+ */
+static int
+selectOps(char *mix)
+{
+    char *buf;
+    char *p;
+    char *op;
+    int i;
+
+    buf = p = strdup(mix);
+    while ((op = strsep(&p, ",")) != NULL) {
+
+        for (i = 0; ops[i].name; i++) {
+            if (ops[i].func && strcmp(op, ops[i].name) == 0)
+                break;
+        }
+
+        if (ops[i].name == NULL) {
+            fprintf(stderr, "Unknown operation %s\n", op);
+            free(buf);
+            return -1;
+        }
+
+        if (numSelected == sizeof(selected)/sizeof(selected[0])) {
+            fprintf(stderr, "Too many operations in %s\n", mix);
+            free(buf);
+            return -1;
+        }
+        selected[numSelected] = i;
+        ++numSelected;
+    }
+
+    free(buf);
+    return 0;
+}
+
+/* client()
+ * Run the operations and write the samples to fd.
+ */
+static void
+client(int fd, int duration, int rate)
+{
+    struct sample *samples;
+    struct timeval end;
+    struct timeval t0;
+    struct timeval t1;
+    long interval;
+    long spent;
+    int num;
+    int max;
+    int op;
+    int ok;
+    int n;
+
+    samples = NULL;
+    num = max = 0;
+    interval = rate > 0 ? 1000000 / rate : 0;
+
+    gettimeofday(&end, NULL);
+    end.tv_sec += duration;
+
+    for (n = 0; ; n++) {
+
+        gettimeofday(&t0, NULL);
+        if (timercmp(&t0, &end, >=))
+            break;
+
+        op = selected[n % numSelected];
+        ok = (*ops[op].func)() == 0;
+
+        gettimeofday(&t1, NULL);
+        spent = (t1.tv_sec - t0.tv_sec) * 1000000
+            + (t1.tv_usec - t0.tv_usec);
+        if (addSample(&samples, &num, &max, op, ok, spent) < 0)
+            _exit(-1);
+
+        if (spent < interval)
+            usleep(interval - spent);
+    }
+
+    if (writeSamples(fd, samples, num) < 0)
+        _exit(-1);
+}
+
+/* addSample()
+ */
+static int
+addSample(struct sample **samples, int *num, int *max,
+          int op, int ok, long usec)
+{
+    struct sample *s;
+
+    if (*num == *max) {
+        *max = 2 * *max + 1024;
+        s = realloc(*samples, *max * sizeof(struct sample));
+        if (s == NULL)
+            return -1;
+        *samples = s;
+    }
+
+    s = *samples + *num;
+    s->op = op;
+    s->ok = ok;
+    s->usec = usec;
+    ++*num;
+
+    return 0;
+}
+
+/* writeSamples()
+ * Write the samples to fd, their number first.
+ */
+static int
+writeSamples(int fd, struct sample *samples, int num)
+{
+    if (write(fd, &num, sizeof(int)) != sizeof(int)
+        || write(fd, samples, num * sizeof(struct sample))
+        != num * sizeof(struct sample))
+        return -1;
+
+    close(fd);
+    return 0;
+}
+
+/* readSamples()
+ */
+static int
+readSamples(int fd, struct sample **samples, int *num, int *max)
+{
+    struct sample *s;
+    size_t len;
+    ssize_t cc;
+    char *p;
+    int n;
+
+    if (read(fd, &n, sizeof(int)) != sizeof(int))
+        return -1;
+
+    if (*num + n > *max) {
+        *max = *num + n;
+        s = realloc(*samples, *max * sizeof(struct sample));
+        if (s == NULL)
+            return -1;
+        *samples = s;
+    }
+
+    p = (char *)(*samples + *num);
+    len = n * sizeof(struct sample);
+    while (len > 0) {
+        cc = read(fd, p, len);
+        if (cc <= 0)
+            return -1;
+        p += cc;
+        len -= cc;
+    }
+    *num += n;
+
+    return 0;
+}
+
+/* report()
+ * Print per operation the count, errors, operations
+ * per second and latency percentiles in microseconds.
+ */
+static void
+report(struct sample *samples, int num, int duration)
+{
+    int *usec;
+    int count;
+    int errors;
+    int total;
+    int i;
+    int j;
+
+    usec = calloc(num + 1, sizeof(int));
+
+    printf("%-8s %8s %6s %8s %8s %8s %8s %8s\n",
+           "OP", "COUNT", "ERRORS", "OPS/S", "P50", "P90", "P99", "MAX");
+
+    total = 0;
+    for (i = 0; ops[i].name; i++) {
+
+        count = errors = 0;
+        for (j = 0; j < num; j++) {
+            if (samples[j].op != i)
+                continue;
+            usec[count] = samples[j].usec;
+            ++count;
+            if (! samples[j].ok)
+                ++errors;
+        }
+
+        if (count == 0)
+            continue;
+
+        qsort(usec, count, sizeof(int), cmpUsec);
+        printf("%-8s %8d %6d %8.1f %8d %8d %8d %8d\n",
+               ops[i].name, count, errors, (double)count / duration,
+               usec[count / 2], usec[count * 9 / 10],
+               usec[count * 99 / 100], usec[count - 1]);
+        total += count;
+    }
+
+    printf("total %d operations %.1f ops/s\n",
+           total, (double)total / duration);
+
+    free(usec);
+}
+
+/* rssOf()
+ */
+static long
+rssOf(pid_t pid)
+{
+    char buf[MAXLINELEN];
+    FILE *fp;
+    long rss;
+
+    sprintf(buf, "/proc/%d/status", (int)pid);
+    if ((fp = fopen(buf, "r")) == NULL)
+        return -1;
+
+    rss = -1;
+    while (fgets(buf, sizeof(buf), fp)) {
+        if (sscanf(buf, "VmRSS: %ld", &rss) == 1)
+            break;
+    }
+    fclose(fp);
+
+    return rss;
+}
+
+static int
+cmpUsec(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+static int
+opJobs(void)
+{
+    int more;
+
+    if (lsb_openjobinfo(0, NULL, "all", NULL, NULL, CUR_JOB) < 0) {
+        if (lsberrno == LSBE_NO_JOB)
+            return 0;
+        return -1;
+    }
+
+    while (lsb_readjobinfo(&more) && more)
+        ;
+    lsb_closejobinfo();
+
+    return 0;
+}
+
+static int
+opHosts(void)
+{
+    int num;
+
+    num = 0;
+    if (lsb_hostinfo(NULL, &num) == NULL)
+        return -1;
+
+    return 0;
+}
+
+static int
+opQueues(void)
+{
+    int num;
+
+    num = 0;
+    if (lsb_queueinfo(NULL, &num, NULL, NULL, 0) == NULL)
+        return -1;
+
+    return 0;
+}
+
+static int
+opSubmit(void)
+{
+    struct submit req;
+    struct submitReply reply;
+    int i;
+
+    memset(&req, 0, sizeof(struct submit));
+    for (i = 0; i < LSF_RLIM_NLIMITS; i++)
+        req.rLimits[i] = DEFAULT_RLIMIT;
+
+    if (queue) {
+        req.options |= SUB_QUEUE;
+        req.queue = queue;
+    }
+    req.options |= SUB_OUT_FILE;
+    req.outFile = "/dev/null";
+    req.numProcessors = 1;
+    req.maxNumProcessors = 1;
+    req.command = "true";
+
+    if (lsb_submit(&req, &reply) < 0)
+        return -1;
+
+    return 0;
+}
+
+static int
+opLoad(void)
+{
+    int num;
+
+    num = 0;
+    if (ls_load(NULL, &num, 0, NULL) == NULL)
+        return -1;
+
+    return 0;
+}
+
+static int
+opPlace(void)
+{
+    int num;
+
+    num = 1;
+    if (ls_placereq(NULL, &num, 0, NULL) == NULL)
+        return -1;
+
+    return 0;
+}
+
+/* genConfig()
+ * Print the lines of the emulated hosts for the
+ * hosts file and the Host section of lsf.cluster,
+ * their type and model are the ones of this host.
+ */
+static int
+genConfig(int num)
+{
+    char name[MAXHOSTNAMELEN];
+    struct in_addr addr;
+    char *model;
+    char *type;
+    int i;
+
+    if ((type = ls_gethosttype(NULL)) == NULL) {
+        ls_perror("ls_gethosttype()");
+        return -1;
+    }
+    type = strdup(type);
+
+    if ((model = ls_gethostmodel(NULL)) == NULL) {
+        ls_perror("ls_gethostmodel()");
+        free(type);
+        return -1;
+    }
+
+    printf("# hosts\n");
+    for (i = 0; i < num; i++) {
+        emuHostName(i, name);
+        addr.s_addr = emuAddr(i);
+        printf("%s %s\n", inet_ntoa(addr), name);
+    }
+
+    printf("# lsf.cluster\n# HOSTNAME model type server RESOURCES\n");
+    for (i = 0; i < num; i++) {
+        emuHostName(i, name);
+        printf("%s %s %s 1 ()\n", name, model, type);
+    }
+
+    free(type);
+    return 0;
+}
+
+/* emuInit()
+ * Find the master daemons and bind the LIM
+ * and sbatchd sockets of the emulated hosts.
+ */
+static int
+emuInit(int num)
+{
+    static struct config_param params[] = {
+        {"LSF_LIM_PORT", NULL},
+        {"LSB_MBD_PORT", NULL},
+        {"LSB_SBD_PORT", NULL},
+        {NULL, NULL}
+    };
+    struct emuHost *h;
+    struct lsInfo *info;
+    struct hostent *hp;
+    struct rlimit rl;
+    char *master;
+    int on;
+    int i;
+
+    if (ls_readconfenv(params, NULL) < 0) {
+        ls_perror("ls_readconfenv()");
+        return -1;
+    }
+
+    if ((info = ls_info()) == NULL) {
+        ls_perror("ls_info()");
+        return -1;
+    }
+    numIndx = info->numIndx;
+    numUsrIndx = info->numUsrIndx;
+    emuLoad = calloc(numIndx, sizeof(float));
+
+    if ((emuType = ls_gethosttype(NULL)) == NULL) {
+        ls_perror("ls_gethosttype()");
+        return -1;
+    }
+    emuType = strdup(emuType);
+
+    if ((master = ls_getmastername()) == NULL) {
+        ls_perror("ls_getmastername()");
+        return -1;
+    }
+
+    if ((hp = Gethostbyname_(master)) == NULL) {
+        fprintf(stderr, "Unknown master host %s\n", master);
+        return -1;
+    }
+
+    memset(&limAddr, 0, sizeof(struct sockaddr_in));
+    limAddr.sin_family = AF_INET;
+    memcpy(&limAddr.sin_addr, hp->h_addr_list[0], sizeof(in_addr_t));
+    mbdAddr = limAddr;
+
+    limAddr.sin_port = emuPort(params[0].paramValue, "lim", "udp");
+    mbdAddr.sin_port = emuPort(params[1].paramValue, "mbatchd", "tcp");
+    sbdPort = emuPort(params[2].paramValue, "sbatchd", "tcp");
+    if (limAddr.sin_port == 0
+        || mbdAddr.sin_port == 0
+        || sbdPort == 0) {
+        fprintf(stderr, "Unknown LIM, mbatchd or sbatchd port\n");
+        return -1;
+    }
+
+    /* Up to three sockets a host.
+     */
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    emuHosts = calloc(num, sizeof(struct emuHost));
+    for (i = 0; i < num; i++) {
+
+        h = &emuHosts[i];
+        emuHostName(i, h->name);
+        h->addr.sin_family = AF_INET;
+        h->addr.sin_addr.s_addr = emuAddr(i);
+        h->lim = h->sbd = h->mbd = -1;
+        h->seq = 1;
+        ++numEmuHosts;
+
+        h->lim = socket(AF_INET, SOCK_DGRAM, 0);
+        if (h->lim < 0
+            || bind(h->lim, (struct sockaddr *)&h->addr,
+                    sizeof(struct sockaddr_in)) < 0) {
+            fprintf(stderr, "LIM socket of %s %s: %s\n",
+                    h->name, inet_ntoa(h->addr.sin_addr), strerror(errno));
+            return -1;
+        }
+
+        h->addr.sin_port = sbdPort;
+        on = 1;
+        h->sbd = socket(AF_INET, SOCK_STREAM, 0);
+        if (h->sbd < 0
+            || setsockopt(h->sbd, SOL_SOCKET, SO_REUSEADDR,
+                          &on, sizeof(on)) < 0
+            || bind(h->sbd, (struct sockaddr *)&h->addr,
+                    sizeof(struct sockaddr_in)) < 0
+            || listen(h->sbd, SOMAXCONN) < 0) {
+            fprintf(stderr, "sbatchd socket of %s %s: %s\n",
+                    h->name, inet_ntoa(h->addr.sin_addr), strerror(errno));
+            return -1;
+        }
+        h->addr.sin_port = 0;
+    }
+
+    return 0;
+}
+
+/* emuClose()
+ */
+static void
+emuClose(void)
+{
+    int i;
+
+    for (i = 0; i < numEmuHosts; i++) {
+        if (emuHosts[i].lim >= 0)
+            close(emuHosts[i].lim);
+        if (emuHosts[i].sbd >= 0)
+            close(emuHosts[i].sbd);
+    }
+}
+
+/* emulate()
+ * Run the emulated hosts for the given time, then
+ * finish their jobs and write the status samples
+ * to fd.
+ */
+static void
+emulate(int fd, int duration)
+{
+    struct pollfd *pfd;
+    time_t nextLoad;
+    time_t end;
+    time_t t;
+    int round;
+    int num;
+    int n;
+    int i;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    for (emuOp = 0; strcmp(ops[emuOp].name, "status"); emuOp++)
+        ;
+
+    pfd = NULL;
+    nextLoad = 0;
+    round = 0;
+    end = time(NULL) + duration;
+
+    while ((t = time(NULL)) < end) {
+
+        if (t >= nextLoad) {
+            for (i = 0; i < numEmuHosts; i++) {
+                if (round % EMU_CONF_EVERY == 0)
+                    emuSendConf(&emuHosts[i]);
+                emuSendLoad(&emuHosts[i]);
+            }
+            ++round;
+            nextLoad = t + EMU_LOAD_INTVL;
+        }
+
+        emuReport(t);
+
+        pfd = realloc(pfd, (numEmuHosts + numEmuConns)
+                      * sizeof(struct pollfd));
+        for (n = 0; n < numEmuHosts; n++) {
+            pfd[n].fd = emuHosts[n].sbd;
+            pfd[n].events = POLLIN;
+        }
+        num = numEmuConns;
+        for (i = 0; i < num; i++, n++) {
+            pfd[n].fd = emuConns[i].fd;
+            pfd[n].events = POLLIN;
+        }
+
+        if (poll(pfd, n, 100) < 0)
+            continue;
+
+        for (i = 0; i < numEmuHosts; i++) {
+            if (pfd[i].revents)
+                emuAccept(&emuHosts[i]);
+        }
+
+        /* The acknowledgement or the close of mbatchd,
+         * either ends the channel.
+         */
+        for (i = 0, n = 0; i < numEmuConns; i++) {
+            if ((i < num && pfd[numEmuHosts + i].revents)
+                || t - emuConns[i].time > EMU_TIMEOUT) {
+                close(emuConns[i].fd);
+                continue;
+            }
+            emuConns[n] = emuConns[i];
+            ++n;
+        }
+        numEmuConns = n;
+    }
+
+    for (i = 0; i < numEmuConns; i++)
+        close(emuConns[i].fd);
+
+    emuReport(end + emuRunTime);
+
+    printf("Emulated %d hosts %d jobs started %d finished\n",
+           numEmuHosts, emuStarted, emuFinished);
+
+    if (writeSamples(fd, emuSamples, numEmuSamples) < 0)
+        _exit(-1);
+}
+
+/* emuHostName()
+ */
+static void
+emuHostName(int i, char *name)
+{
+    sprintf(name, "emu%04d", i + 1);
+}
+
+/* emuAddr()
+ */
+static in_addr_t
+emuAddr(int i)
+{
+    return htonl(ntohl(emuBase) + i);
+}
+
+/* emuPort()
+ * The port in network order from lsf.conf
+ * or from the services.
+ */
+static u_short
+emuPort(char *value, char *service, char *proto)
+{
+    struct servent *sv;
+
+    if (value)
+        return htons(atoi(value));
+
+    if ((sv = getservbyname(service, proto)) == NULL)
+        return 0;
+
+    return sv->s_port;
+}
+
+/* emuSendConf()
+ * Send the static information of a host as its LIM
+ * does, the master ignores the load until it has it.
+ */
+static void
+emuSendConf(struct emuHost *h)
+{
+    struct LSFHeader hdr;
+    char buf[MSGSIZE];
+    XDR xdrs;
+    u_short port;
+    short hostNo;
+    char *arch;
+    int maxCpus;
+    int maxMem;
+    int nDisks;
+    int maxSwap;
+    int maxTmp;
+
+    maxCpus = EMU_CPUS;
+    maxMem = EMU_MEM;
+    nDisks = 0;
+    maxSwap = EMU_SWAP;
+    maxTmp = EMU_TMP;
+    port = limAddr.sin_port;
+    hostNo = h - emuHosts;
+    arch = "";
+
+    xdrmem_create(&xdrs, buf, sizeof(buf), XDR_ENCODE);
+    initLSFHeader_(&hdr);
+    hdr.opCode = LIM_CONF_INFO;
+
+    if (xdr_LSFHeader(&xdrs, &hdr)
+        && xdr_int(&xdrs, &maxCpus)
+        && xdr_int(&xdrs, &maxMem)
+        && xdr_int(&xdrs, &nDisks)
+        && xdr_portno(&xdrs, &port)
+        && xdr_short(&xdrs, &hostNo)
+        && xdr_int(&xdrs, &maxSwap)
+        && xdr_int(&xdrs, &maxTmp)
+        && xdr_string(&xdrs, &emuType, MAXLSFNAMELEN)
+        && xdr_string(&xdrs, &arch, MAXLSFNAMELEN))
+        sendto(h->lim, buf, XDR_GETPOS(&xdrs), 0,
+               (struct sockaddr *)&limAddr, sizeof(struct sockaddr_in));
+
+    xdr_destroy(&xdrs);
+}
+
+/* emuSendLoad()
+ * Send the load vector of a host as its LIM does,
+ * the run queue follows the jobs running on it.
+ */
+static void
+emuSendLoad(struct emuHost *h)
+{
+    struct LSFHeader hdr;
+    char buf[MSGSIZE];
+    XDR xdrs;
+    int loadType;
+    int hostNo;
+    int numResPairs;
+    int checkSum;
+    int flags;
+    int status;
+    u_int a;
+    int cc;
+    int i;
+
+    memset(emuLoad, 0, numIndx * sizeof(float));
+    emuLoad[R15S] = emuLoad[R1M] = emuLoad[R15M] = h->numJobs;
+    emuLoad[UT] = h->numJobs < EMU_CPUS ? (float)h->numJobs / EMU_CPUS : 1.0;
+    emuLoad[IT] = 60.0;
+    emuLoad[TMP] = EMU_TMP;
+    emuLoad[SWP] = EMU_SWAP;
+    emuLoad[MEM] = EMU_MEM / 2;
+
+    /* e_vec of the LIM
+     */
+    loadType = 0;
+    hostNo = h - emuHosts;
+    numResPairs = 0;
+    checkSum = 0;
+    flags = 0;
+    status = 0;
+
+    xdrmem_create(&xdrs, buf, sizeof(buf), XDR_ENCODE);
+    initLSFHeader_(&hdr);
+    hdr.opCode = LIM_LOAD_UPD;
+
+    cc = xdr_LSFHeader(&xdrs, &hdr)
+        && xdr_enum(&xdrs, &loadType)
+        && xdr_int(&xdrs, &hostNo)
+        && xdr_u_int(&xdrs, &h->loadSeq)
+        && xdr_int(&xdrs, &numResPairs)
+        && xdr_int(&xdrs, &checkSum)
+        && xdr_int(&xdrs, &flags)
+        && xdr_int(&xdrs, &numIndx)
+        && xdr_int(&xdrs, &numUsrIndx);
+
+    for (i = 0; cc && i < 1 + GET_INTNUM(numIndx); i++)
+        cc = xdr_int(&xdrs, &status);
+
+    /* The built in indices go two in a word.
+     */
+    for (i = 0; cc && i < NBUILTINDEX; i += 2) {
+        a = emuFloat16(emuLoad[i]) << 16;
+        if (i + 1 < NBUILTINDEX)
+            a |= emuFloat16(emuLoad[i + 1]);
+        cc = xdr_u_int(&xdrs, &a);
+    }
+
+    for (i = NBUILTINDEX; cc && i < numIndx; i++)
+        cc = xdr_float(&xdrs, &emuLoad[i]);
+
+    if (cc)
+        sendto(h->lim, buf, XDR_GETPOS(&xdrs), 0,
+               (struct sockaddr *)&limAddr, sizeof(struct sockaddr_in));
+
+    xdr_destroy(&xdrs);
+    ++h->loadSeq;
+}
+
+/* emuFloat16()
+ * A load index in 16 bits as encfloat16_() of
+ * the LIM encodes it.
+ */
+static u_short
+emuFloat16(float f)
+{
+    double fmant;
+    double temp;
+    int expo;
+
+    temp = f;
+    if (temp <= 2.328306E-10)
+        temp = 2.328306E-10;
+    if (temp >= INFINIT_LOAD)
+        return 0x7fff;
+
+    fmant = frexp(temp, &expo);
+    if (expo < 0)
+        expo = 0x20 | (expo & 0x1F);
+    else
+        expo = expo & 0x1F;
+
+    return (expo << 10) + (int)((fmant - 0.5) * 2048);
+}
+
+/* emuAccept()
+ * Serve a request of mbatchd to an emulated sbatchd.
+ */
+static void
+emuAccept(struct emuHost *h)
+{
+    struct LSFHeader hdr;
+    struct timeval tv;
+    char *body;
+    XDR xdrs;
+    int keep;
+    int s;
+
+    if ((s = accept(h->sbd, NULL, NULL)) < 0)
+        return;
+
+    tv.tv_sec = EMU_TIMEOUT;
+    tv.tv_usec = 0;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    if (emuRead(s, &hdr, &body) < 0) {
+        close(s);
+        return;
+    }
+
+    xdrmem_create(&xdrs, body, hdr.length, XDR_DECODE);
+    keep = FALSE;
+
+    switch (hdr.opCode) {
+        case MBD_NEW_JOB:
+            keep = emuNewJob(h, s, &xdrs, &hdr) == 0;
+            break;
+        case MBD_SIG_JOB:
+            emuSigJob(s, &xdrs, &hdr);
+            break;
+        case MBD_SWIT_JOB:
+        case MBD_MODIFY_JOB:
+            emuModJob(s, &xdrs, &hdr);
+            break;
+        default:
+            emuReply(s, ERR_NO_ERROR, NULL);
+            break;
+    }
+
+    xdr_destroy(&xdrs);
+    free(body);
+
+    if (keep)
+        emuKeep(s);
+    else
+        close(s);
+}
+
+/* emuRead()
+ * Read a message, the header then the body.
+ */
+static int
+emuRead(int s, struct LSFHeader *hdr, char **body)
+{
+    char buf[LSF_HEADER_LEN];
+    XDR xdrs;
+    int cc;
+
+    if (b_read_fix(s, buf, LSF_HEADER_LEN) != LSF_HEADER_LEN)
+        return -1;
+
+    xdrmem_create(&xdrs, buf, LSF_HEADER_LEN, XDR_DECODE);
+    cc = xdr_LSFHeader(&xdrs, hdr);
+    xdr_destroy(&xdrs);
+
+    if (! cc
+        || hdr->length < 0
+        || (*body = malloc(hdr->length + 1)) == NULL)
+        return -1;
+
+    if (b_read_fix(s, *body, hdr->length) != hdr->length) {
+        free(*body);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* emuReply()
+ */
+static int
+emuReply(int s, int reply, struct jobReply *jobReply)
+{
+    struct LSFHeader hdr;
+    char buf[MSGSIZE];
+    XDR xdrs;
+    int cc;
+
+    xdrmem_create(&xdrs, buf, sizeof(buf), XDR_ENCODE);
+    initLSFHeader_(&hdr);
+    hdr.opCode = reply;
+
+    cc = -1;
+    if (xdr_encodeMsg(&xdrs, (char *)jobReply, &hdr, xdr_jobReply, 0, NULL)
+        && b_write_fix(s, buf, XDR_GETPOS(&xdrs)) == XDR_GETPOS(&xdrs))
+        cc = 0;
+
+    xdr_destroy(&xdrs);
+    return cc;
+}
+
+/* emuReplyJob()
+ */
+static int
+emuReplyJob(int s, struct emuJob *job)
+{
+    struct jobReply jobReply;
+
+    if (job == NULL)
+        return emuReply(s, ERR_NO_JOB, NULL);
+
+    memset(&jobReply, 0, sizeof(struct jobReply));
+    jobReply.jobId = job->jobId;
+    jobReply.jobPid = job->pid;
+    jobReply.jobPGid = job->pid;
+    jobReply.jStatus = JOB_STAT_RUN;
+
+    return emuReply(s, ERR_NO_ERROR, &jobReply);
+}
+
+/* emuNewJob()
+ * Start a job, the job file follows the specs and
+ * the job runs until its time is up.
+ */
+static int
+emuNewJob(struct emuHost *h, int s, XDR *xdrs, struct LSFHeader *hdr)
+{
+    struct jobSpecs specs;
+    struct emuJob *job;
+    char *jf;
+    int len;
+
+    if (! xdr_jobSpecs(xdrs, &specs, hdr)) {
+        emuReply(s, ERR_BAD_REQ, NULL);
+        return -1;
+    }
+
+    /* A negative length is the key of a cached
+     * job file, emulated hosts announce no cache
+     * but take it anyway.
+     */
+    jf = NULL;
+    if (b_read_fix(s, (char *)&len, NET_INTSIZE_) != NET_INTSIZE_)
+        goto fail;
+
+    len = ntohl(len);
+    if (len < 0)
+        len = -len;
+    if (len < 0
+        || (jf = malloc(len + 1)) == NULL
+        || b_read_fix(s, jf, len) != len)
+        goto fail;
+    free(jf);
+
+    if ((job = emuFind(specs.jobId)) == NULL) {
+
+        job = calloc(1, sizeof(struct emuJob));
+        job->jobId = specs.jobId;
+        job->host = h;
+        job->pid = ++emuPid;
+        job->userId = specs.userId;
+        job->userName = strdup(specs.userName);
+        job->cwd = strdup(specs.cwd);
+        job->newStatus = JOB_STAT_DONE;
+        job->done = time(NULL) + emuRunTime;
+        job->next = emuJobs;
+        emuJobs = job;
+        ++h->numJobs;
+        ++emuStarted;
+    }
+
+    xdr_lsffree(xdr_jobSpecs, (char *)&specs, hdr);
+
+    return emuReplyJob(s, job);
+
+fail:
+    free(jf);
+    xdr_lsffree(xdr_jobSpecs, (char *)&specs, hdr);
+    emuReply(s, ERR_NO_FILE, NULL);
+    return -1;
+}
+
+/* emuSigJob()
+ * Any signal ends the job, the commands send
+ * them mostly to kill.
+ */
+static void
+emuSigJob(int s, XDR *xdrs, struct LSFHeader *hdr)
+{
+    struct jobSig jobSig;
+    struct emuJob *job;
+
+    if (! xdr_jobSig(xdrs, &jobSig, hdr)) {
+        emuReply(s, ERR_BAD_REQ, NULL);
+        return;
+    }
+
+    if ((job = emuFind(jobSig.jobId)) != NULL) {
+        job->newStatus = JOB_STAT_EXIT;
+        job->done = 0;
+    }
+
+    emuReplyJob(s, job);
+}
+
+/* emuModJob()
+ * Switch or modify a job, its run does not change.
+ */
+static void
+emuModJob(int s, XDR *xdrs, struct LSFHeader *hdr)
+{
+    struct jobSpecs specs;
+
+    if (! xdr_jobSpecs(xdrs, &specs, hdr)) {
+        emuReply(s, ERR_BAD_REQ, NULL);
+        return;
+    }
+
+    emuReplyJob(s, emuFind(specs.jobId));
+    xdr_lsffree(xdr_jobSpecs, (char *)&specs, hdr);
+}
+
+/* emuFind()
+ */
+static struct emuJob *
+emuFind(LS_LONG_INT jobId)
+{
+    struct emuJob *job;
+
+    for (job = emuJobs; job; job = job->next) {
+        if (job->jobId == jobId)
+            return job;
+    }
+
+    return NULL;
+}
+
+/* emuKeep()
+ */
+static void
+emuKeep(int s)
+{
+    if (numEmuConns == maxEmuConns) {
+        maxEmuConns = 2 * maxEmuConns + 64;
+        emuConns = realloc(emuConns, maxEmuConns * sizeof(struct emuConn));
+        if (emuConns == NULL)
+            _exit(-1);
+    }
+
+    emuConns[numEmuConns].fd = s;
+    emuConns[numEmuConns].time = time(NULL);
+    ++numEmuConns;
+}
+
+/* emuReport()
+ * Report the jobs running once, then done or
+ * exited when their time is up. A job mbatchd
+ * does not know any more is forgotten.
+ */
+static void
+emuReport(time_t t)
+{
+    struct emuJob **p;
+    struct emuJob *job;
+    int gone;
+    int cc;
+
+    p = &emuJobs;
+    while ((job = *p)) {
+
+        gone = FALSE;
+        if (! job->reported) {
+            cc = emuStatus(job, JOB_STAT_RUN);
+            job->reported = cc >= 0;
+            gone = cc == LSBE_NO_JOB;
+        }
+
+        if (! gone
+            && job->reported
+            && job->done <= t
+            && emuStatus(job, job->newStatus) >= 0) {
+            ++emuFinished;
+            gone = TRUE;
+        }
+
+        if (gone) {
+            *p = job->next;
+            emuFree(job);
+            continue;
+        }
+        p = &job->next;
+    }
+}
+
+/* emuStatus()
+ * Report the status of a job to mbatchd from the
+ * address of its host as sbatchd does, on a channel
+ * kept open and opened again once if mbatchd closed
+ * it. Return the reply of mbatchd.
+ */
+static int
+emuStatus(struct emuJob *job, int newStatus)
+{
+    struct emuHost *h;
+    struct statusReq req;
+    struct LSFHeader hdr;
+    struct timeval t0;
+    struct timeval t1;
+    char buf[MSGSIZE];
+    char *body;
+    XDR xdrs;
+    int retry;
+    int cc;
+
+    h = job->host;
+    memset(&req, 0, sizeof(struct statusReq));
+    req.jobId = job->jobId;
+    req.jobPid = job->pid;
+    req.jobPGid = job->pid;
+    req.newStatus = newStatus;
+    req.seq = h->seq;
+    req.sbdReply = ERR_NO_ERROR;
+    req.execUid = job->userId;
+    req.exitStatus = newStatus == JOB_STAT_EXIT ? SIGKILL : 0;
+    req.execHome = "";
+    req.execCwd = job->cwd;
+    req.execUsername = job->userName;
+    req.queuePreCmd = "";
+    req.queuePostCmd = "";
+    req.actStatus = ACT_NO;
+
+    if (++h->seq >= MAX_SEQ_NUM)
+        h->seq = 1;
+
+    xdrmem_create(&xdrs, buf, sizeof(buf), XDR_ENCODE);
+    initLSFHeader_(&hdr);
+    hdr.opCode = BATCH_STATUS_JOB;
+
+    if (! xdr_encodeMsg(&xdrs, (char *)&req, &hdr, xdr_statusReq, 0, NULL)) {
+        xdr_destroy(&xdrs);
+        return -1;
+    }
+
+    gettimeofday(&t0, NULL);
+
+    cc = -1;
+    for (retry = h->mbd >= 0; cc < 0 && retry >= 0; retry--) {
+
+        if (h->mbd < 0
+            && (h->mbd = emuConnect(h)) < 0)
+            break;
+
+        if (b_write_fix(h->mbd, buf, XDR_GETPOS(&xdrs)) == XDR_GETPOS(&xdrs)
+            && emuRead(h->mbd, &hdr, &body) == 0) {
+            free(body);
+            cc = hdr.opCode;
+            break;
+        }
+
+        close(h->mbd);
+        h->mbd = -1;
+    }
+
+    gettimeofday(&t1, NULL);
+    addSample(&emuSamples, &numEmuSamples, &maxEmuSamples, emuOp,
+              cc == LSBE_NO_ERROR || cc == LSBE_NO_JOB,
+              (t1.tv_sec - t0.tv_sec) * 1000000
+              + (t1.tv_usec - t0.tv_usec));
+
+    xdr_destroy(&xdrs);
+    return cc;
+}
+
+/* emuConnect()
+ */
+static int
+emuConnect(struct emuHost *h)
+{
+    struct timeval tv;
+    int s;
+
+    if ((s = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return -1;
+
+    tv.tv_sec = EMU_TIMEOUT;
+    tv.tv_usec = 0;
+
+    if (bind(s, (struct sockaddr *)&h->addr,
+             sizeof(struct sockaddr_in)) < 0
+        || connect(s, (struct sockaddr *)&mbdAddr,
+                   sizeof(struct sockaddr_in)) < 0
+        || setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+        close(s);
+        return -1;
+    }
+
+    return s;
+}
+
+/* my_calloc()
+ * The allocator of the daemons xdr_jobSpecs()
+ * uses to decode the specs.
+ */
+void *
+my_calloc(int nelem, int esize, const char *caller)
+{
+    return calloc(nelem, esize);
+}
+
+/* emuFree()
+ */
+static void
+emuFree(struct emuJob *job)
+{
+    --job->host->numJobs;
+    free(job->userName);
+    free(job->cwd);
+    free(job);
+}